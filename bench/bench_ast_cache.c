@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cache.h"
+#include "common.h"
+#include "parser.h"
+
+#define LINES 200000
+#define ROUNDS 5
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char *generate_source() {
+    size_t capacity = LINES * 64;
+    char *source = malloc(capacity);
+    size_t length = 0;
+    for (size_t i = 0; i < LINES; i++) {
+        switch (i % 3) {
+        case 0: length += snprintf(source + length, capacity - length, "\"string number %ld\"\n", i); break;
+        case 1: length += snprintf(source + length, capacity - length, "some_name_%ld\n", i); break;
+        case 2: length += snprintf(source + length, capacity - length, "SomeType%ld\n", i); break;
+        }
+    }
+
+    return source;
+}
+
+static size_t count_cached_nodes(mt_AstCache *cache, mt_CachedNode *node) {
+    size_t count = 1;
+    if (node->type == mt_NODE_MODULE) {
+        for (uint32_t i = 0; i < node->length; i++) {
+            mt_CachedNode *child = mt_cached_node_child(cache, node, i);
+            if (!child) return 0;
+
+            count += count_cached_nodes(cache, child);
+        }
+    }
+
+    return count;
+}
+
+int main(void) {
+    char *path = "bench/build/bench_ast_cache.mtc";
+    char *source = generate_source();
+    size_t length = strlen(source);
+
+    double cold = 0, warm = 0;
+    uint64_t cache_size = 0, positions_size = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double start = now();
+        uint64_t hash = mt_hash_source(source, length);
+        mt_Parser *parser = mt_parser_init("bench", source);
+        mt_Node *tree = mt_parser_parse(parser);
+        if (!tree || !mt_ast_cache_write(path, hash, tree)) {
+            fprintf(stderr, "error: failed to parse and cache source\n");
+            return 1;
+        }
+        mt_parser_free(parser);
+        cold += now() - start;
+
+        start = now();
+        hash = mt_hash_source(source, length);
+        mt_AstCache *cache = mt_ast_cache_open(path, hash);
+        if (!cache || count_cached_nodes(cache, mt_ast_cache_root(cache)) != LINES + 1) {
+            fprintf(stderr, "error: failed to load cache\n");
+            return 1;
+        }
+        cache_size = cache->header->size;
+        positions_size = cache->header->positions;
+        mt_ast_cache_close(cache);
+        warm += now() - start;
+    }
+
+    printf("source size:          %ld bytes, %d lines\n", length, LINES);
+    printf("cold (parse + write): %.3fms\n", cold / ROUNDS * 1000);
+    printf("warm (map + walk):    %.3fms\n", warm / ROUNDS * 1000);
+    printf("speedup:              %.1fx\n", cold / warm);
+    printf("cache size:           %llu bytes, %.1f bytes/node\n", (unsigned long long)cache_size, (double)cache_size / (LINES + 1));
+    printf("positions:            %llu bytes, %.1f bytes/node\n", (unsigned long long)positions_size, (double)positions_size / (LINES + 1));
+
+    remove(path);
+    free(source);
+    return 0;
+}
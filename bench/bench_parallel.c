@@ -0,0 +1,97 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "parallel.h"
+
+#define ROWS 4096
+#define COLUMNS 2048
+#define ROUNDS 5
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/// A per-row transform: normalize every row in place and sum the
+/// norms, using worker scratch memory for the intermediate squares.
+static void normalize_rows(mt_Worker *worker, int64_t start, int64_t end, void *result, void *data) {
+    double *matrix = data;
+    for (int64_t row = start; row < end; row++) {
+        double *values = matrix + row * COLUMNS;
+        double *squares = mt_worker_alloc(worker, sizeof(double) * COLUMNS);
+        double norm = 0;
+        for (int column = 0; column < COLUMNS; column++) {
+            squares[column] = values[column] * values[column];
+            norm += squares[column];
+        }
+
+        norm = sqrt(norm);
+        for (int column = 0; column < COLUMNS; column++) {
+            values[column] = values[column] / norm + sin(squares[column]);
+        }
+
+        *(double *)result += norm;
+        worker->arena_used = 0;
+    }
+}
+
+static void add_doubles(void *into, const void *from, void *data) {
+    (void)data;
+    *(double *)into += *(const double *)from;
+}
+
+int main(void) {
+    double *matrix = malloc(sizeof(double) * ROWS * COLUMNS);
+    if (!matrix) return 1;
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_workers = cpus > 0 ? (uint32_t)cpus : 1;
+    if (max_workers > mt_WORK_POOL_MAX_WORKERS) max_workers = mt_WORK_POOL_MAX_WORKERS;
+
+    double zero = 0, serial = 0, expected = 0;
+    mt_ParallelLoop loop = {
+        .start = 0,
+        .end = ROWS,
+        .grain = 16,
+        .result_size = sizeof(double),
+        .identity = &zero,
+        .body = normalize_rows,
+        .reduce = add_doubles,
+        .data = matrix,
+    };
+
+    printf("%d x %d rows, %u online CPUs\n", ROWS, COLUMNS, max_workers);
+    for (uint32_t workers = 1; workers <= max_workers; workers = workers * 2 > max_workers && workers != max_workers ? max_workers : workers * 2) {
+        mt_WorkPool *pool = mt_work_pool_init(workers);
+        if (!pool) return 1;
+
+        double best = 0, sum = 0;
+        for (int round = 0; round < ROUNDS; round++) {
+            for (size_t i = 0; i < (size_t)ROWS * COLUMNS; i++) matrix[i] = (double)(i % 97) + 1;
+
+            double start = now();
+            if (!mt_parallel_for(pool, &loop, &sum)) return 1;
+            double elapsed = now() - start;
+            if (round == 0 || elapsed < best) best = elapsed;
+        }
+
+        if (workers == 1) {
+            serial = best;
+            expected = sum;
+        } else if (sum != expected) {
+            fprintf(stderr, "error: results differ between 1 and %u workers\n", workers);
+            return 1;
+        }
+
+        printf("%3u workers: %8.3fms  speedup %5.2fx  efficiency %5.1f%%\n", workers, best * 1000, serial / best, serial / best / workers * 100);
+        mt_work_pool_free(pool);
+        if (workers == max_workers) break;
+    }
+
+    free(matrix);
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common.h"
+#include "scanner.h"
+
+#define COPIES 5000
+#define ROUNDS 5
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double run(char *source, void (*scan)(mt_Scanner *, mt_Token *), size_t *ntokens) {
+    double best = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double start = now();
+        mt_Scanner *scanner = mt_scanner_init(source);
+        mt_Token token;
+        *ntokens = 0;
+        do {
+            scan(scanner, &token);
+            *ntokens += 1;
+        } while (token.type != mt_TOKEN_EOF);
+        mt_scanner_free(scanner);
+
+        double elapsed = now() - start;
+        if (round == 0 || elapsed < best) best = elapsed;
+    }
+
+    return best;
+}
+
+int main(void) {
+    char *example = mt_read_entire_file("examples/iteration.mt");
+    if (!example) {
+        fprintf(stderr, "error: could not read examples/iteration.mt\n");
+        return 1;
+    }
+
+    size_t example_length = strlen(example);
+    char *source = malloc(example_length * COPIES + 2);
+    for (size_t i = 0; i < COPIES; i++) {
+        memcpy(source + i * example_length, example, example_length);
+        source[(i + 1) * example_length - 1] = '\n';
+    }
+    source[example_length * COPIES] = '\0';
+
+    size_t reference_tokens, table_tokens;
+    double reference = run(source, mt_scanner_scan_reference, &reference_tokens);
+    double table = run(source, mt_scanner_scan, &table_tokens);
+    if (reference_tokens != table_tokens) {
+        fprintf(stderr, "error: scanners disagree on the number of tokens\n");
+        return 1;
+    }
+
+    double mb = example_length * COPIES / 1e6;
+    printf("source size:           %.1fMB, %ld tokens\n", mb, table_tokens);
+    printf("hand-written scanner:  %.3fms (%.1fMB/s)\n", reference * 1000, mb / reference);
+    printf("table-driven scanner:  %.3fms (%.1fMB/s)\n", table * 1000, mb / table);
+    printf("speedup:               %.2fx\n", reference / table);
+
+    free(source);
+    free(example);
+    return 0;
+}
@@ -0,0 +1,12 @@
+// Generated by tools/gen_builtin_table.c -- do not edit.
+
+#define BUILTIN_TABLE_CAPACITY 4
+
+static const mt_String BUILTIN_STRINGS[mt_BUILTIN_COUNT] = {
+    {.length = 5, .hash = 372738696u, .owned = false, .as.small = "print"},
+};
+
+// Open-addressing table of mt_BuiltinId + 1, keyed by hash.
+static const uint16_t BUILTIN_TABLE[BUILTIN_TABLE_CAPACITY] = {
+    1, 0, 0, 0,
+};
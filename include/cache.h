@@ -0,0 +1,168 @@
+#ifndef mt_cache_h
+#define mt_cache_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "dump.h"
+#include "parser.h"
+#include "writer.h"
+
+#define mt_AST_CACHE_MAGIC "MTASTC\r\n"
+/// Bumped whenever the layout of a cache or the meaning of what's in
+/// it changes, including what the scanner and parser put in nodes,
+/// since mt_VERSION doesn't change between releases.  Format 5 is
+/// the first one whose STRING nodes are guaranteed to hold decoded
+/// escapes, so older caches are never served with raw ones.
+#define mt_AST_CACHE_FORMAT 5
+
+/// The number of nodes between two entries of the position index.
+#define mt_AST_CACHE_POSITION_INTERVAL 64
+
+/// Flags describing how a cache file was generated.
+typedef enum {
+    mt_AST_CACHE_INTERNED = 1 << 0,  ///< identical strings share a single string table entry
+} mt_AstCacheFlags;
+
+/// Every AST cache file starts with this header.  All offsets in a
+/// cache file are relative to the start of the file so caches can be
+/// mapped anywhere.
+///
+/// The header is followed by the section table, the node array, the
+/// child table, the position index, the string table and the
+/// position table, in that order.
+typedef struct {
+    char magic[8];  ///< always mt_AST_CACHE_MAGIC
+    uint32_t format;  ///< always mt_AST_CACHE_FORMAT
+    uint32_t flags;  ///< a combination of mt_AstCacheFlags
+    char version[16];  ///< the mt_VERSION of the compiler that wrote the file
+    uint64_t source_hash;  ///< the mt_hash_source of the source the file was generated from
+    uint64_t size;  ///< the total size of the file in bytes
+    uint32_t sections;  ///< the number of sections, one per top-level node
+    uint32_t nodes;  ///< the number of nodes, the first of which is the root
+    uint32_t children;  ///< the number of entries in the child table
+    uint32_t strings;  ///< the size of the string table in bytes
+    uint32_t positions;  ///< the size of the position table in bytes
+    uint32_t position_interval;  ///< always mt_AST_CACHE_POSITION_INTERVAL
+    uint64_t strings_checksum;  ///< the checksum of the string table
+    uint64_t positions_checksum;  ///< the checksum of the position index and the position table
+    uint64_t checksum;  ///< the checksum of everything above as well as the section table and the root node
+} mt_AstCacheHeader;
+
+/// Every top-level node and its descendants are stored contiguously
+/// in a section, which is validated the first time it's accessed
+/// rather than when the cache is opened.
+typedef struct {
+    uint32_t first_node;
+    uint32_t node_count;
+    uint32_t first_child;
+    uint32_t child_count;
+    uint64_t checksum;  ///< the checksum of the section's nodes and child table entries
+} mt_AstCacheSection;
+
+/// Nodes are stored in a flat array.  Child lists are runs of node
+/// indices in the child table and string values are NUL-terminated
+/// runs of bytes in the string table.  The 64 bits of INTEGER and
+/// FLOAT values are split between offset (low) and length (high).
+///
+/// Source positions are only needed to report errors, so they aren't
+/// stored on nodes.  Instead, the position table holds one entry per
+/// node, in node order, delta-encoded against the previous entry:
+///
+///   varint zigzag(line - previous line)
+///   varint zigzag(column - previous column)  if the line is the same
+///   varint column                            otherwise
+///
+/// The deltas restart from line 0, column 0 every
+/// mt_AST_CACHE_POSITION_INTERVAL nodes and the position index holds
+/// the offset in the position table of each of those restarts, so any
+/// node's position can be decoded without decoding the whole table.
+typedef struct {
+    uint32_t type;  ///< an mt_NodeType
+    uint32_t offset;  ///< the offset of the node's value in the child or string table
+    uint32_t length;  ///< the number of children or the length of the string
+} mt_CachedNode;
+
+typedef enum {
+    mt_AST_CACHE_UNCHECKED,
+    mt_AST_CACHE_VALID,
+    mt_AST_CACHE_CORRUPT,
+} mt_AstCacheState;
+
+/// AstCaches are read-only views on top of memory-mapped cache files.
+typedef struct {
+    void *data;
+    size_t size;
+
+    mt_AstCacheHeader *header;
+    mt_AstCacheSection *sections;
+    mt_CachedNode *nodes;
+    uint32_t *children;
+    uint32_t *position_index;
+    char *strings;
+    uint8_t *positions;
+
+    uint8_t *section_states;  ///< the mt_AstCacheState of every section
+    uint8_t strings_state;  ///< the mt_AstCacheState of the string table
+    uint8_t positions_state;  ///< the mt_AstCacheState of the position index and table
+} mt_AstCache;
+
+/// Hash a source buffer.
+uint64_t mt_hash_source(char *, size_t);
+
+/// Get the path of the cache file for a source file.  If the
+/// MONTY_CACHE_DIR environment variable is set, caches are stored in
+/// that directory, keyed by the source hash.  Otherwise they are
+/// stored right next to the source file.  The caller is expected to
+/// free the path.  Returns NULL if there isn't enough free memory.
+char *mt_ast_cache_path(char *filename, uint64_t source_hash);
+
+/// Map a cache file into memory.  Returns NULL if the file doesn't
+/// exist, if its header is corrupt or if it was generated by a
+/// different version of the compiler or from a different source.
+///
+/// Only the header and the root node are validated up front.
+/// Sections, the string table and the position table are validated
+/// on first access.
+mt_AstCache *mt_ast_cache_open(char *path, uint64_t source_hash);
+
+/// Validate every section of a cache as well as its string and
+/// position tables.
+/// Returns false if any part of the cache is corrupt.
+bool mt_ast_cache_validate(mt_AstCache *);
+
+/// Serialize a tree to a cache file.  The file is written atomically.
+/// Returns false on error.
+bool mt_ast_cache_write(char *path, uint64_t source_hash, mt_Node *);
+
+/// Get the root node of a cache.
+mt_CachedNode *mt_ast_cache_root(mt_AstCache *);
+
+/// Get the i-th child of a cached MODULE node.  Returns NULL if the
+/// section the child belongs to is corrupt.
+mt_CachedNode *mt_cached_node_child(mt_AstCache *, mt_CachedNode *, uint32_t);
+
+/// Get the value of a cached STRING, TYPE or NAME node.  Returns NULL
+/// if the string table is corrupt.
+char *mt_cached_node_string(mt_AstCache *, mt_CachedNode *);
+
+/// Get the value of a cached INTEGER or FLOAT node.
+mt_NodeValue mt_cached_node_number(mt_CachedNode *);
+
+/// Decode the source position of a cached node.  This walks at most
+/// mt_AST_CACHE_POSITION_INTERVAL entries of the position table.
+/// Returns false if the position table is corrupt.
+bool mt_cached_node_position(mt_AstCache *, mt_CachedNode *, uint32_t *line, uint32_t *column);
+
+/// Dump a cache without recursing.  The output is the same as that of
+/// "mt_dump_tree" on the tree the cache was generated from.  The cache
+/// must have been validated using "mt_ast_cache_validate".  Returns
+/// false if there isn't enough free memory to walk it or if its
+/// position table is corrupt.
+bool mt_ast_cache_dump(mt_AstCache *, mt_Writer *, mt_DumpFormat);
+
+/// Unmap and free a cache.
+void mt_ast_cache_close(mt_AstCache *);
+
+#endif
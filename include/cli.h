@@ -0,0 +1,21 @@
+#ifndef mt_cli_h
+#define mt_cli_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "str.h"
+
+/// Set the arguments exposed to programs as "std.cli.args".  They
+/// are borrowed, not copied, so they must outlive every use of them,
+/// which argv always does.
+void mt_cli_set_args(char **args, uint32_t count);
+
+/// Get the number of arguments exposed to programs.
+uint32_t mt_cli_arg_count(void);
+
+/// Initialize a String view of an argument.  Returns false if index
+/// is out of bounds.
+bool mt_cli_arg(uint32_t index, mt_String *);
+
+#endif
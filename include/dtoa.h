@@ -0,0 +1,21 @@
+#ifndef mt_dtoa_h
+#define mt_dtoa_h
+
+#include <stddef.h>
+
+/// The most bytes "mt_dtoa" ever writes.
+#define mt_DTOA_BUFFER_SIZE 32
+
+/// Write the shortest decimal representation of a double that reads
+/// back as the same value, without going through printf.  The digits
+/// come from Grisu2, which always round-trips but very occasionally
+/// (a few in ten thousand random doubles) writes one digit more than
+/// necessary.  NaNs are written as "nan" and infinities as "inf" or
+/// "-inf".  Values
+/// whose decimal exponent is in [-5, 17) are written positionally and
+/// everything else in scientific notation, like "1.5e+300".  Integral
+/// values get a trailing ".0" so they still read as floats.  Returns
+/// the number of bytes written, which aren't NUL-terminated.
+size_t mt_dtoa(double, char *buffer);
+
+#endif
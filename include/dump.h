@@ -0,0 +1,75 @@
+#ifndef mt_dump_h
+#define mt_dump_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "parser.h"
+#include "scanner.h"
+#include "writer.h"
+
+/// The formats tokens and ASTs can be dumped in.
+///
+/// text: one human-readable line per token or an indented tree.
+///
+/// jsonl: one JSON object per line.  Tokens look like
+///   {"type":"NAME","value":"x","line":1,"column":1}
+/// and nodes, which are dumped in pre-order, look like
+///   {"id":1,"parent":0,"type":"NAME","value":"x","line":1,"column":1}
+/// The root node's parent is null and MODULE nodes have no value.
+/// The values of INTEGER and FLOAT nodes are JSON numbers.
+///
+/// binary: fixed-size little-endian records, each followed by a
+/// variable-length payload.  Tokens are dumped as
+///   u8 type, u32 line, u32 column, u32 length, u8 value[length]
+/// using mt_TokenType values, and nodes, in pre-order, as
+///   u8 type, u32 line, u32 column, u32 count, u8 value[]
+/// using mt_NodeType values, where count is the number of children
+/// of MODULE nodes, which have no value, and the length of the value
+/// of every other node.  The values of INTEGER and FLOAT nodes are
+/// 8 byte little-endian two's complement integers and IEEE doubles,
+/// respectively.
+typedef enum {
+    mt_DUMP_TEXT,
+    mt_DUMP_JSONL,
+    mt_DUMP_BINARY,
+} mt_DumpFormat;
+
+/// Parse the name of a DumpFormat.  Returns false if the name isn't
+/// recognized.
+bool mt_dump_format_parse(char *, mt_DumpFormat *);
+
+/// Dump a Token.
+void mt_dump_token(mt_Writer *, mt_DumpFormat, mt_Token *);
+
+#define mt_DUMP_NO_PARENT UINT32_MAX
+
+/// Trees are dumped by walking them in pre-order and calling
+/// "mt_dump_node_enter" for every node and "mt_dump_node_leave" once
+/// all of a node's children have been dumped.
+typedef struct {
+    mt_NodeType type;
+    uint32_t line;
+    uint32_t column;
+
+    const char *value;  ///< the node's value, or NULL for MODULE, INTEGER and FLOAT nodes
+    size_t length;  ///< the length of the value
+    mt_NodeValue number;  ///< the value of INTEGER and FLOAT nodes
+    uint32_t children;  ///< the number of children of MODULE nodes
+
+    uint32_t id;  ///< the index of the node in pre-order
+    uint32_t parent;  ///< the id of the parent node or mt_DUMP_NO_PARENT
+    uint32_t depth;
+} mt_DumpNode;
+
+/// Dump a node before any of its children.
+void mt_dump_node_enter(mt_Writer *, mt_DumpFormat, mt_DumpNode *);
+
+/// Dump a node after all of its children.
+void mt_dump_node_leave(mt_Writer *, mt_DumpFormat, mt_DumpNode *);
+
+/// Dump a tree without recursing.  Returns false if there isn't
+/// enough free memory to walk it.
+bool mt_dump_tree(mt_Writer *, mt_DumpFormat, mt_Node *);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef mt_heap_h
+#define mt_heap_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/// HeapCounters keep track of the memory allocated at one allocation
+/// site or for one kind of object.  They are declared statically,
+/// with mt_HEAP_SITE and mt_HEAP_KIND, and register themselves the
+/// first time they are used.
+typedef struct HeapCounter {
+    const char *name;  ///< the function of a site or the name of a kind
+    const char *file;  ///< NULL for kinds
+    uint32_t line;
+
+    uint64_t live_count;
+    uint64_t live_bytes;
+    uint64_t total_count;
+    uint64_t total_bytes;
+
+    int registered;
+    struct HeapCounter *next;
+} mt_HeapCounter;
+
+/// Declare the counter for the allocation site on the current line.
+#define mt_HEAP_SITE(var) static mt_HeapCounter var = { .name = __func__, .file = __FILE__, .line = __LINE__ }
+
+/// Initialize the counter for a kind of object, eg. a node type.
+#define mt_HEAP_KIND(kind_name) { .name = (kind_name) }
+
+/// Start tracking allocations made through "mt_heap_alloc".  This
+/// must happen before anything is allocated through it, since
+/// tracked allocations carry a header that untracked ones don't.
+/// Sending the process SIGUSR1 writes a snapshot to path.1, path.2
+/// and so on the next time something is allocated.  Returns false
+/// if the signal handler couldn't be installed.
+bool mt_heap_profile_start(const char *path);
+
+/// Allocate memory on behalf of a site and, optionally, a kind.
+/// When profiling is off this is a plain call to malloc.
+void *mt_heap_alloc(mt_HeapCounter *site, mt_HeapCounter *kind, size_t);
+
+/// Free memory allocated by "mt_heap_alloc".
+void mt_heap_free(void *);
+
+/// Write a snapshot of every counter.  Snapshots are plain text with
+/// one counter per line, so two of them can be compared with diff:
+///
+///     # monty heap snapshot v1
+///     # site|kind live_count live_bytes total_count total_bytes name location
+///     site 3 144 3 144 mt_node_init src/parser.c:72
+///     kind 2 96 2 96 NAME -
+///
+/// Sites come first, followed by kinds, each sorted by location and
+/// name.  Live values count memory that hasn't been freed yet, total
+/// values count every allocation ever made.  Returns false if any
+/// write fails.
+bool mt_heap_profile_write(FILE *);
+
+#endif
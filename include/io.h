@@ -0,0 +1,96 @@
+#ifndef mt_io_h
+#define mt_io_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/// The maximum number of readiness events handled per wakeup.
+#define mt_IO_BATCH_SIZE 64
+
+typedef enum {
+    mt_IO_READ,  ///< complete once some bytes have been read or at EOF
+    mt_IO_WRITE,  ///< complete once every byte has been written
+    mt_IO_ACCEPT,  ///< complete once a connection has been accepted
+} mt_IoOperation;
+
+struct IoLoop;
+struct IoRequest;
+
+/// Called once a request completes, from within "mt_io_run".
+/// Callbacks may submit more requests, including on the same fd.
+typedef void (*mt_IoCallback)(struct IoLoop *, struct IoRequest *);
+
+/// Requests are owned by the loop and freed after their callback
+/// returns.
+typedef struct IoRequest {
+    mt_IoOperation operation;
+    int fd;
+    char *buffer;
+    size_t length;
+
+    /// The number of bytes read or written, or the accepted fd, once
+    /// the request completes.  -1 on error, in which case "error"
+    /// holds the errno.
+    ssize_t result;
+    int error;
+
+    mt_IoCallback callback;
+    void *data;
+
+    struct IoRequest *next;
+} mt_IoRequest;
+
+/// Requests waiting on one fd.  Reads and accepts share a queue, as
+/// do writes, and each queue is served in submission order.
+typedef struct {
+    mt_IoRequest *readers;
+    mt_IoRequest *writers;
+    uint32_t events;  ///< the epoll events the fd is registered for
+    bool registered;
+
+    uint32_t pending;  ///< the number of the fd's requests that haven't completed yet
+    int flags;  ///< the fd's file status flags from before it was made non-blocking
+    bool nonblocking;  ///< whether the loop made the fd non-blocking and has to restore flags
+} mt_IoWaiters;
+
+/// IoLoops multiplex non-blocking reads, writes and accepts over
+/// epoll.  Every submitted request is attempted right away and only
+/// waits for readiness if the fd isn't ready.  Regular files, which
+/// epoll can't wait on, are always treated as ready.
+typedef struct IoLoop {
+    int epoll_fd;
+
+    mt_IoWaiters *waiters;  ///< indexed by fd
+    int waiter_capacity;
+
+    mt_IoRequest *ready;  ///< requests to attempt on the next turn, in submission order
+    mt_IoRequest *ready_tail;
+    uint32_t pending;  ///< the number of requests that haven't completed yet
+} mt_IoLoop;
+
+/// Create an IoLoop.  Returns NULL if there isn't enough memory or if
+/// epoll isn't available.
+mt_IoLoop *mt_io_loop_init(void);
+
+/// Submit a request.  fds are switched to non-blocking mode while
+/// they have requests pending and get their original flags back
+/// right before the callback of their last request runs, since the
+/// flags are shared with every process that has the fd open.  The
+/// buffer must stay alive until the request completes.  Returns false
+/// if there isn't enough memory.
+bool mt_io_read(mt_IoLoop *, int fd, char *buffer, size_t length, mt_IoCallback, void *data);
+bool mt_io_write(mt_IoLoop *, int fd, const char *buffer, size_t length, mt_IoCallback, void *data);
+bool mt_io_accept(mt_IoLoop *, int fd, mt_IoCallback, void *data);
+
+/// Run until every request, including those submitted by callbacks,
+/// has completed.  Returns false if waiting for events fails.
+bool mt_io_run(mt_IoLoop *);
+
+/// Free an IoLoop.  Requests that haven't completed are dropped
+/// without calling their callbacks and their fds get their original
+/// flags back.
+void mt_io_loop_free(mt_IoLoop *);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef mt_list_h
+#define mt_list_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+
+/// Lists are growable arrays whose elements are stored back to back.
+/// Integers and Floats are stored unboxed, as int64_t and double
+/// respectively, and every other element type is stored as a pointer
+/// to a value that lives elsewhere.
+typedef struct {
+    mt_TypeTag element_type;
+    uint32_t element_size;
+    uint32_t length;
+    uint32_t capacity;
+    char *elements;
+} mt_List;
+
+/// Iterators walk a List from front to back without allocating.  The
+/// List must not be pushed to or popped from while it's iterated.
+typedef struct {
+    const mt_List *list;
+    uint32_t index;
+} mt_ListIterator;
+
+/// Get the number of bytes a List or Map stores per value of a type.
+uint32_t mt_list_element_size(mt_TypeTag);
+
+/// Create an empty List.  Returns NULL if there isn't enough memory.
+mt_List *mt_list_init(mt_TypeTag element_type);
+
+/// Make room for at least capacity elements.  Returns false if there
+/// isn't enough memory.
+bool mt_list_reserve(mt_List *, uint32_t capacity);
+
+/// Append a copy of an element_size-byte element.  Returns false if
+/// there isn't enough memory.
+bool mt_list_push(mt_List *, const void *element);
+
+/// Append an element to a List of Integers, Floats or pointers.
+bool mt_list_push_integer(mt_List *, int64_t);
+bool mt_list_push_float(mt_List *, double);
+bool mt_list_push_pointer(mt_List *, void *);
+
+/// Get a pointer to an element, or NULL if index is out of bounds.
+/// The pointer is invalidated by the next push.
+void *mt_list_at(const mt_List *, uint32_t index);
+
+/// Remove the last element, copying it into element unless it's NULL.
+/// Returns false if the List is empty.
+bool mt_list_pop(mt_List *, void *element);
+
+mt_ListIterator mt_list_iter(const mt_List *);
+bool mt_list_has_more(const mt_ListIterator *);
+
+/// Get a pointer to the next element and advance past it.
+void *mt_list_get_next(mt_ListIterator *);
+
+/// Free a List.  Pointer elements aren't freed.
+void mt_list_free(mt_List *);
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef mt_loader_h
+#define mt_loader_h
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cache.h"
+#include "parser.h"
+#include "resolver.h"
+
+#define mt_MODULE_EXTENSION ".mt"
+#define mt_LOADER_MAX_THREADS 16
+#define LOADER_ERROR_LENGTH 1024
+
+typedef enum {
+    mt_MODULE_QUEUED,
+    mt_MODULE_LOADED,
+    mt_MODULE_FAILED,
+} mt_ModuleState;
+
+/// Modules are source files along with everything the loader found
+/// out about them.  A module's tree comes either from its parser or,
+/// when its source hasn't changed since it was last loaded, from its
+/// AST cache, so at most one of tree and cache is set once it has
+/// been loaded.  Modules the parser can't handle yet are loaded from
+/// their declarations alone, with neither set and the parse error in
+/// error.
+///
+/// Parsed trees are resolved, with the module's imports declared as
+/// globals, and a module with an undefined name fails to load.  Trees
+/// are only cached once they've been resolved, so cached modules
+/// aren't resolved again.
+typedef struct Module {
+    char *path;  ///< the canonical path of the module's source file
+    char *source;
+    uint64_t source_hash;
+
+    mt_Parser *parser;
+    mt_DeclarationList *declarations;
+    mt_Node *tree;
+    mt_AstCache *cache;
+    mt_Resolver *resolver;  ///< the module's globals, set once its tree has been resolved
+
+    struct Module **imports;  ///< the modules imported by this one, in the order they're imported
+    uint32_t import_count;
+
+    mt_ModuleState state;
+    char error[LOADER_ERROR_LENGTH];
+} mt_Module;
+
+/// Loaders find, read, skim and parse modules along with everything
+/// they import.  Modules are loaded on a pool of threads, so modules
+/// that don't depend on each other are loaded in parallel, and every
+/// module is only ever loaded once per loader, no matter how many
+/// times or from how many threads it's imported.
+///
+/// "import a.b" looks for a/b.mt next to the importing module first,
+/// then in every search path in the order they were added.
+typedef struct {
+    char **search_paths;
+    uint32_t search_path_count;
+    bool use_cache;  ///< whether to read and write AST caches
+
+    mt_Module **modules;  ///< an open-addressing table of every module, keyed by path
+    uint32_t module_count;
+    uint32_t module_capacity;
+
+    mt_Module **queue;  ///< a ring buffer of modules waiting to be loaded
+    uint32_t queue_start;
+    uint32_t queue_length;
+    uint32_t queue_capacity;
+    uint32_t pending;  ///< the number of modules queued or being loaded
+
+    pthread_mutex_t lock;  ///< guards every field above
+    pthread_cond_t work;  ///< signaled when modules are queued or the loader stops
+    pthread_cond_t idle;  ///< signaled when pending drops to 0
+    bool stopping;
+
+    pthread_t threads[mt_LOADER_MAX_THREADS];
+    uint32_t thread_count;
+
+    char error[LOADER_ERROR_LENGTH];
+} mt_Loader;
+
+/// Create a Loader backed by up to mt_LOADER_MAX_THREADS threads.
+/// Passing 0 uses one thread per online CPU.  Returns NULL if there
+/// isn't enough memory or if the threads can't be started.
+mt_Loader *mt_loader_init(uint32_t threads);
+
+/// Add a directory to search for imported modules in.  Returns false
+/// if there isn't enough memory.
+bool mt_loader_add_search_path(mt_Loader *, const char *);
+
+/// Load the module at path along with everything it imports,
+/// directly or not, and wait for all of them to be loaded.  Modules
+/// loaded by earlier calls are reused.  Returns NULL and populates
+/// the "error" field if any of them can't be loaded.
+///
+/// The returned module will be freed when you call "mt_loader_free".
+mt_Module *mt_loader_load(mt_Loader *, const char *path);
+
+/// Stop a Loader's threads and free it along with every module it
+/// loaded.
+void mt_loader_free(mt_Loader *);
+
+#endif
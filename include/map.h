@@ -0,0 +1,79 @@
+#ifndef mt_map_h
+#define mt_map_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "str.h"
+#include "types.h"
+
+/// Slots are grouped this many at a time and every group's control
+/// bytes are probed together.
+#define mt_MAP_GROUP_SIZE 16
+
+/// String keys are compared by contents.  Every other key type is
+/// compared bit for bit, so records and other boxed keys are compared
+/// by identity.
+typedef union {
+    int64_t integer;
+    double number;
+    const mt_String *string;
+    const void *pointer;
+} mt_MapKey;
+
+/// Maps are open-addressing hash tables laid out like Swiss tables.
+/// Every slot has a control byte that's either empty, deleted or
+/// holds 7 bits of its key's hash, and lookups compare a whole group
+/// of control bytes at once so keys are only compared when those bits
+/// match.  String keys aren't copied, so they must outlive the map,
+/// and are compared by pointer before their contents, so interned
+/// keys never have to be compared byte by byte.
+typedef struct {
+    mt_TypeTag key_type;
+    mt_TypeTag value_type;
+    uint32_t value_size;
+
+    uint8_t *control;  ///< capacity control bytes, one per slot
+    mt_MapKey *keys;
+    char *values;
+    uint32_t count;
+    uint32_t deleted;  ///< the number of tombstones
+    uint32_t capacity;  ///< 0 or a power of 2 no smaller than mt_MAP_GROUP_SIZE
+} mt_Map;
+
+/// Iterators walk a Map in slot order without allocating.  The Map
+/// must not be changed while it's iterated.
+typedef struct {
+    const mt_Map *map;
+    uint32_t slot;
+} mt_MapIterator;
+
+/// Create an empty Map.  Values are stored the same way Lists store
+/// their elements.  Returns NULL if there isn't enough memory.
+mt_Map *mt_map_init(mt_TypeTag key_type, mt_TypeTag value_type);
+
+/// Get a pointer to the value of a key, or NULL if it isn't in the
+/// Map.  The pointer is invalidated by the next insertion.
+void *mt_map_get(const mt_Map *, mt_MapKey);
+
+/// Get a pointer to the value of a key, inserting the key with a
+/// zeroed value if it isn't in the Map yet.  inserted, unless it's
+/// NULL, is set to whether the key was inserted.  Returns NULL if
+/// there isn't enough memory.
+void *mt_map_put(mt_Map *, mt_MapKey, bool *inserted);
+
+/// Remove a key.  Returns false if it wasn't in the Map.
+bool mt_map_remove(mt_Map *, mt_MapKey);
+
+mt_MapIterator mt_map_iter(const mt_Map *);
+bool mt_map_has_more(mt_MapIterator *);
+
+/// Get the next key and a pointer to its value and advance past them.
+/// Must only be called after "mt_map_has_more" returns true.
+mt_MapKey mt_map_get_next(mt_MapIterator *, void **value);
+
+/// Free a Map.  Neither keys nor pointer values are freed.
+void mt_map_free(mt_Map *);
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef mt_match_h
+#define mt_match_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "str.h"
+
+typedef enum {
+    mt_PATTERN_INTEGER,
+    mt_PATTERN_STRING,
+    mt_PATTERN_BOOLEAN,
+    mt_PATTERN_RECORD,  ///< a type test against a record shape
+    mt_PATTERN_WILDCARD,
+} mt_PatternType;
+
+/// The number of pattern types that test a value, ie. every type but
+/// mt_PATTERN_WILDCARD.
+#define mt_PATTERN_KIND_COUNT mt_PATTERN_WILDCARD
+
+/// Patterns are the tests of the cases of a match expression.  The
+/// same structure describes the values being matched, in which case
+/// it must not be a wildcard.
+typedef struct {
+    mt_PatternType type;
+    union {
+        int64_t as_integer;
+        mt_String as_string;  ///< not copied, so it must outlive any tree it's compiled into
+        bool as_boolean;
+        uint32_t as_shape;  ///< the index of a shape in the module's TypeTable
+    } value;
+
+    uint32_t line;
+    uint32_t column;
+} mt_Pattern;
+
+/// Returned when no case matches a value.
+#define mt_NO_ARM UINT32_MAX
+
+typedef enum {
+    mt_SWITCH_NONE,  ///< no case tests values of this type
+    mt_SWITCH_JUMP_TABLE,  ///< arms is indexed by key - base
+    mt_SWITCH_SEARCH,  ///< keys is sorted and searched by bisection
+    mt_SWITCH_HASH,  ///< strings is an open-addressing table keyed on string hashes
+} mt_SwitchType;
+
+/// Switches dispatch a value of one type to the arm of the first case
+/// that matches it, or to mt_NO_ARM.  Integers, booleans and record
+/// shapes are keyed on their value and strings on their contents.
+typedef struct {
+    mt_SwitchType type;
+    int64_t base;
+    int64_t *keys;
+    mt_String *strings;
+    uint32_t *arms;  ///< mt_NO_ARM marks gaps in jump tables and empty hash slots
+    uint32_t count;  ///< the number of entries in keys, strings and arms
+} mt_Switch;
+
+#define MATCH_ERROR_LENGTH 1024
+
+/// DecisionTrees select the arm of a match expression with a single
+/// dispatch on the type of the value followed by a single switch on
+/// the value itself, so cases are never tested one after another.
+typedef struct {
+    mt_Switch switches[mt_PATTERN_KIND_COUNT];  ///< indexed by the type of the value
+    uint32_t default_arm;  ///< the arm of the wildcard case, if any
+
+    char error[MATCH_ERROR_LENGTH];
+    uint32_t error_line;
+    uint32_t error_column;
+} mt_DecisionTree;
+
+/// Create a DecisionTree.  Returns NULL if there isn't enough memory.
+mt_DecisionTree *mt_match_init(void);
+
+/// Compile the cases of a match expression into a DecisionTree.  The
+/// arm of a case is its index in the list.
+///
+/// Matches must be exhaustive, which means they must either end in a
+/// wildcard or cover both booleans, and every case must be reachable.
+/// When the return value is false, the "error", "error_line" and
+/// "error_column" fields will be populated with information about the
+/// offending case.
+bool mt_match_compile(mt_DecisionTree *, mt_Pattern *, uint32_t);
+
+/// Select the arm that matches a value.  Returns mt_NO_ARM if no case
+/// matches it.
+uint32_t mt_match_select(mt_DecisionTree *, mt_Pattern *);
+
+/// Free a DecisionTree.
+void mt_match_free(mt_DecisionTree *);
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef mt_parallel_h
+#define mt_parallel_h
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define mt_WORK_POOL_MAX_WORKERS 64
+#define mt_WORKER_ARENA_SIZE (64 * 1024)
+
+/// Loops are split into chunks of at most this many iterations when
+/// they don't ask for a specific grain.
+#define mt_PARALLEL_MAX_CHUNKS 1024
+
+struct WorkPool;
+
+/// Workers run chunks of a loop.  Each one owns a range of chunk
+/// indices that it runs from the front while idle workers steal half
+/// of what's left from the back.
+typedef struct {
+    struct WorkPool *pool;
+    uint32_t id;  ///< 0 is the thread that called "mt_parallel_for"
+    pthread_t thread;
+
+    pthread_mutex_t lock;  ///< guards next and end
+    uint32_t next;  ///< the next chunk this worker will run
+    uint32_t end;  ///< one past the last chunk this worker owns
+
+    char *arena;  ///< memory handed out by "mt_worker_alloc", reset after every chunk
+    size_t arena_used;
+} mt_Worker;
+
+/// The body of a loop runs one chunk, [start, end), at a time and
+/// accumulates into result, which starts out as a copy of the loop's
+/// identity.
+typedef void (*mt_ParallelBody)(mt_Worker *, int64_t start, int64_t end, void *result, void *data);
+
+/// Combine the result of a chunk into an accumulator.
+typedef void (*mt_ParallelReduce)(void *into, const void *from, void *data);
+
+/// Loops run over the range [start, end) in steps of 1.  Every chunk
+/// has its own result and chunk results are reduced in chunk order
+/// once the whole range has run, so as long as reduce is associative
+/// the result doesn't depend on how many workers there are or on
+/// which worker ran what.
+typedef struct {
+    int64_t start;
+    int64_t end;
+    int64_t grain;  ///< the number of iterations per chunk or 0 to pick one
+    size_t result_size;  ///< 0 if the loop has no result
+    const void *identity;
+    mt_ParallelBody body;
+    mt_ParallelReduce reduce;
+    void *data;
+} mt_ParallelLoop;
+
+/// WorkPools run one loop at a time on a set of persistent threads
+/// plus the thread that starts the loop.
+typedef struct WorkPool {
+    mt_Worker workers[mt_WORK_POOL_MAX_WORKERS];
+    uint32_t worker_count;
+
+    pthread_mutex_t lock;  ///< guards every field below
+    pthread_cond_t start;  ///< signaled when a loop starts or the pool stops
+    pthread_cond_t done;  ///< signaled when the last worker leaves a loop
+    uint64_t generation;  ///< incremented every time a loop starts
+    uint32_t busy;  ///< the number of workers still running the current loop
+    bool stopping;
+
+    mt_ParallelLoop *loop;
+    int64_t grain;
+    uint32_t chunk_count;
+    char *results;  ///< one result per chunk
+} mt_WorkPool;
+
+/// Create a WorkPool with the given number of workers, including the
+/// calling thread.  Passing 0 uses one worker per online CPU.
+/// Returns NULL if there isn't enough memory or if the threads can't
+/// be started.
+mt_WorkPool *mt_work_pool_init(uint32_t workers);
+
+/// Run a loop to completion and store its reduced result in result,
+/// which may be NULL if the loop has no result.  Returns false if
+/// there isn't enough memory for the chunk results.
+bool mt_parallel_for(mt_WorkPool *, mt_ParallelLoop *, void *result);
+
+/// Allocate scratch memory that lives until the current chunk ends.
+/// This never contends with other workers.  Returns NULL once the
+/// worker's mt_WORKER_ARENA_SIZE bytes have been used up.
+void *mt_worker_alloc(mt_Worker *, size_t);
+
+/// Stop a WorkPool's threads and free it.
+void mt_work_pool_free(mt_WorkPool *);
+
+#endif
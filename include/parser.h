@@ -1,16 +1,20 @@
 #ifndef mt_parser_h
 #define mt_parser_h
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
 
 #include "scanner.h"
+#include "str.h"
 
 typedef enum {
     mt_NODE_MODULE,
     mt_NODE_STRING,
     mt_NODE_TYPE,
     mt_NODE_NAME,
+    mt_NODE_INTEGER,
+    mt_NODE_FLOAT,
 } mt_NodeType;
 
 struct Node;
@@ -20,16 +24,34 @@ typedef struct NodeList {
     struct NodeList *next;
 } mt_NodeList;
 
+/// The values of STRING, TYPE and NAME nodes may point into the
+/// source buffer the tree was parsed from, so it must outlive them.
 typedef union {
     double as_double;
     int64_t as_integer;
-    char *as_string;
+    mt_String as_string;
     mt_NodeList *as_node_list;
 } mt_NodeValue;
 
+typedef enum {
+    mt_BINDING_UNRESOLVED,
+    mt_BINDING_LOCAL,
+    mt_BINDING_GLOBAL,
+    mt_BINDING_BUILTIN,
+} mt_BindingType;
+
+/// Bindings tell the compiler where the value a NAME node refers to
+/// lives: in a register of the enclosing function, in a module-global
+/// slot or in the table of builtins.
+typedef struct {
+    mt_BindingType type;
+    uint32_t index;  ///< the register, global slot or builtin id
+} mt_Binding;
+
 typedef struct Node {
     mt_NodeType type;
     mt_NodeValue value;
+    mt_Binding binding;  ///< set on NAME nodes by the resolver
 
     uint32_t line;
     uint32_t column;
@@ -38,12 +60,50 @@ typedef struct Node {
 /// Create a Node.  Returns NULL if there isn't enough free memory.
 mt_Node *mt_node_init(mt_NodeType type, uint32_t, uint32_t);
 
+/// Get the name of a NodeType for debugging.
+const char *mt_node_type_name(mt_NodeType);
+
 /// Dump a Node to a stream.
 void mt_node_dump(mt_Node *, FILE *);
 
 /// Free a Node.
 void mt_node_free(mt_Node *);
 
+typedef enum {
+    mt_DECLARATION_DEF,
+    mt_DECLARATION_RECORD,
+    mt_DECLARATION_EXTEND,
+    mt_DECLARATION_PROTOCOL,
+    mt_DECLARATION_IMPORT,
+} mt_DeclarationType;
+
+#define mt_NO_PARENT ((size_t)-1)
+
+/// Declarations describe the location of a definition whose body was
+/// skimmed rather than parsed.  All offsets are relative to the start
+/// of the source buffer.  The name of an import is its whole dotted
+/// module path and its body and end both point right after it.
+typedef struct {
+    mt_DeclarationType type;
+    size_t parent;  ///< the index of the enclosing declaration or mt_NO_PARENT
+
+    char *name;  ///< the start position in the source buffer of the declaration's name
+    size_t name_length;
+
+    size_t start;  ///< the offset of the declaring keyword
+    size_t body;  ///< the offset right after the declaration's header (eg. its parameter list)
+    size_t end;  ///< the offset right after the declaration's "end" keyword
+
+    uint32_t line;
+    uint32_t column;
+} mt_Declaration;
+
+typedef struct {
+    mt_Declaration *declarations;
+    size_t length;
+    size_t capacity;
+} mt_DeclarationList;
+
 #define PARSER_ERROR_LENGTH 1024
 
 /// Parsers turn source code into ASTs.
@@ -55,6 +115,7 @@ typedef struct {
     mt_Token *previous_token;
     mt_Token *current_token;
     mt_Node *tree;  ///< the root AST node
+    mt_DeclarationList *declarations;  ///< the result of skimming the source
 
     char error[PARSER_ERROR_LENGTH];
     uint32_t error_line;
@@ -67,6 +128,8 @@ typedef struct {
 mt_Parser *mt_parser_init(char *filename, char *source);
 
 /// Perform a parse on the Parser's input.  Returns an AST on success.
+/// Imports don't produce nodes since they're resolved from the
+/// declarations found while skimming.
 ///
 /// When the return value is NULL, the "error", "error_line" and
 /// "error_column" fields will be populated with information about the
@@ -75,6 +138,20 @@ mt_Parser *mt_parser_init(char *filename, char *source);
 /// The returned value will be freed when you call "mt_parser_free".
 mt_Node *mt_parser_parse(mt_Parser *);
 
+/// Skim the Parser's input, recording the location of every def,
+/// record, extend, protocol and import without building any AST
+/// nodes.  Only block nesting is checked, so this is much cheaper
+/// than a full parse.  Declarations are recorded in the order in
+/// which they start, so parents always come before their children.
+///
+/// When the return value is NULL, the "error", "error_line" and
+/// "error_column" fields will be populated with information about the
+/// error.  Skimming doesn't consume the Parser's input, so it may be
+/// followed by a call to "mt_parser_parse".
+///
+/// The returned value will be freed when you call "mt_parser_free".
+mt_DeclarationList *mt_parser_skim(mt_Parser *);
+
 /// Free a Parser.
 void mt_parser_free(mt_Parser *);
 
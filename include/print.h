@@ -0,0 +1,29 @@
+#ifndef mt_print_h
+#define mt_print_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "str.h"
+#include "writer.h"
+
+/// Get the Writer behind the print builtin.  It writes to stdout
+/// through a static mt_WRITER_BUFFER_SIZE buffer, so printing never
+/// allocates or fails to start.  It's set up on first use, at which
+/// point it becomes line-buffered if stdout is a terminal and a flush
+/// is registered to run at exit.  It must only be used from one
+/// thread at a time.
+mt_Writer *mt_print_writer(void);
+
+/// Print a value followed by a newline, the way the print builtin
+/// does.  None of them go through printf.
+void mt_print_string(const mt_String *);
+void mt_print_integer(int64_t);
+void mt_print_float(double);
+void mt_print_boolean(bool);
+
+/// Hand everything printed so far to stdout.  Returns false if any
+/// write has failed.
+bool mt_print_flush(void);
+
+#endif
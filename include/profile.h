@@ -0,0 +1,42 @@
+#ifndef mt_profile_h
+#define mt_profile_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/// The sampling frequency used when none is given.  It's prime so
+/// that sampling doesn't fall into lockstep with periodic work.
+#define mt_PROFILE_DEFAULT_FREQUENCY 997
+
+/// Frames deeper than this are still tracked but left out of samples.
+#define mt_PROFILE_MAX_DEPTH 32
+
+/// Start sampling the profile stack on SIGPROF at a frequency in Hz,
+/// measured in CPU time.  Only one profile can run at a time.
+/// Returns false if sampling couldn't be started.
+bool mt_profile_start(uint32_t frequency);
+
+/// Stop sampling.  Samples taken so far are kept until the next call
+/// to "mt_profile_start".
+void mt_profile_stop(void);
+
+/// Push a frame onto the profile stack.  The name must outlive the
+/// profile and the line may be 0 if the frame has no source location.
+/// Does nothing unless a profile is running, so frames can be left in
+/// place at no cost other than a branch.
+void mt_profile_push(const char *name, uint32_t line);
+
+/// Pop the innermost frame off the profile stack.
+void mt_profile_pop(void);
+
+/// Write every sampled stack, outermost frame first, in the folded
+/// format read by flamegraph tools: "main;parse;skim 42".  Returns
+/// false if any write fails.
+bool mt_profile_write(FILE *);
+
+/// Get the number of samples that were dropped because there was no
+/// room left to record them.
+uint64_t mt_profile_dropped(void);
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef mt_resolver_h
+#define mt_resolver_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "parser.h"
+#include "str.h"
+
+/// The names every module can refer to without declaring them.
+#define mt_BUILTINS(X)                          \
+    X(PRINT, "print")
+
+typedef enum {
+#define X(id, name) mt_BUILTIN_##id,
+    mt_BUILTINS(X)
+#undef X
+    mt_BUILTIN_COUNT,
+} mt_BuiltinId;
+
+#define RESOLVER_ERROR_LENGTH 1024
+
+/// Resolvers bind every NAME node in a tree to a local register, a
+/// module-global slot or a builtin so that nothing downstream of
+/// them ever has to look variables up by name.
+///
+/// Locals are declared in scopes.  Registers are numbered from 0 in
+/// the outermost scope and inner scopes keep allocating registers
+/// from where their parent left off.
+typedef struct {
+    const mt_String *builtins;  ///< builtin names, indexed by mt_BuiltinId and shared by every resolver
+
+    mt_String *globals;  ///< global names, indexed by slot
+    uint32_t global_count;
+    uint32_t global_capacity;
+
+    uint32_t *global_table;  ///< an open-addressing table of slots + 1
+    uint32_t global_table_capacity;
+
+    mt_String *locals;  ///< the names of every local in scope, innermost last
+    uint32_t local_count;
+    uint32_t local_capacity;
+
+    uint32_t *scopes;  ///< the value of local_count when every active scope was pushed
+    uint32_t scope_count;
+    uint32_t scope_capacity;
+
+    char error[RESOLVER_ERROR_LENGTH];
+    uint32_t error_line;
+    uint32_t error_column;
+} mt_Resolver;
+
+/// Create a Resolver.  Returns NULL if there isn't enough memory.
+mt_Resolver *mt_resolver_init(void);
+
+/// Declare a module-global name, storing its slot in slot.  Declaring
+/// the same name more than once yields the same slot, so every
+/// overload of a function shares one.  Names are not copied so they
+/// must outlive the resolver.  Returns false if there isn't enough
+/// memory.
+bool mt_resolver_declare_global(mt_Resolver *, const char *, size_t, uint32_t *slot);
+
+/// Enter a new scope.  Returns false if there isn't enough memory.
+bool mt_resolver_push_scope(mt_Resolver *);
+
+/// Leave the innermost scope, forgetting all of its locals.
+void mt_resolver_pop_scope(mt_Resolver *);
+
+/// Declare a local in the innermost scope, storing its register in
+/// reg.  Names are not copied so they must outlive the resolver.
+/// Returns false if there isn't enough memory or if no scope is
+/// active.
+bool mt_resolver_declare_local(mt_Resolver *, const char *, size_t, uint32_t *reg);
+
+/// Look a name up, innermost scope first, then globals and finally
+/// builtins.  Returns an mt_BINDING_UNRESOLVED binding if the name
+/// isn't bound.
+mt_Binding mt_resolver_lookup(mt_Resolver *, mt_String *);
+
+/// Declare every top-level def and import in a list of declarations
+/// as a global, then bind every NAME node in a tree.  "import a.b"
+/// declares a.
+///
+/// When the return value is false, the "error", "error_line" and
+/// "error_column" fields will be populated with information about the
+/// first name that couldn't be resolved.
+bool mt_resolver_resolve(mt_Resolver *, mt_Node *, mt_DeclarationList *);
+
+/// Free a Resolver.
+void mt_resolver_free(mt_Resolver *);
+
+#endif
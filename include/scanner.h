@@ -1,6 +1,7 @@
 #ifndef mt_scanner_h
 #define mt_scanner_h
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -38,7 +39,8 @@ typedef enum {
     mt_TOKEN_CAP_NAME,
     mt_TOKEN_NAME,
     mt_TOKEN_STRING,
-    mt_TOKEN_NUMBER,
+    mt_TOKEN_INTEGER,
+    mt_TOKEN_FLOAT,
 
     // Keywords -- keep these sorted
     mt_TOKEN_AND,
@@ -49,6 +51,7 @@ typedef enum {
     mt_TOKEN_FALSE,
     mt_TOKEN_FOR,
     mt_TOKEN_IF,
+    mt_TOKEN_IMPORT,
     mt_TOKEN_IN,
     mt_TOKEN_MATCH,
     mt_TOKEN_NOT,
@@ -61,6 +64,69 @@ typedef enum {
     mt_TOKEN_WITH,
 } mt_TokenType;
 
+/// The fixed part of the token grammar.  tools/gen_scanner_table.c
+/// compiles these lists, along with the rules for names, numbers,
+/// strings and comments, into the DFA used by "mt_scanner_scan".
+#define mt_OPERATORS(X)                         \
+    X(DOT, ".")                                 \
+    X(COMMA, ",")                               \
+    X(LPAREN, "(")                              \
+    X(RPAREN, ")")                              \
+    X(LBRACKET, "[")                            \
+    X(RBRACKET, "]")                            \
+    X(PLUS, "+")                                \
+    X(MINUS, "-")                               \
+    X(STAR, "*")                                \
+    X(SLASH, "/")                               \
+    X(PERCENT, "%")                             \
+    X(EQUAL, "=")                               \
+    X(EQUAL_EQUAL, "==")                        \
+    X(BANG_EQUAL, "!=")                         \
+    X(LESS, "<")                                \
+    X(LESS_EQUAL, "<=")                         \
+    X(GREATER, ">")                             \
+    X(GREATER_EQUAL, ">=")                      \
+    X(COLON, ":")                               \
+    X(COLON_EQUAL, ":=")
+
+#define mt_KEYWORDS(X)                          \
+    X(AND, "and")                               \
+    X(DEF, "def")                               \
+    X(ELSE, "else")                             \
+    X(END, "end")                               \
+    X(EXTEND, "extend")                         \
+    X(FALSE, "false")                           \
+    X(FOR, "for")                               \
+    X(IF, "if")                                 \
+    X(IMPORT, "import")                         \
+    X(IN, "in")                                 \
+    X(MATCH, "match")                           \
+    X(NOT, "not")                               \
+    X(OR, "or")                                 \
+    X(PROTOCOL, "protocol")                     \
+    X(RECORD, "record")                         \
+    X(RETURN, "return")                         \
+    X(TRUE, "true")                             \
+    X(WHILE, "while")                           \
+    X(WITH, "with")
+
+
+/// The values of literals are computed while scanning so their text
+/// never has to be read again.
+typedef union {
+    int64_t as_integer;  ///< the value of an mt_TOKEN_INTEGER
+    double as_double;  ///< the value of an mt_TOKEN_FLOAT
+
+    /// The contents of an mt_TOKEN_STRING with its escape sequences
+    /// decoded.  Literals without escapes point into the source
+    /// buffer, other literals point to a decoded copy owned by the
+    /// scanner (or token stream) that produced the token.
+    struct {
+        char *data;
+        size_t length;
+        bool decoded;  ///< whether data points to a decoded copy
+    } as_string;
+} mt_TokenValue;
 
 /// Tokens contain positional information along with a type.
 typedef struct {
@@ -68,6 +134,7 @@ typedef struct {
 
     char *start;  ///< the start position in the source buffer for this token's value
     size_t length;  ///< the length of this token's value
+    mt_TokenValue value;
 
     uint32_t line;
     uint32_t column;
@@ -77,6 +144,9 @@ typedef struct {
 /// memory.
 mt_Token *mt_token_init(void);
 
+/// Get the name of a TokenType for debugging.
+const char *mt_token_type_name(mt_TokenType);
+
 /// Stringify a Token into a buffer for debugging.
 void mt_token_debug(mt_Token *, char *, size_t);
 
@@ -87,9 +157,12 @@ void mt_token_copy(mt_Token *, mt_Token *);
 void mt_token_free(mt_Token *);
 
 
+struct StringBlock;
+
 /// Scanners are views on top of character buffers that yield tokens.
 typedef struct {
     char error[255];  ///< holds the error message of the last error token
+    struct StringBlock *strings;  ///< holds decoded string literals until the scanner is freed
 
     char *start;  ///< the start position of the current token
     char *current;  ///< the end position of the current token
@@ -102,10 +175,88 @@ typedef struct {
 /// memory.  The source parameter must outlive the scanner.
 mt_Scanner *mt_scanner_init(char *);
 
-/// Extract the next token from a scanner.
+/// Extract the next token from a scanner.  Operators, names and
+/// keywords are recognized by a DFA generated at build time.
 void mt_scanner_scan(mt_Scanner *, mt_Token *);
 
+/// Extract the next token from a scanner using the original,
+/// hand-written scanner.  It produces exactly the same tokens as
+/// "mt_scanner_scan" and is kept around for differential testing and
+/// benchmarking.
+void mt_scanner_scan_reference(mt_Scanner *, mt_Token *);
+
 /// Free a Scanner.
 void mt_scanner_free(mt_Scanner *);
 
+
+/// TokenStreams hold every token in a buffer, up to and including
+/// the EOF token.  Error tokens in a stream own a copy of their
+/// message since scanners reuse their error buffer, and string tokens
+/// own a copy of their decoded value, if any, since it only lives as
+/// long as the scanner.
+typedef struct {
+    mt_Token *tokens;
+    size_t length;
+    size_t capacity;
+} mt_TokenStream;
+
+/// Initialize a TokenStream.  Returns NULL if there is not enough
+/// free memory.
+mt_TokenStream *mt_token_stream_init(void);
+
+/// Append a copy of a Token to a TokenStream.  Returns false if there
+/// is not enough free memory.
+bool mt_token_stream_push(mt_TokenStream *, mt_Token *);
+
+/// Free a TokenStream.
+void mt_token_stream_free(mt_TokenStream *);
+
+/// Edits replace "length" bytes starting at "offset" in a source
+/// buffer with "text".
+typedef struct {
+    size_t offset;
+    size_t length;
+    char *text;
+    size_t text_length;
+} mt_Edit;
+
+/// Describes the tokens an edit touched: the "removed" tokens
+/// starting at index "start" in the old stream were replaced by the
+/// "inserted" tokens starting at the same index in the new stream.
+/// Every other token was reused as-is.
+typedef struct {
+    size_t start;
+    size_t removed;
+    size_t inserted;
+} mt_TokenSplice;
+
+/// Apply an Edit to a source buffer, returning a new buffer.  The
+/// caller is expected to free the buffer.  Returns NULL if there is
+/// not enough free memory.
+char *mt_edit_apply(char *, mt_Edit *);
+
+/// Update a TokenStream scanned from old_source so that it matches
+/// new_source, the result of applying an Edit to old_source.  Only
+/// the tokens around the edit are rescanned: scanning stops at the
+/// first token past the edit that lines up with a token in the old
+/// stream, after which old tokens are shifted into place.
+///
+/// old_source is only used to compute offsets so it may already have
+/// been freed.  If splice is not NULL, it is populated with the range
+/// of tokens that changed.  Returns false if there is not enough free
+/// memory, in which case the stream is left untouched.
+bool mt_token_stream_edit(mt_TokenStream *, char *old_source, char *new_source, mt_Edit *, mt_TokenSplice *splice);
+
+/// Scan an entire buffer into a TokenStream.  Returns NULL if there
+/// is not enough free memory.  The source parameter must outlive the
+/// stream.
+mt_TokenStream *mt_scanner_scan_all(char *);
+
+/// Scan an entire buffer into a TokenStream by splitting it into
+/// chunks on line boundaries and lexing up to nthreads chunks
+/// concurrently.  The result is always identical to that of
+/// "mt_scanner_scan_all".  Returns NULL if there is not enough free
+/// memory or if threads could not be spawned.
+mt_TokenStream *mt_scanner_scan_parallel(char *, size_t nthreads);
+
 #endif
@@ -0,0 +1,45 @@
+#ifndef mt_stats_h
+#define mt_stats_h
+
+#include <stdint.h>
+#include <stdio.h>
+
+/// Counters are grouped by what they count.  Each group is indexed by
+/// the enum of the thing being counted, eg. mt_TokenType for
+/// mt_STATS_TOKENS.
+typedef enum {
+    mt_STATS_TOKENS,  ///< tokens scanned by mt_scanner_scan, by mt_TokenType
+    mt_STATS_NODES,  ///< AST nodes allocated, by mt_NodeType
+    mt_STATS_DECLARATIONS,  ///< declarations skimmed, by mt_DeclarationType
+    mt_STATS_LOOKUPS,  ///< resolver lookups, by the mt_BindingType they resolved to
+    mt_STATS_SCANNER,  ///< scanner events, by mt_StatsScannerEvent
+    mt_STATS_GROUP_COUNT,
+} mt_StatsGroup;
+
+typedef enum {
+    mt_STATS_DFA_TRANSITIONS,  ///< bytes consumed by the DFA
+    mt_STATS_DECODED_STRINGS,  ///< string literals with escapes that had to be decoded
+    mt_STATS_STRING_BLOCKS,  ///< blocks allocated to hold decoded strings
+    mt_STATS_SCANNER_EVENT_COUNT,
+} mt_StatsScannerEvent;
+
+#define mt_STATS_MAX_KEYS 64
+
+extern uint64_t mt_stats[mt_STATS_GROUP_COUNT][mt_STATS_MAX_KEYS];
+
+/// Counting is compiled in only when building with "make STATS=1",
+/// so these are free in regular builds.  Counters may be bumped from
+/// several threads at once.
+#ifdef mt_STATS_ENABLED
+#define mt_STATS_ADD(group, key, n) __atomic_fetch_add(&mt_stats[group][key], (uint64_t)(n), __ATOMIC_RELAXED)
+#else
+#define mt_STATS_ADD(group, key, n) ((void)0)
+#endif
+
+#define mt_STATS_COUNT(group, key) mt_STATS_ADD(group, key, 1)
+
+/// Write every non-zero counter, grouped and sorted by count from
+/// highest to lowest.
+void mt_stats_report(FILE *);
+
+#endif
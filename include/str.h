@@ -0,0 +1,46 @@
+#ifndef mt_str_h
+#define mt_str_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define mt_STRING_SMALL_CAPACITY 15
+
+/// Strings are immutable byte sequences that know their length and
+/// hash up front so comparing and hashing them never has to look at
+/// their contents.  Strings of up to mt_STRING_SMALL_CAPACITY bytes
+/// are stored inline.  Larger ones either own a heap-allocated copy
+/// of their contents or borrow them from a buffer that outlives them.
+typedef struct {
+    uint32_t length;
+    uint32_t hash;
+    bool owned;  ///< whether as.large was allocated by the string
+    union {
+        char small[mt_STRING_SMALL_CAPACITY + 1];  ///< NUL-terminated
+        const char *large;
+    } as;
+} mt_String;
+
+/// Hash a buffer the same way Strings are hashed.
+uint32_t mt_string_hash(const char *, size_t);
+
+/// Initialize a String with a copy of a buffer.  Returns false if
+/// there is not enough free memory.
+bool mt_string_init(mt_String *, const char *, size_t);
+
+/// Initialize a String without copying large buffers.  The buffer
+/// must outlive the string.
+void mt_string_init_view(mt_String *, const char *, size_t);
+
+/// Get the contents of a String.  They are NUL-terminated unless the
+/// string is a large view.
+const char *mt_string_data(const mt_String *);
+
+/// Check whether two Strings have the same contents.
+bool mt_string_equal(const mt_String *, const mt_String *);
+
+/// Free a String's contents, if it owns them.
+void mt_string_free(mt_String *);
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef mt_types_h
+#define mt_types_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "parser.h"
+#include "scanner.h"
+#include "str.h"
+
+/// The static types the compiler knows how to specialize on.
+/// Everything else, including type parameters and protocols, is
+/// mt_TYPE_UNKNOWN.
+typedef enum {
+    mt_TYPE_UNKNOWN,
+    mt_TYPE_INTEGER,
+    mt_TYPE_FLOAT,
+    mt_TYPE_STRING,
+    mt_TYPE_BOOLEAN,
+    mt_TYPE_RECORD,
+} mt_TypeTag;
+
+/// A field of a record, or a method signature of a protocol, along
+/// with its declared type (the return type, for methods).
+typedef struct {
+    mt_String name;
+    mt_String type_name;  ///< empty if no type was declared
+    mt_TypeTag type;
+    uint32_t record;  ///< the index of the field's record shape when type is mt_TYPE_RECORD
+    uint32_t index;  ///< the position of the field within its record
+} mt_Field;
+
+/// The layout of a record or protocol, in declaration order.
+typedef struct {
+    mt_DeclarationType type;  ///< mt_DECLARATION_RECORD or mt_DECLARATION_PROTOCOL
+    mt_String name;
+    mt_Field *fields;
+    uint32_t field_count;
+} mt_Shape;
+
+#define TYPES_ERROR_LENGTH 1024
+
+/// TypeTables hold the shape of every record and protocol in a
+/// module.  Names point into the source buffer, so it must outlive
+/// the table.
+typedef struct {
+    mt_Shape *shapes;
+    uint32_t shape_count;
+    uint32_t shape_capacity;
+
+    char error[TYPES_ERROR_LENGTH];
+    uint32_t error_line;
+    uint32_t error_column;
+} mt_TypeTable;
+
+/// Create a TypeTable.  Returns NULL if there isn't enough memory.
+mt_TypeTable *mt_types_init(void);
+
+/// Read the fields of every record and the signatures of every
+/// protocol in a list of declarations skimmed from source.
+///
+/// When the return value is false, the "error", "error_line" and
+/// "error_column" fields will be populated with information about the
+/// error.
+bool mt_types_load(mt_TypeTable *, char *source, mt_DeclarationList *);
+
+/// Find a shape by name.  Returns NULL if there is no such shape.
+mt_Shape *mt_types_shape(mt_TypeTable *, mt_String *);
+
+/// Find a field of a shape by name.  Returns NULL if there is no such
+/// field.
+mt_Field *mt_types_field(mt_Shape *, mt_String *);
+
+/// Get the static type of a literal node.
+mt_TypeTag mt_types_of_node(mt_Node *);
+
+/// The operand and result types of a binary operation.  Operations
+/// whose operands are mt_TYPE_UNKNOWN must use the generic,
+/// dynamically dispatched implementation.
+typedef struct {
+    mt_TypeTag operands;
+    mt_TypeTag result;
+} mt_Specialization;
+
+/// Pick the specialized form of a binary operator given the static
+/// types of its operands.  Integers and floats are never mixed
+/// implicitly, so mixed operands stay generic.
+mt_Specialization mt_types_specialize(mt_TokenType, mt_TypeTag, mt_TypeTag);
+
+/// Get the name of a TypeTag for debugging.
+const char *mt_types_tag_name(mt_TypeTag);
+
+/// Free a TypeTable.
+void mt_types_free(mt_TypeTable *);
+
+#endif
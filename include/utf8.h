@@ -0,0 +1,38 @@
+#ifndef mt_utf8_h
+#define mt_utf8_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define mt_UTF8_INVALID UINT32_MAX
+
+/// Check that a buffer is well-formed UTF-8: no overlong encodings,
+/// surrogates, code points past U+10FFFF or truncated sequences.  Runs
+/// of ASCII are skipped 16 bytes at a time.  If the buffer is invalid
+/// and error_offset is not NULL, it is set to the offset of the first
+/// byte of the offending sequence.
+bool mt_utf8_validate(const char *, size_t, size_t *error_offset);
+
+/// Decode the code point at the start of a NUL-terminated buffer,
+/// storing the length of its encoding in length.  Returns
+/// mt_UTF8_INVALID, with a length of 1, for malformed sequences.
+uint32_t mt_utf8_decode(const char *, size_t *length);
+
+/// Encode a code point as UTF-8 into a buffer of at least 4 bytes.
+/// Returns the length of the encoding, or 0 for surrogates and code
+/// points past U+10FFFF.
+size_t mt_utf8_encode(uint32_t, char *);
+
+/// Unicode identifiers are made up of an XID_Start code point followed
+/// by any number of XID_Continue code points.  These only cover code
+/// points past ASCII, which callers are expected to handle on their
+/// own.
+bool mt_unicode_is_xid_start(uint32_t);
+bool mt_unicode_is_xid_continue(uint32_t);
+
+/// Check whether a non-ASCII code point is an uppercase or titlecase
+/// letter that can start an identifier.
+bool mt_unicode_is_upper(uint32_t);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef mt_writer_h
+#define mt_writer_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define mt_WRITER_BUFFER_SIZE (256 * 1024)
+
+/// Writers accumulate output in a large buffer and hand it to a
+/// stream in big blocks.  They never allocate after initialization.
+/// Line-buffered writers also flush whenever a line ends, which is
+/// what interactive output wants.
+typedef struct {
+    FILE *out;  ///< the stream to write to, it must outlive the writer
+    bool line_buffered;
+
+    char *buffer;
+    size_t length;
+    size_t capacity;
+
+    bool failed;  ///< whether any write to the stream has failed
+} mt_Writer;
+
+/// Initialize a Writer.  Returns NULL if there is not enough free
+/// memory.
+mt_Writer *mt_writer_init(FILE *);
+
+/// Write a buffer.
+void mt_writer_write(mt_Writer *, const char *, size_t);
+
+/// Write a NUL-terminated string.
+void mt_writer_write_string(mt_Writer *, const char *);
+
+/// Write a single character.
+void mt_writer_write_char(mt_Writer *, char);
+
+/// Write a character n times.
+void mt_writer_write_repeat(mt_Writer *, char, size_t);
+
+/// Write the decimal representation of an unsigned integer.
+void mt_writer_write_uint(mt_Writer *, uint64_t);
+
+/// Write the decimal representation of a signed integer.
+void mt_writer_write_int(mt_Writer *, int64_t);
+
+/// Write a double the way "mt_dtoa" formats it.
+void mt_writer_write_double(mt_Writer *, double);
+
+/// Write a buffer as a quoted and escaped JSON string.  Bytes that
+/// aren't part of well-formed UTF-8 are written as "\u00XX" escapes.
+void mt_writer_write_json_string(mt_Writer *, const char *, size_t);
+
+/// Write an unsigned integer as 1, 4 or 8 little-endian bytes.
+void mt_writer_write_u8(mt_Writer *, uint8_t);
+void mt_writer_write_u32(mt_Writer *, uint32_t);
+void mt_writer_write_u64(mt_Writer *, uint64_t);
+
+/// Hand any buffered output to the stream and flush it.  Returns
+/// false if any write has failed.
+bool mt_writer_flush(mt_Writer *);
+
+/// Flush and free a Writer.  Returns false if any write has failed.
+bool mt_writer_free(mt_Writer *);
+
+#endif
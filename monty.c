@@ -1,11 +1,21 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "cache.h"
+#include "cli.h"
 #include "common.h"
+#include "dump.h"
+#include "heap.h"
+#include "loader.h"
 #include "parser.h"
+#include "profile.h"
 #include "scanner.h"
+#include "stats.h"
+#include "utf8.h"
+#include "writer.h"
 
 /// --dump-ast
 static bool dump_ast = false;
@@ -13,6 +23,21 @@ static bool dump_ast = false;
 /// --dump-tokens
 static bool dump_tokens = false;
 
+/// --no-cache
+static bool no_cache = false;
+
+/// --format=FORMAT
+static mt_DumpFormat dump_format = mt_DUMP_TEXT;
+
+/// --heap-profile=FILENAME
+static char *heap_profile_filename = NULL;
+
+/// --profile=FILENAME
+static char *profile_filename = NULL;
+
+/// --profile-frequency=HZ
+static uint32_t profile_frequency = mt_PROFILE_DEFAULT_FREQUENCY;
+
 /// -
 static bool source_from_stdin = false;
 
@@ -22,7 +47,8 @@ static char *source_from_cli = NULL;
 /// FILENAME
 static char *source_from_filename = NULL;
 
-#define print_error(msg, ...) do { fprintf(stderr, "error: " msg "\n", ##__VA_ARGS__); exit(1); } while (0)
+#define report_error(msg, ...) fprintf(stderr, "error: " msg "\n", ##__VA_ARGS__)
+#define print_error(msg, ...) do { report_error(msg, ##__VA_ARGS__); exit(1); } while (0)
 
 static void print_usage(char *program_name) {
     fprintf(
@@ -34,11 +60,20 @@ static void print_usage(char *program_name) {
         "  -v, --version  : print the current version and exit\n"
         "  --dump-ast     : print all the AST nodes in the source code without interpreting it\n"
         "  --dump-tokens  : print all the tokens in the source code without interpreting it\n"
+        "  --format=FMT   : the format of --dump-ast and --dump-tokens, one of text, jsonl or binary\n"
+        "  --heap-profile=FILE\n"
+        "                 : track live memory by allocation site and write it to FILE at exit,\n"
+        "                   or to FILE.1, FILE.2, etc. on SIGUSR1\n"
+        "  --no-cache     : neither read nor write cached ASTs\n"
+        "  --profile=FILE : sample where time is spent and write it to FILE as folded stacks\n"
+        "  --profile-frequency=HZ\n"
+        "                 : how many times per second of CPU time to sample (default: %d)\n"
         "  -              : read source from stdin\n"
         "  -c SOURCE      : read source from string\n"
         "  FILENAME       : read source from file\n"
         "  ARG            : argument passed to program via 'std.cli.args'\n",
-        program_name
+        program_name,
+        mt_PROFILE_DEFAULT_FREQUENCY
     );
     exit(1);
 }
@@ -67,6 +102,12 @@ static bool match(char *arg, ...) {
     va_end(args);
 }
 
+/// Everything after the source is left for the program to read from
+/// "std.cli.args".
+static void set_program_args(int argc, char *argv[], int start) {
+    mt_cli_set_args(argv + start, (uint32_t)(argc - start));
+}
+
 static void parse_args(int *argc, char *argv[]) {
     if (*argc <= 1) {
         print_usage(argv[0]);
@@ -96,6 +137,52 @@ static void parse_args(int *argc, char *argv[]) {
             continue;
         }
 
+        if (strncmp(arg, "--format=", 9) == 0) {
+            if (!mt_dump_format_parse(arg + 9, &dump_format)) {
+                print_error("unrecognized format '%s'", arg + 9);
+                return;
+            }
+
+            continue;
+        }
+
+        if (strncmp(arg, "--heap-profile=", 15) == 0) {
+            heap_profile_filename = arg + 15;
+            if (heap_profile_filename[0] == '\0') {
+                print_error("--heap-profile flag expects a filename");
+                return;
+            }
+
+            continue;
+        }
+
+        if (strncmp(arg, "--profile=", 10) == 0) {
+            profile_filename = arg + 10;
+            if (profile_filename[0] == '\0') {
+                print_error("--profile flag expects a filename");
+                return;
+            }
+
+            continue;
+        }
+
+        if (strncmp(arg, "--profile-frequency=", 20) == 0) {
+            char *end = NULL;
+            unsigned long frequency = strtoul(arg + 20, &end, 10);
+            if (arg[20] == '\0' || *end != '\0' || frequency == 0 || frequency > 1000000) {
+                print_error("invalid profile frequency '%s'", arg + 20);
+                return;
+            }
+
+            profile_frequency = (uint32_t)frequency;
+            continue;
+        }
+
+        if (match(arg, "--no-cache", MS)) {
+            no_cache = true;
+            continue;
+        }
+
         if (match(arg, "-c", MS)) {
             if (++i >= *argc) {
                 print_error("-c flag expects an argument");
@@ -103,11 +190,13 @@ static void parse_args(int *argc, char *argv[]) {
             }
 
             source_from_cli = argv[i];
+            set_program_args(*argc, argv, i + 1);
             return;
         }
 
         if (match(arg, "-", MS)) {
             source_from_stdin = true;
+            set_program_args(*argc, argv, i + 1);
             return;
         }
 
@@ -117,59 +206,227 @@ static void parse_args(int *argc, char *argv[]) {
         }
 
         source_from_filename = arg;
+        set_program_args(*argc, argv, i + 1);
         return;
     }
 }
 
 static void do_dump_ast(char *filename, char *source) {
+    mt_Writer *writer = mt_writer_init(stdout);
+    if (!writer) print_error("not enough memory");
+
+    char *cache_path = NULL;
+    uint64_t source_hash = 0;
+    if (!no_cache && source_from_filename) {
+        source_hash = mt_hash_source(source, strlen(source));
+        cache_path = mt_ast_cache_path(filename, source_hash);
+
+        mt_AstCache *cache = cache_path ? mt_ast_cache_open(cache_path, source_hash) : NULL;
+        if (cache && !mt_ast_cache_validate(cache)) {
+            mt_ast_cache_close(cache);
+            cache = NULL;
+        }
+
+        if (cache) {
+            mt_profile_push("dump", 0);
+            mt_ast_cache_dump(cache, writer, dump_format);
+            mt_profile_pop();
+            mt_ast_cache_close(cache);
+            free(cache_path);
+            if (!mt_writer_free(writer)) print_error("could not write the dump");
+            return;
+        }
+    }
+
+    mt_profile_push("parse", 0);
     mt_Parser *parser = mt_parser_init(filename, source);
+    if (!parser) print_error("not enough memory");
+
     mt_Node *tree = mt_parser_parse(parser);
-    mt_node_dump(tree, stdout);
+    mt_profile_pop();
+    if (!tree) print_error("%s:%u:%u: %s", filename, parser->error_line, parser->error_column, parser->error);
+
+    mt_profile_push("dump", 0);
+    mt_dump_tree(writer, dump_format, tree);
+    bool written = mt_writer_free(writer);
+    mt_profile_pop();
+
+    // Failing to write the cache is fine, it just means the next run
+    // will have to parse the source again.
+    mt_profile_push("write_cache", 0);
+    if (cache_path) mt_ast_cache_write(cache_path, source_hash, tree);
+    mt_profile_pop();
+
+    free(cache_path);
     mt_parser_free(parser);
+    if (!written) print_error("could not write the dump");
+}
+
+/// Load a file along with everything it imports.  Besides the
+/// directory of the importing file, imports are looked up in the
+/// colon-separated directories in the MONTY_PATH environment variable.
+static void load_modules(char *filename) {
+    mt_Loader *loader = mt_loader_init(0);
+    if (!loader) print_error("not enough memory");
+
+    loader->use_cache = !no_cache;
+    char *search_path = getenv("MONTY_PATH");
+    if (search_path) {
+        search_path = strdup(search_path);
+        if (!search_path) print_error("not enough memory");
+
+        for (char *directory = strtok(search_path, ":"); directory; directory = strtok(NULL, ":")) {
+            if (!mt_loader_add_search_path(loader, directory)) print_error("not enough memory");
+        }
+
+        free(search_path);
+    }
+
+    if (!mt_loader_load(loader, filename)) {
+        char error[LOADER_ERROR_LENGTH];
+        memcpy(error, loader->error, LOADER_ERROR_LENGTH);
+        mt_loader_free(loader);
+        print_error("%s", error);
+    }
+
+    mt_loader_free(loader);
 }
 
 static void do_dump_tokens(char *source) {
+    mt_Writer *writer = mt_writer_init(stdout);
+    if (!writer) print_error("not enough memory");
+
     mt_Scanner *scanner = mt_scanner_init(source);
-    mt_Token *token = mt_token_init();
-    char debug_buf[255];
+    mt_Token token;
 
     do {
-        mt_scanner_scan(scanner, token);
-        mt_token_debug(token, debug_buf, sizeof(debug_buf));
-
-        printf("%s\n", debug_buf);
-    } while (token->type != mt_TOKEN_EOF);
+        mt_scanner_scan(scanner, &token);
+        mt_dump_token(writer, dump_format, &token);
+    } while (token.type != mt_TOKEN_EOF);
 
-    mt_token_free(token);
     mt_scanner_free(scanner);
+    if (!mt_writer_free(writer)) print_error("could not write the dump");
+}
+
+static void check_encoding(char *filename, char *source) {
+    size_t offset = 0;
+    if (mt_utf8_validate(source, strlen(source), &offset)) return;
+
+    uint32_t line = 1;
+    uint32_t column = 1;
+    for (size_t i = 0; i < offset; i++) {
+        if (source[i] == '\n') {
+            line += 1;
+            column = 1;
+        } else {
+            column += 1;
+        }
+    }
+
+    print_error("%s:%d:%d: invalid UTF-8", filename, line, column);
+}
+
+/// Runs at exit, however monty exits, so it can't exit itself.
+static void write_heap_profile() {
+    FILE *out = fopen(heap_profile_filename, "w");
+    if (!out) {
+        report_error("could not open '%s' to write the heap profile", heap_profile_filename);
+        return;
+    }
+
+    bool ok = mt_heap_profile_write(out);
+    if (fclose(out) != 0 || !ok) report_error("could not write the heap profile to '%s'", heap_profile_filename);
+}
+
+static void start_heap_profile() {
+    if (!heap_profile_filename) return;
+    if (!mt_heap_profile_start(heap_profile_filename)) print_error("could not start the heap profiler");
+    if (atexit(write_heap_profile) != 0) print_error("could not start the heap profiler");
+}
+
+#ifdef mt_STATS_ENABLED
+static void report_stats() {
+    mt_stats_report(stderr);
+}
+#endif
+
+/// Runs at exit, however monty exits, so it can't exit itself.
+static void write_profile() {
+    mt_profile_stop();
+
+    FILE *out = fopen(profile_filename, "w");
+    if (!out) {
+        report_error("could not open '%s' to write the profile", profile_filename);
+        return;
+    }
+
+    bool ok = mt_profile_write(out);
+    if (fclose(out) != 0 || !ok) report_error("could not write the profile to '%s'", profile_filename);
+    if (mt_profile_dropped() > 0) {
+        fprintf(stderr, "warning: %llu profile samples were dropped\n", (unsigned long long)mt_profile_dropped());
+    }
+}
+
+static void start_profile() {
+    if (!profile_filename) return;
+    if (!mt_profile_start(profile_frequency)) print_error("could not start the profiler");
+    if (atexit(write_profile) != 0) print_error("could not start the profiler");
+
+    mt_profile_push("main", 0);
 }
 
 int main(int argc, char *argv[]) {
     parse_args(&argc, argv);
+    start_heap_profile();
+    start_profile();
+
+#ifdef mt_STATS_ENABLED
+    atexit(report_stats);
+#endif
 
     char *error = NULL;
     char *source = NULL;
     if (source_from_cli) {
         source = source_from_cli;
     } else if (source_from_filename) {
+        mt_profile_push("read", 0);
         source = mt_read_entire_file(source_from_filename);
+        mt_profile_pop();
         if (!source) {
             error = "could not read file";
             goto fail;
         }
     } else if (source_from_stdin) {
         source = mt_read_entire_stdin();
+        if (!source) {
+            error = "could not read stdin";
+            goto fail;
+        }
     } else {
         error = "interpreter not implemented";
         goto fail;
     }
 
+    char *filename = source_from_filename ? source_from_filename : "[stdin]";
+    mt_profile_push("check_encoding", 0);
+    check_encoding(filename, source);
+    mt_profile_pop();
+
     if (dump_ast) {
-        char *filename = source_from_filename ? source_from_filename : "[stdin]";
+        mt_profile_push("dump_ast", 0);
         do_dump_ast(filename, source);
+        mt_profile_pop();
     } else if (dump_tokens) {
+        mt_profile_push("dump_tokens", 0);
         do_dump_tokens(source);
+        mt_profile_pop();
     } else {
+        if (source_from_filename) {
+            mt_profile_push("load", 0);
+            load_modules(filename);
+            mt_profile_pop();
+        }
+
         error = "interpreter not implemented";
         goto fail;
     }
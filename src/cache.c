@@ -0,0 +1,698 @@
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "common.h"
+#include "dump.h"
+#include "parser.h"
+#include "writer.h"
+
+/// Hashing
+/// =======
+
+// A 64bit FNV-1a variant that consumes a word at a time.  Caches
+// hash their whole source on every run so this needs to be fast.
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+static uint64_t hash_bytes(uint64_t hash, void *data, size_t length) {
+    uint8_t *bytes = data;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * FNV_PRIME;
+        hash ^= hash >> 32;
+    }
+
+    for (; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+uint64_t mt_hash_source(char *source, size_t length) {
+    return hash_bytes(FNV_OFFSET_BASIS, source, length);
+}
+
+static uint64_t header_checksum(mt_AstCacheHeader *header, mt_AstCacheSection *sections, mt_CachedNode *root, uint32_t *children) {
+    uint64_t hash = hash_bytes(FNV_OFFSET_BASIS, header, offsetof(mt_AstCacheHeader, checksum));
+    hash = hash_bytes(hash, sections, sizeof(mt_AstCacheSection) * header->sections);
+    hash = hash_bytes(hash, root, sizeof(mt_CachedNode));
+    return hash_bytes(hash, children, sizeof(uint32_t) * header->sections);
+}
+
+static uint64_t section_checksum(mt_AstCacheSection *section, mt_CachedNode *nodes, uint32_t *children) {
+    uint64_t hash = hash_bytes(FNV_OFFSET_BASIS, nodes + section->first_node, sizeof(mt_CachedNode) * section->node_count);
+    return hash_bytes(hash, children + section->first_child, sizeof(uint32_t) * section->child_count);
+}
+
+static uint64_t positions_checksum(uint32_t *index, uint32_t index_count, uint8_t *positions, uint32_t length) {
+    uint64_t hash = hash_bytes(FNV_OFFSET_BASIS, index, sizeof(uint32_t) * index_count);
+    return hash_bytes(hash, positions, length);
+}
+
+
+/// Positions
+/// =========
+
+typedef struct {
+    uint8_t *data;
+    uint8_t *end;
+    uint32_t line;
+    uint32_t column;
+} PositionReader;
+
+// Deltas wrap around so they round-trip through uint32 arithmetic.
+static uint32_t zigzag(uint32_t delta) {
+    return (delta << 1) ^ (uint32_t)-(delta >> 31);
+}
+
+static uint32_t unzigzag(uint32_t value) {
+    return (value >> 1) ^ (uint32_t)-(value & 1);
+}
+
+static uint32_t write_varint(uint8_t *data, uint32_t value) {
+    uint32_t length = 0;
+    while (value >= 0x80) {
+        data[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    data[length++] = (uint8_t)value;
+    return length;
+}
+
+static bool read_varint(PositionReader *reader, uint32_t *value) {
+    uint64_t result = 0;
+    for (uint32_t shift = 0; shift < 35; shift += 7) {
+        if (reader->data == reader->end) return false;
+
+        uint8_t byte = *reader->data++;
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            if (result > UINT32_MAX) return false;
+            *value = (uint32_t)result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint32_t write_position(uint8_t *data, uint32_t *line, uint32_t *column, mt_Node *node) {
+    uint32_t length = write_varint(data, zigzag(node->line - *line));
+    if (node->line == *line) {
+        length += write_varint(data + length, zigzag(node->column - *column));
+    } else {
+        length += write_varint(data + length, node->column);
+    }
+
+    *line = node->line;
+    *column = node->column;
+    return length;
+}
+
+static bool read_position(PositionReader *reader) {
+    uint32_t line_delta, column;
+    if (!read_varint(reader, &line_delta) || !read_varint(reader, &column)) return false;
+
+    if (line_delta == 0) {
+        reader->column += unzigzag(column);
+    } else {
+        reader->line += unzigzag(line_delta);
+        reader->column = column;
+    }
+
+    return true;
+}
+
+/// Point a reader at the restart that precedes a node.
+static void seek_position(mt_AstCache *cache, PositionReader *reader, uint32_t index) {
+    reader->data = cache->positions + cache->position_index[index / cache->header->position_interval];
+    reader->end = cache->positions + cache->header->positions;
+    reader->line = 0;
+    reader->column = 0;
+}
+
+
+/// Writing
+/// =======
+
+typedef struct {
+    mt_AstCacheSection *sections;
+    mt_CachedNode *nodes;
+    uint32_t *children;
+    uint32_t *position_index;
+    char *strings;
+    uint8_t *positions;
+
+    uint32_t section_count;
+    uint32_t node_count;
+    uint32_t child_count;
+    uint32_t string_count;
+    uint32_t position_count;
+    uint32_t line;  ///< the line of the last position written
+    uint32_t column;  ///< the column of the last position written
+
+    uint32_t *interned;  ///< an open-addressing table of string offsets + 1
+    uint32_t interned_capacity;
+} Builder;
+
+static void measure_node(mt_Node *node, Builder *builder) {
+    mt_NodeList *head = NULL;
+
+    builder->node_count += 1;
+    switch (node->type) {
+    case mt_NODE_TYPE:
+    case mt_NODE_NAME:
+    case mt_NODE_STRING:
+        builder->string_count += node->value.as_string.length + 1;
+        break;
+
+    case mt_NODE_INTEGER:
+    case mt_NODE_FLOAT:
+        break;
+
+    case mt_NODE_MODULE:
+        for (head = node->value.as_node_list; head; head = head->next) {
+            builder->child_count += 1;
+            measure_node(head->value, builder);
+        }
+        break;
+    }
+}
+
+/// Strings may contain NULs, so a string matches any entry that it's
+/// a NUL-terminated prefix of.
+static uint32_t intern_string(Builder *builder, mt_String *string) {
+    const char *data = mt_string_data(string);
+    uint32_t length = string->length;
+    uint32_t mask = builder->interned_capacity - 1;
+    uint32_t slot = string->hash & mask;
+    while (builder->interned[slot]) {
+        uint32_t offset = builder->interned[slot] - 1;
+        if (memcmp(builder->strings + offset, data, length) == 0 && builder->strings[offset + length] == '\0') {
+            return offset;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    uint32_t offset = builder->string_count;
+    memcpy(builder->strings + offset, data, length);
+    builder->strings[offset + length] = '\0';
+    builder->string_count += length + 1;
+    builder->interned[slot] = offset + 1;
+    return offset;
+}
+
+static uint32_t store_node(mt_Node *node, Builder *builder) {
+    mt_NodeList *head = NULL;
+    uint32_t index = builder->node_count++;
+    mt_CachedNode *cached = &builder->nodes[index];
+
+    cached->type = node->type;
+    cached->offset = 0;
+    cached->length = 0;
+
+    // Nodes are stored in preorder, so positions are written in the
+    // same order as the nodes they belong to.
+    if (index % mt_AST_CACHE_POSITION_INTERVAL == 0) {
+        builder->position_index[index / mt_AST_CACHE_POSITION_INTERVAL] = builder->position_count;
+        builder->line = 0;
+        builder->column = 0;
+    }
+
+    builder->position_count += write_position(builder->positions + builder->position_count, &builder->line, &builder->column, node);
+
+    switch (node->type) {
+    case mt_NODE_TYPE:
+    case mt_NODE_NAME:
+    case mt_NODE_STRING:
+        cached->length = node->value.as_string.length;
+        cached->offset = intern_string(builder, &node->value.as_string);
+        break;
+
+    case mt_NODE_INTEGER:
+    case mt_NODE_FLOAT: {
+        uint64_t bits;
+        memcpy(&bits, &node->value, sizeof(bits));
+        cached->offset = (uint32_t)bits;
+        cached->length = (uint32_t)(bits >> 32);
+        break;
+    }
+
+    case mt_NODE_MODULE:
+        // Children are stored contiguously so their slots must be
+        // reserved before any of their own descendants are stored.
+        for (head = node->value.as_node_list; head; head = head->next) {
+            cached->length += 1;
+        }
+
+        cached->offset = builder->child_count;
+        builder->child_count += cached->length;
+
+        uint32_t slot = cached->offset;
+        for (head = node->value.as_node_list; head; head = head->next) {
+            mt_AstCacheSection *section = index == 0 ? &builder->sections[builder->section_count++] : NULL;
+            if (section) {
+                section->first_node = builder->node_count;
+                section->first_child = builder->child_count;
+            }
+
+            uint32_t child = store_node(head->value, builder);
+            builder->children[slot++] = child;
+
+            if (section) {
+                section->node_count = builder->node_count - section->first_node;
+                section->child_count = builder->child_count - section->first_child;
+                section->checksum = section_checksum(section, builder->nodes, builder->children);
+            }
+        }
+        break;
+    }
+
+    return index;
+}
+
+bool mt_ast_cache_write(char *path, uint64_t source_hash, mt_Node *tree) {
+    Builder builder;
+    memset(&builder, 0, sizeof(Builder));
+    measure_node(tree, &builder);
+
+    uint32_t sections = 0;
+    if (tree->type == mt_NODE_MODULE) {
+        for (mt_NodeList *head = tree->value.as_node_list; head; head = head->next) {
+            sections += 1;
+        }
+    }
+
+    // The string and position tables come last since their sizes are
+    // only known once strings have been interned and positions have
+    // been encoded.  Positions take at most two 5-byte varints each.
+    uint32_t index_count = (builder.node_count + mt_AST_CACHE_POSITION_INTERVAL - 1) / mt_AST_CACHE_POSITION_INTERVAL;
+    size_t strings_offset = sizeof(mt_AstCacheHeader)
+        + sizeof(mt_AstCacheSection) * sections
+        + sizeof(mt_CachedNode) * builder.node_count
+        + sizeof(uint32_t) * builder.child_count
+        + sizeof(uint32_t) * index_count;
+
+    char *data = calloc(1, strings_offset + builder.string_count);
+    if (!data) return false;
+
+    builder.positions = malloc(sizeof(uint8_t) * 10 * builder.node_count);
+    if (!builder.positions) {
+        free(data);
+        return false;
+    }
+
+    builder.interned_capacity = 16;
+    while (builder.interned_capacity < builder.node_count * 2) builder.interned_capacity *= 2;
+    builder.interned = calloc(builder.interned_capacity, sizeof(uint32_t));
+    if (!builder.interned) {
+        free(builder.positions);
+        free(data);
+        return false;
+    }
+
+    mt_AstCacheHeader *header = (mt_AstCacheHeader *)data;
+    builder.sections = (mt_AstCacheSection *)(data + sizeof(mt_AstCacheHeader));
+    builder.nodes = (mt_CachedNode *)(builder.sections + sections);
+    builder.children = (uint32_t *)(builder.nodes + builder.node_count);
+    builder.position_index = builder.children + builder.child_count;
+    builder.strings = data + strings_offset;
+    builder.node_count = 0;
+    builder.child_count = 0;
+    builder.string_count = 0;
+    store_node(tree, &builder);
+    free(builder.interned);
+
+    size_t data_size = strings_offset + builder.string_count;
+    size_t size = data_size + builder.position_count;
+    memcpy(header->magic, mt_AST_CACHE_MAGIC, sizeof(header->magic));
+    header->format = mt_AST_CACHE_FORMAT;
+    header->flags = mt_AST_CACHE_INTERNED;
+    strncpy(header->version, mt_VERSION, sizeof(header->version) - 1);
+    header->source_hash = source_hash;
+    header->size = size;
+    header->sections = sections;
+    header->nodes = builder.node_count;
+    header->children = builder.child_count;
+    header->strings = builder.string_count;
+    header->positions = builder.position_count;
+    header->position_interval = mt_AST_CACHE_POSITION_INTERVAL;
+    header->strings_checksum = hash_bytes(FNV_OFFSET_BASIS, builder.strings, builder.string_count);
+    header->positions_checksum = positions_checksum(builder.position_index, index_count, builder.positions, builder.position_count);
+    header->checksum = header_checksum(header, builder.sections, builder.nodes, builder.children);
+
+    // Write to a temporary file first so that concurrent readers never
+    // see partially-written caches.
+    size_t path_length = strlen(path);
+    char *tmp_path = malloc(sizeof(char) * (path_length + 32));
+    if (!tmp_path) {
+        free(builder.positions);
+        free(data);
+        return false;
+    }
+
+    snprintf(tmp_path, path_length + 32, "%s.%ld.tmp", path, (long)getpid());
+
+    bool ok = false;
+    FILE *handle = fopen(tmp_path, "wb");
+    if (handle) {
+        ok = fwrite(data, sizeof(char), data_size, handle) == data_size;
+        ok = ok && fwrite(builder.positions, sizeof(uint8_t), builder.position_count, handle) == builder.position_count;
+        ok = fclose(handle) == 0 && ok;
+        ok = ok && rename(tmp_path, path) == 0;
+        if (!ok) remove(tmp_path);
+    }
+
+    free(tmp_path);
+    free(builder.positions);
+    free(data);
+    return ok;
+}
+
+
+/// Reading
+/// =======
+
+char *mt_ast_cache_path(char *filename, uint64_t source_hash) {
+    char *cache_dir = getenv("MONTY_CACHE_DIR");
+    size_t length = cache_dir ? strlen(cache_dir) + 22 : strlen(filename) + 2;
+
+    char *path = malloc(sizeof(char) * length);
+    if (!path) return NULL;
+
+    if (cache_dir) {
+        snprintf(path, length, "%s/%016llx.mtc", cache_dir, (unsigned long long)source_hash);
+    } else {
+        snprintf(path, length, "%sc", filename);
+    }
+
+    return path;
+}
+
+static uint32_t position_index_count(mt_AstCacheHeader *header) {
+    return (header->nodes + header->position_interval - 1) / header->position_interval;
+}
+
+static bool validate_header(mt_AstCache *cache, uint64_t source_hash) {
+    if (cache->size < sizeof(mt_AstCacheHeader)) return false;
+
+    mt_AstCacheHeader *header = cache->header;
+    if (memcmp(header->magic, mt_AST_CACHE_MAGIC, sizeof(header->magic)) != 0) return false;
+    if (header->format != mt_AST_CACHE_FORMAT) return false;
+    if (strncmp(header->version, mt_VERSION, sizeof(header->version)) != 0) return false;
+    if (header->source_hash != source_hash) return false;
+    if (header->size != cache->size) return false;
+    if (header->nodes == 0 || header->sections > header->children) return false;
+    if (header->position_interval != mt_AST_CACHE_POSITION_INTERVAL) return false;
+
+    uint64_t size = sizeof(mt_AstCacheHeader)
+        + sizeof(mt_AstCacheSection) * (uint64_t)header->sections
+        + sizeof(mt_CachedNode) * (uint64_t)header->nodes
+        + sizeof(uint32_t) * (uint64_t)header->children
+        + sizeof(uint32_t) * (uint64_t)position_index_count(header)
+        + sizeof(char) * (uint64_t)header->strings
+        + sizeof(uint8_t) * (uint64_t)header->positions;
+    if (size != cache->size) return false;
+
+    cache->sections = (mt_AstCacheSection *)((char *)cache->data + sizeof(mt_AstCacheHeader));
+    cache->nodes = (mt_CachedNode *)(cache->sections + header->sections);
+    cache->children = (uint32_t *)(cache->nodes + header->nodes);
+    cache->position_index = cache->children + header->children;
+    cache->strings = (char *)(cache->position_index + position_index_count(header));
+    cache->positions = (uint8_t *)(cache->strings + header->strings);
+    if (header->checksum != header_checksum(header, cache->sections, cache->nodes, cache->children)) return false;
+
+    mt_CachedNode *root = &cache->nodes[0];
+    if (root->type != mt_NODE_MODULE || root->offset != 0 || root->length != header->sections) return false;
+
+    for (uint32_t i = 0; i < header->sections; i++) {
+        if (cache->children[i] != cache->sections[i].first_node) return false;
+    }
+
+    return true;
+}
+
+static bool validate_section(mt_AstCache *cache, uint32_t index) {
+    mt_AstCacheHeader *header = cache->header;
+    mt_AstCacheSection *section = &cache->sections[index];
+
+    uint64_t nodes_end = (uint64_t)section->first_node + section->node_count;
+    uint64_t children_end = (uint64_t)section->first_child + section->child_count;
+    if (section->first_node == 0 || section->node_count == 0 || nodes_end > header->nodes) return false;
+    if (section->first_child < header->sections || children_end > header->children) return false;
+    if (section->checksum != section_checksum(section, cache->nodes, cache->children)) return false;
+
+    // Nodes are used in place, so make sure they can't point outside
+    // of their section.  Children always come after their parents,
+    // which rules out cycles.
+    for (uint32_t i = section->first_node; i < nodes_end; i++) {
+        mt_CachedNode *node = &cache->nodes[i];
+
+        switch (node->type) {
+        case mt_NODE_TYPE:
+        case mt_NODE_NAME:
+        case mt_NODE_STRING:
+            if ((uint64_t)node->offset + node->length >= header->strings) return false;
+            if (cache->strings[node->offset + node->length] != '\0') return false;
+            break;
+
+        case mt_NODE_INTEGER:
+        case mt_NODE_FLOAT:
+            break;
+
+        case mt_NODE_MODULE:
+            if (node->offset < section->first_child) return false;
+            if ((uint64_t)node->offset + node->length > children_end) return false;
+            for (uint32_t j = 0; j < node->length; j++) {
+                uint32_t child = cache->children[node->offset + j];
+                if (child <= i || child >= nodes_end) return false;
+            }
+            break;
+
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool ensure_section(mt_AstCache *cache, uint32_t index) {
+    if (cache->section_states[index] == mt_AST_CACHE_UNCHECKED) {
+        cache->section_states[index] = validate_section(cache, index) ? mt_AST_CACHE_VALID : mt_AST_CACHE_CORRUPT;
+    }
+
+    return cache->section_states[index] == mt_AST_CACHE_VALID;
+}
+
+static bool ensure_strings(mt_AstCache *cache) {
+    if (cache->strings_state == mt_AST_CACHE_UNCHECKED) {
+        uint64_t checksum = hash_bytes(FNV_OFFSET_BASIS, cache->strings, cache->header->strings);
+        cache->strings_state = checksum == cache->header->strings_checksum ? mt_AST_CACHE_VALID : mt_AST_CACHE_CORRUPT;
+    }
+
+    return cache->strings_state == mt_AST_CACHE_VALID;
+}
+
+static bool ensure_positions(mt_AstCache *cache) {
+    if (cache->positions_state == mt_AST_CACHE_UNCHECKED) {
+        mt_AstCacheHeader *header = cache->header;
+        uint32_t count = position_index_count(header);
+        bool valid = positions_checksum(cache->position_index, count, cache->positions, header->positions) == header->positions_checksum;
+        for (uint32_t i = 0; valid && i < count; i++) {
+            valid = cache->position_index[i] < header->positions;
+        }
+
+        cache->positions_state = valid ? mt_AST_CACHE_VALID : mt_AST_CACHE_CORRUPT;
+    }
+
+    return cache->positions_state == mt_AST_CACHE_VALID;
+}
+
+mt_AstCache *mt_ast_cache_open(char *path, uint64_t source_hash) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+
+    mt_AstCache *cache = malloc(sizeof(mt_AstCache));
+    if (!cache) {
+        munmap(data, (size_t)st.st_size);
+        return NULL;
+    }
+
+    cache->data = data;
+    cache->size = (size_t)st.st_size;
+    cache->header = data;
+    cache->section_states = NULL;
+    cache->strings_state = mt_AST_CACHE_UNCHECKED;
+    cache->positions_state = mt_AST_CACHE_UNCHECKED;
+    if (!validate_header(cache, source_hash)) goto fail;
+
+    cache->section_states = calloc(cache->header->sections + 1, sizeof(uint8_t));
+    if (!cache->section_states) goto fail;
+
+    return cache;
+
+fail:
+    mt_ast_cache_close(cache);
+    return NULL;
+}
+
+bool mt_ast_cache_validate(mt_AstCache *cache) {
+    for (uint32_t i = 0; i < cache->header->sections; i++) {
+        if (!ensure_section(cache, i)) return false;
+    }
+
+    return ensure_strings(cache) && ensure_positions(cache);
+}
+
+mt_CachedNode *mt_ast_cache_root(mt_AstCache *cache) {
+    return &cache->nodes[0];
+}
+
+mt_CachedNode *mt_cached_node_child(mt_AstCache *cache, mt_CachedNode *node, uint32_t i) {
+    if (node == &cache->nodes[0] && !ensure_section(cache, i)) return NULL;
+    return &cache->nodes[cache->children[node->offset + i]];
+}
+
+char *mt_cached_node_string(mt_AstCache *cache, mt_CachedNode *node) {
+    if (!ensure_strings(cache)) return NULL;
+    return cache->strings + node->offset;
+}
+
+mt_NodeValue mt_cached_node_number(mt_CachedNode *node) {
+    uint64_t bits = (uint64_t)node->length << 32 | node->offset;
+    mt_NodeValue value;
+    memcpy(&value, &bits, sizeof(bits));
+    return value;
+}
+
+bool mt_cached_node_position(mt_AstCache *cache, mt_CachedNode *node, uint32_t *line, uint32_t *column) {
+    if (!ensure_positions(cache)) return false;
+
+    uint32_t index = (uint32_t)(node - cache->nodes);
+    PositionReader reader;
+    seek_position(cache, &reader, index);
+    for (uint32_t i = index - index % cache->header->position_interval; i <= index; i++) {
+        if (!read_position(&reader)) return false;
+    }
+
+    *line = reader.line;
+    *column = reader.column;
+    return true;
+}
+
+typedef struct {
+    mt_DumpNode node;
+    mt_CachedNode *cached;
+    uint32_t next;  ///< the index of the next child to dump
+} Frame;
+
+/// Nodes are entered in preorder, which is the order they are stored
+/// in, so their positions are decoded by a single reader as the dump
+/// progresses.
+static bool enter_cached_node(mt_AstCache *cache, mt_Writer *writer, mt_DumpFormat format, PositionReader *reader, Frame *frame, mt_CachedNode *cached, uint32_t parent, uint32_t depth) {
+    uint32_t index = (uint32_t)(cached - cache->nodes);
+    if (index % cache->header->position_interval == 0) seek_position(cache, reader, index);
+    if (!read_position(reader)) return false;
+
+    mt_DumpNode *dump = &frame->node;
+    dump->type = cached->type;
+    dump->line = reader->line;
+    dump->column = reader->column;
+    dump->value = NULL;
+    dump->length = 0;
+    dump->number.as_integer = 0;
+    dump->children = 0;
+    dump->id = index;
+    dump->parent = parent;
+    dump->depth = depth;
+    frame->cached = cached;
+    frame->next = 0;
+
+    if (cached->type == mt_NODE_MODULE) {
+        dump->children = cached->length;
+    } else if (cached->type == mt_NODE_INTEGER || cached->type == mt_NODE_FLOAT) {
+        dump->number = mt_cached_node_number(cached);
+    } else {
+        dump->value = mt_cached_node_string(cache, cached);
+        dump->length = cached->length;
+    }
+
+    mt_dump_node_enter(writer, format, dump);
+    return true;
+}
+
+bool mt_ast_cache_dump(mt_AstCache *cache, mt_Writer *writer, mt_DumpFormat format) {
+    Frame inline_stack[32];
+    Frame *stack = inline_stack;
+    size_t capacity = sizeof(inline_stack) / sizeof(inline_stack[0]);
+    size_t depth = 1;
+    bool ok = true;
+
+    PositionReader reader;
+    if (!enter_cached_node(cache, writer, format, &reader, &stack[0], mt_ast_cache_root(cache), mt_DUMP_NO_PARENT, 0)) return false;
+    while (depth > 0) {
+        Frame *frame = &stack[depth - 1];
+        if (frame->next == frame->node.children) {
+            mt_dump_node_leave(writer, format, &frame->node);
+            depth -= 1;
+            continue;
+        }
+
+        mt_CachedNode *child = mt_cached_node_child(cache, frame->cached, frame->next++);
+        if (depth == capacity) {
+            Frame *new_stack = malloc(sizeof(Frame) * capacity * 2);
+            if (!new_stack) {
+                if (stack != inline_stack) free(stack);
+                return false;
+            }
+
+            memcpy(new_stack, stack, sizeof(Frame) * capacity);
+            if (stack != inline_stack) free(stack);
+            stack = new_stack;
+            capacity *= 2;
+            frame = &stack[depth - 1];
+        }
+
+        if (!enter_cached_node(cache, writer, format, &reader, &stack[depth], child, frame->node.id, (uint32_t)depth)) {
+            ok = false;
+            break;
+        }
+
+        depth += 1;
+    }
+
+    if (stack != inline_stack) free(stack);
+    return ok;
+}
+
+void mt_ast_cache_close(mt_AstCache *cache) {
+    munmap(cache->data, cache->size);
+    free(cache->section_states);
+    free(cache);
+}
@@ -0,0 +1,24 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cli.h"
+
+static char **cli_args = NULL;
+static uint32_t cli_arg_count = 0;
+
+void mt_cli_set_args(char **args, uint32_t count) {
+    cli_args = args;
+    cli_arg_count = count;
+}
+
+uint32_t mt_cli_arg_count() {
+    return cli_arg_count;
+}
+
+bool mt_cli_arg(uint32_t index, mt_String *string) {
+    if (index >= cli_arg_count) return false;
+
+    mt_string_init_view(string, cli_args[index], strlen(cli_args[index]));
+    return true;
+}
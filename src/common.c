@@ -1,6 +1,6 @@
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 
 #include "common.h"
 
@@ -17,24 +17,36 @@ size_t mt_get_file_size(FILE *handle) {
 }
 
 char *mt_read_entire_stdin() {
-    char buf[BUFSIZE] = "";
-    char *outbuf = malloc(sizeof(char) * BUFSIZE);
-    char *oldoutbuf = outbuf;
-    size_t outbufsz = 1;
-
-    outbuf[0] = '\0';
-    while (fgets(buf, BUFSIZE, stdin)) {
-        oldoutbuf = outbuf;
-        outbufsz += strlen(buf);
-        outbuf = (char *)realloc(outbuf, sizeof(char) * outbufsz);
-        if (!outbuf) {
-            free(oldoutbuf);
-            return NULL;
+    size_t capacity = BUFSIZE;
+    size_t length = 0;
+    char *outbuf = malloc(sizeof(char) * capacity);
+    if (!outbuf) return NULL;
+
+    // Read in large blocks into a buffer that doubles whenever it runs
+    // low so reading n bytes takes O(n) time.
+    while (true) {
+        if (capacity - length < BUFSIZE) {
+            char *new_outbuf = realloc(outbuf, sizeof(char) * capacity * 2);
+            if (!new_outbuf) {
+                free(outbuf);
+                return NULL;
+            }
+
+            outbuf = new_outbuf;
+            capacity *= 2;
         }
 
-        strcat(outbuf, buf);
+        size_t bytes_read = fread(outbuf + length, sizeof(char), capacity - length - 1, stdin);
+        length += bytes_read;
+        if (bytes_read == 0) break;
+    }
+
+    if (ferror(stdin)) {
+        free(outbuf);
+        return NULL;
     }
 
+    outbuf[length] = '\0';
     return outbuf;
 }
 
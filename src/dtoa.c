@@ -0,0 +1,304 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "dtoa.h"
+
+/// Shortest digits are found with Grisu2 (Florian Loitsch, "Printing
+/// Floating-Point Numbers Quickly and Accurately with Integers").  It
+/// only needs 64-bit integer arithmetic and a small table of powers
+/// of ten, and its output always reads back as the same double.  In
+/// rare cases it picks a digit more than strictly necessary.
+
+#define SIGNIFICAND_MASK 0x000fffffffffffffull
+#define HIDDEN_BIT 0x0010000000000000ull
+
+/// Floats with a 64-bit significand and no implicit bit.
+typedef struct {
+    uint64_t f;
+    int e;
+} DiyFp;
+
+/// Normalized approximations of 10^-348, 10^-340, ..., 10^340.
+static const DiyFp CACHED_POWERS[] = {
+    { 0xfa8fd5a0081c0288ull, -1220 }, { 0xbaaee17fa23ebf76ull, -1193 }, { 0x8b16fb203055ac76ull, -1166 },
+    { 0xcf42894a5dce35eaull, -1140 }, { 0x9a6bb0aa55653b2dull, -1113 }, { 0xe61acf033d1a45dfull, -1087 },
+    { 0xab70fe17c79ac6caull, -1060 }, { 0xff77b1fcbebcdc4full, -1034 }, { 0xbe5691ef416bd60cull, -1007 },
+    { 0x8dd01fad907ffc3cull, -980 }, { 0xd3515c2831559a83ull, -954 }, { 0x9d71ac8fada6c9b5ull, -927 },
+    { 0xea9c227723ee8bcbull, -901 }, { 0xaecc49914078536dull, -874 }, { 0x823c12795db6ce57ull, -847 },
+    { 0xc21094364dfb5637ull, -821 }, { 0x9096ea6f3848984full, -794 }, { 0xd77485cb25823ac7ull, -768 },
+    { 0xa086cfcd97bf97f4ull, -741 }, { 0xef340a98172aace5ull, -715 }, { 0xb23867fb2a35b28eull, -688 },
+    { 0x84c8d4dfd2c63f3bull, -661 }, { 0xc5dd44271ad3cdbaull, -635 }, { 0x936b9fcebb25c996ull, -608 },
+    { 0xdbac6c247d62a584ull, -582 }, { 0xa3ab66580d5fdaf6ull, -555 }, { 0xf3e2f893dec3f126ull, -529 },
+    { 0xb5b5ada8aaff80b8ull, -502 }, { 0x87625f056c7c4a8bull, -475 }, { 0xc9bcff6034c13053ull, -449 },
+    { 0x964e858c91ba2655ull, -422 }, { 0xdff9772470297ebdull, -396 }, { 0xa6dfbd9fb8e5b88full, -369 },
+    { 0xf8a95fcf88747d94ull, -343 }, { 0xb94470938fa89bcfull, -316 }, { 0x8a08f0f8bf0f156bull, -289 },
+    { 0xcdb02555653131b6ull, -263 }, { 0x993fe2c6d07b7facull, -236 }, { 0xe45c10c42a2b3b06ull, -210 },
+    { 0xaa242499697392d3ull, -183 }, { 0xfd87b5f28300ca0eull, -157 }, { 0xbce5086492111aebull, -130 },
+    { 0x8cbccc096f5088ccull, -103 }, { 0xd1b71758e219652cull, -77 }, { 0x9c40000000000000ull, -50 },
+    { 0xe8d4a51000000000ull, -24 }, { 0xad78ebc5ac620000ull, 3 }, { 0x813f3978f8940984ull, 30 },
+    { 0xc097ce7bc90715b3ull, 56 }, { 0x8f7e32ce7bea5c70ull, 83 }, { 0xd5d238a4abe98068ull, 109 },
+    { 0x9f4f2726179a2245ull, 136 }, { 0xed63a231d4c4fb27ull, 162 }, { 0xb0de65388cc8ada8ull, 189 },
+    { 0x83c7088e1aab65dbull, 216 }, { 0xc45d1df942711d9aull, 242 }, { 0x924d692ca61be758ull, 269 },
+    { 0xda01ee641a708deaull, 295 }, { 0xa26da3999aef774aull, 322 }, { 0xf209787bb47d6b85ull, 348 },
+    { 0xb454e4a179dd1877ull, 375 }, { 0x865b86925b9bc5c2ull, 402 }, { 0xc83553c5c8965d3dull, 428 },
+    { 0x952ab45cfa97a0b3ull, 455 }, { 0xde469fbd99a05fe3ull, 481 }, { 0xa59bc234db398c25ull, 508 },
+    { 0xf6c69a72a3989f5cull, 534 }, { 0xb7dcbf5354e9beceull, 561 }, { 0x88fcf317f22241e2ull, 588 },
+    { 0xcc20ce9bd35c78a5ull, 614 }, { 0x98165af37b2153dfull, 641 }, { 0xe2a0b5dc971f303aull, 667 },
+    { 0xa8d9d1535ce3b396ull, 694 }, { 0xfb9b7cd9a4a7443cull, 720 }, { 0xbb764c4ca7a44410ull, 747 },
+    { 0x8bab8eefb6409c1aull, 774 }, { 0xd01fef10a657842cull, 800 }, { 0x9b10a4e5e9913129ull, 827 },
+    { 0xe7109bfba19c0c9dull, 853 }, { 0xac2820d9623bf429ull, 880 }, { 0x80444b5e7aa7cf85ull, 907 },
+    { 0xbf21e44003acdd2dull, 933 }, { 0x8e679c2f5e44ff8full, 960 }, { 0xd433179d9c8cb841ull, 986 },
+    { 0x9e19db92b4e31ba9ull, 1013 }, { 0xeb96bf6ebadf77d9ull, 1039 }, { 0xaf87023b9bf0ee6bull, 1066 },
+};
+
+static const uint64_t POWERS_OF_10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+    10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+    100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+};
+
+
+/// DiyFps
+/// ======
+
+static DiyFp diy_fp_of(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    int biased_exponent = (int)((bits >> 52) & 0x7ff);
+    uint64_t significand = bits & SIGNIFICAND_MASK;
+    if (biased_exponent == 0) return (DiyFp){ significand, -1074 };
+    return (DiyFp){ significand + HIDDEN_BIT, biased_exponent - 1075 };
+}
+
+static DiyFp normalize(DiyFp x) {
+    int shift = __builtin_clzll(x.f);
+    return (DiyFp){ x.f << shift, x.e - shift };
+}
+
+static DiyFp subtract(DiyFp a, DiyFp b) {
+    return (DiyFp){ a.f - b.f, a.e };
+}
+
+/// Multiply two DiyFps, rounding the product to 64 bits.
+static DiyFp multiply(DiyFp a, DiyFp b) {
+    unsigned __int128 product = (unsigned __int128)a.f * b.f;
+    uint64_t high = (uint64_t)(product >> 64);
+    uint64_t low = (uint64_t)product;
+    return (DiyFp){ high + (low >> 63), a.e + b.e + 64 };
+}
+
+/// Get the midpoints between a value and its neighbours, which bound
+/// every decimal that reads back as the value.  Both share the upper
+/// one's normalized exponent.
+static void get_boundaries(DiyFp v, DiyFp *minus, DiyFp *plus) {
+    *plus = normalize((DiyFp){ (v.f << 1) + 1, v.e - 1 });
+
+    // Powers of two are closer to their lower neighbour.
+    *minus = v.f == HIDDEN_BIT ? (DiyFp){ (v.f << 2) - 1, v.e - 2 } : (DiyFp){ (v.f << 1) - 1, v.e - 1 };
+    minus->f <<= minus->e - plus->e;
+    minus->e = plus->e;
+}
+
+/// Find a cached power of ten, 10^-k, that brings a binary exponent
+/// into the range digit generation works in.
+static DiyFp get_cached_power(int e, int *k) {
+    double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int rounded = (int)dk;
+    if (dk - rounded > 0.0) rounded += 1;
+
+    int index = (rounded >> 3) + 1;
+    *k = -(-348 + index * 8);
+    return CACHED_POWERS[index];
+}
+
+
+/// Digits
+/// ======
+
+static int count_digits(uint32_t n) {
+    int count = 1;
+    while (n >= 10) {
+        n /= 10;
+        count += 1;
+    }
+
+    return count;
+}
+
+/// Move the last digit towards the value for as long as that keeps it
+/// inside the boundaries.
+static void round_digits(char *digits, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t distance) {
+    while (
+        rest < distance &&
+        delta - rest >= ten_kappa &&
+        (rest + ten_kappa < distance || distance - rest > rest + ten_kappa - distance)
+    ) {
+        digits[length - 1] -= 1;
+        rest += ten_kappa;
+    }
+}
+
+/// Generate as few digits of the upper boundary as it takes to land
+/// within delta of it.  The value is digits * 10^k.
+static int generate_digits(DiyFp w, DiyFp upper, uint64_t delta, char *digits, int *k) {
+    DiyFp one = { 1ull << -upper.e, upper.e };
+    uint64_t distance = subtract(upper, w).f;
+    uint32_t integral = (uint32_t)(upper.f >> -one.e);
+    uint64_t fraction = upper.f & (one.f - 1);
+
+    int length = 0;
+    int kappa = count_digits(integral);
+    while (kappa > 0) {
+        uint32_t divisor = (uint32_t)POWERS_OF_10[kappa - 1];
+        uint32_t digit = integral / divisor;
+        integral %= divisor;
+        if (digit || length) digits[length++] = (char)('0' + digit);
+        kappa -= 1;
+
+        uint64_t rest = ((uint64_t)integral << -one.e) + fraction;
+        if (rest <= delta) {
+            *k += kappa;
+            round_digits(digits, length, delta, rest, POWERS_OF_10[kappa] << -one.e, distance);
+            return length;
+        }
+    }
+
+    while (true) {
+        fraction *= 10;
+        delta *= 10;
+        uint32_t digit = (uint32_t)(fraction >> -one.e);
+        if (digit || length) digits[length++] = (char)('0' + digit);
+        fraction &= one.f - 1;
+        kappa -= 1;
+
+        if (fraction < delta) {
+            *k += kappa;
+            int index = -kappa;
+            round_digits(digits, length, delta, fraction, one.f, index < 20 ? distance * POWERS_OF_10[index] : 0);
+            return length;
+        }
+    }
+}
+
+/// Find the shortest digits of a positive, finite double.  The value
+/// is digits * 10^k.
+static int grisu2(double value, char *digits, int *k) {
+    DiyFp v = diy_fp_of(value);
+    DiyFp minus, plus;
+    get_boundaries(v, &minus, &plus);
+
+    DiyFp power = get_cached_power(plus.e, k);
+    DiyFp w = multiply(normalize(v), power);
+    DiyFp upper = multiply(plus, power);
+    DiyFp lower = multiply(minus, power);
+
+    // Shrink the boundaries by one unit to make up for the rounding
+    // errors of the multiplications.
+    upper.f -= 1;
+    lower.f += 1;
+    return generate_digits(w, upper, upper.f - lower.f, digits, k);
+}
+
+
+/// Formatting
+/// ==========
+
+static size_t write_exponent(char *buffer, int exponent) {
+    size_t length = 0;
+    buffer[length++] = 'e';
+    buffer[length++] = exponent < 0 ? '-' : '+';
+    if (exponent < 0) exponent = -exponent;
+
+    // Like printf, exponents have at least two digits.
+    if (exponent >= 100) buffer[length++] = (char)('0' + exponent / 100);
+    buffer[length++] = (char)('0' + exponent / 10 % 10);
+    buffer[length++] = (char)('0' + exponent % 10);
+    return length;
+}
+
+size_t mt_dtoa(double value, char *buffer) {
+    size_t length = 0;
+    if (value != value) {
+        memcpy(buffer, "nan", 3);
+        return 3;
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (bits >> 63) {
+        buffer[length++] = '-';
+        value = -value;
+    }
+
+    if (value == 0) {
+        memcpy(buffer + length, "0.0", 3);
+        return length + 3;
+    }
+
+    if (value > 1.7976931348623157e308) {
+        memcpy(buffer + length, "inf", 3);
+        return length + 3;
+    }
+
+    char digits[20];
+    int k = 0;
+    int count = 0;
+
+    // Integral values are by far the most common and, up to 2^53,
+    // their digits are just those of the integer.
+    if (value < 9007199254740992.0 && value == (double)(uint64_t)value) {
+        uint64_t n = (uint64_t)value;
+        count = 20;
+        while (n > 0) {
+            digits[--count] = (char)('0' + n % 10);
+            n /= 10;
+        }
+
+        memmove(digits, digits + count, (size_t)(20 - count));
+        count = 20 - count;
+    } else {
+        count = grisu2(value, digits, &k);
+    }
+
+    // The position of the decimal point relative to the first digit.
+    int point = count + k;
+    int exponent = point - 1;
+    if (exponent >= -5 && exponent < 17) {
+        if (k >= 0) {
+            memcpy(buffer + length, digits, (size_t)count);
+            length += (size_t)count;
+            memset(buffer + length, '0', (size_t)k);
+            length += (size_t)k;
+            memcpy(buffer + length, ".0", 2);
+            return length + 2;
+        }
+
+        if (point > 0) {
+            memcpy(buffer + length, digits, (size_t)point);
+            length += (size_t)point;
+            buffer[length++] = '.';
+            memcpy(buffer + length, digits + point, (size_t)(count - point));
+            return length + (size_t)(count - point);
+        }
+
+        memcpy(buffer + length, "0.", 2);
+        length += 2;
+        memset(buffer + length, '0', (size_t)-point);
+        length += (size_t)-point;
+        memcpy(buffer + length, digits, (size_t)count);
+        return length + (size_t)count;
+    }
+
+    buffer[length++] = digits[0];
+    if (count > 1) {
+        buffer[length++] = '.';
+        memcpy(buffer + length, digits + 1, (size_t)(count - 1));
+        length += (size_t)(count - 1);
+    }
+
+    return length + write_exponent(buffer + length, exponent);
+}
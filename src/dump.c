@@ -0,0 +1,226 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dump.h"
+#include "parser.h"
+#include "scanner.h"
+#include "writer.h"
+
+static bool is_number(mt_NodeType type) {
+    return type == mt_NODE_INTEGER || type == mt_NODE_FLOAT;
+}
+
+static void write_number(mt_Writer *writer, mt_DumpNode *node) {
+    if (node->type == mt_NODE_INTEGER) {
+        mt_writer_write_int(writer, node->number.as_integer);
+    } else {
+        mt_writer_write_double(writer, node->number.as_double);
+    }
+}
+
+bool mt_dump_format_parse(char *name, mt_DumpFormat *format) {
+    if (strcmp(name, "text") == 0)   *format = mt_DUMP_TEXT;
+    else if (strcmp(name, "jsonl") == 0)  *format = mt_DUMP_JSONL;
+    else if (strcmp(name, "binary") == 0) *format = mt_DUMP_BINARY;
+    else return false;
+
+    return true;
+}
+
+void mt_dump_token(mt_Writer *writer, mt_DumpFormat format, mt_Token *token) {
+    // The EOF token spans the source's NUL terminator, which isn't
+    // part of the source.
+    size_t length = token->type == mt_TOKEN_EOF ? 0 : token->length;
+
+    switch (format) {
+    case mt_DUMP_TEXT:
+        mt_writer_write(writer, "Token(type='", 12);
+        mt_writer_write_string(writer, mt_token_type_name(token->type));
+        mt_writer_write(writer, "', value='", 10);
+        mt_writer_write(writer, token->start, length);
+        mt_writer_write(writer, "', line=", 8);
+        mt_writer_write_uint(writer, token->line);
+        mt_writer_write(writer, ", column=", 9);
+        mt_writer_write_uint(writer, token->column);
+        mt_writer_write(writer, ")\n", 2);
+        break;
+
+    case mt_DUMP_JSONL:
+        mt_writer_write(writer, "{\"type\":\"", 9);
+        // Skip the "TOKEN_" prefix.
+        mt_writer_write_string(writer, mt_token_type_name(token->type) + 6);
+        mt_writer_write(writer, "\",\"value\":", 10);
+        mt_writer_write_json_string(writer, token->start, length);
+        mt_writer_write(writer, ",\"line\":", 8);
+        mt_writer_write_uint(writer, token->line);
+        mt_writer_write(writer, ",\"column\":", 10);
+        mt_writer_write_uint(writer, token->column);
+        mt_writer_write(writer, "}\n", 2);
+        break;
+
+    case mt_DUMP_BINARY:
+        mt_writer_write_u8(writer, (uint8_t)token->type);
+        mt_writer_write_u32(writer, token->line);
+        mt_writer_write_u32(writer, token->column);
+        mt_writer_write_u32(writer, (uint32_t)length);
+        mt_writer_write(writer, token->start, length);
+        break;
+    }
+}
+
+void mt_dump_node_enter(mt_Writer *writer, mt_DumpFormat format, mt_DumpNode *node) {
+    switch (format) {
+    case mt_DUMP_TEXT:
+        mt_writer_write_repeat(writer, ' ', node->depth * 2);
+        mt_writer_write_string(writer, mt_node_type_name(node->type));
+        if (node->type == mt_NODE_MODULE) {
+            mt_writer_write(writer, "(\n", 2);
+            break;
+        }
+
+        mt_writer_write_char(writer, '(');
+        if (is_number(node->type)) {
+            write_number(writer, node);
+        } else {
+            if (node->type == mt_NODE_STRING) mt_writer_write_char(writer, '"');
+            mt_writer_write(writer, node->value, node->length);
+            if (node->type == mt_NODE_STRING) mt_writer_write_char(writer, '"');
+        }
+        mt_writer_write_char(writer, ')');
+        break;
+
+    case mt_DUMP_JSONL:
+        mt_writer_write(writer, "{\"id\":", 6);
+        mt_writer_write_uint(writer, node->id);
+        mt_writer_write(writer, ",\"parent\":", 10);
+        if (node->parent == mt_DUMP_NO_PARENT) {
+            mt_writer_write(writer, "null", 4);
+        } else {
+            mt_writer_write_uint(writer, node->parent);
+        }
+        mt_writer_write(writer, ",\"type\":\"", 9);
+        mt_writer_write_string(writer, mt_node_type_name(node->type));
+        mt_writer_write_char(writer, '"');
+        if (is_number(node->type)) {
+            mt_writer_write(writer, ",\"value\":", 9);
+            write_number(writer, node);
+        } else if (node->value) {
+            mt_writer_write(writer, ",\"value\":", 9);
+            mt_writer_write_json_string(writer, node->value, node->length);
+        }
+        mt_writer_write(writer, ",\"line\":", 8);
+        mt_writer_write_uint(writer, node->line);
+        mt_writer_write(writer, ",\"column\":", 10);
+        mt_writer_write_uint(writer, node->column);
+        mt_writer_write(writer, "}\n", 2);
+        break;
+
+    case mt_DUMP_BINARY:
+        mt_writer_write_u8(writer, (uint8_t)node->type);
+        mt_writer_write_u32(writer, node->line);
+        mt_writer_write_u32(writer, node->column);
+        if (node->type == mt_NODE_MODULE) {
+            mt_writer_write_u32(writer, node->children);
+        } else if (node->type == mt_NODE_INTEGER) {
+            mt_writer_write_u32(writer, 8);
+            mt_writer_write_u64(writer, (uint64_t)node->number.as_integer);
+        } else if (node->type == mt_NODE_FLOAT) {
+            uint64_t bits;
+            memcpy(&bits, &node->number.as_double, sizeof(bits));
+            mt_writer_write_u32(writer, 8);
+            mt_writer_write_u64(writer, bits);
+        } else {
+            mt_writer_write_u32(writer, (uint32_t)node->length);
+            mt_writer_write(writer, node->value, node->length);
+        }
+        break;
+    }
+}
+
+void mt_dump_node_leave(mt_Writer *writer, mt_DumpFormat format, mt_DumpNode *node) {
+    if (format != mt_DUMP_TEXT) return;
+
+    if (node->type == mt_NODE_MODULE) mt_writer_write_char(writer, ')');
+    if (node->depth == 0) {
+        mt_writer_write_char(writer, '\n');
+    } else {
+        mt_writer_write(writer, ",\n", 2);
+    }
+}
+
+typedef struct {
+    mt_DumpNode node;
+    mt_NodeList *next;  ///< the next child to dump
+} Frame;
+
+static void enter_node(mt_Writer *writer, mt_DumpFormat format, Frame *frame, mt_Node *node, uint32_t id, uint32_t parent, uint32_t depth) {
+    mt_DumpNode *dump = &frame->node;
+    dump->type = node->type;
+    dump->line = node->line;
+    dump->column = node->column;
+    dump->value = NULL;
+    dump->length = 0;
+    dump->number.as_integer = 0;
+    dump->children = 0;
+    dump->id = id;
+    dump->parent = parent;
+    dump->depth = depth;
+    frame->next = NULL;
+
+    if (node->type == mt_NODE_MODULE) {
+        frame->next = node->value.as_node_list;
+        for (mt_NodeList *head = frame->next; head; head = head->next) {
+            dump->children += 1;
+        }
+    } else if (is_number(node->type)) {
+        dump->number = node->value;
+    } else {
+        dump->value = mt_string_data(&node->value.as_string);
+        dump->length = node->value.as_string.length;
+    }
+
+    mt_dump_node_enter(writer, format, dump);
+}
+
+bool mt_dump_tree(mt_Writer *writer, mt_DumpFormat format, mt_Node *tree) {
+    Frame inline_stack[32];
+    Frame *stack = inline_stack;
+    size_t capacity = sizeof(inline_stack) / sizeof(inline_stack[0]);
+    size_t depth = 1;
+    uint32_t next_id = 1;
+
+    enter_node(writer, format, &stack[0], tree, 0, mt_DUMP_NO_PARENT, 0);
+    while (depth > 0) {
+        Frame *frame = &stack[depth - 1];
+        if (!frame->next) {
+            mt_dump_node_leave(writer, format, &frame->node);
+            depth -= 1;
+            continue;
+        }
+
+        mt_Node *child = frame->next->value;
+        frame->next = frame->next->next;
+
+        if (depth == capacity) {
+            Frame *new_stack = malloc(sizeof(Frame) * capacity * 2);
+            if (!new_stack) {
+                if (stack != inline_stack) free(stack);
+                return false;
+            }
+
+            memcpy(new_stack, stack, sizeof(Frame) * capacity);
+            if (stack != inline_stack) free(stack);
+            stack = new_stack;
+            capacity *= 2;
+            frame = &stack[depth - 1];
+        }
+
+        enter_node(writer, format, &stack[depth], child, next_id++, frame->node.id, (uint32_t)depth);
+        depth += 1;
+    }
+
+    if (stack != inline_stack) free(stack);
+    return true;
+}
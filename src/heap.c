@@ -0,0 +1,175 @@
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "heap.h"
+
+/// Tracked allocations are prefixed with a header that points back to
+/// their counters.  It is padded so the memory that follows it is
+/// suitably aligned for anything.
+typedef union {
+    struct {
+        mt_HeapCounter *site;
+        mt_HeapCounter *kind;
+        size_t size;
+    } info;
+    max_align_t align;
+} Header;
+
+static bool enabled = false;
+static const char *snapshot_path = NULL;
+static volatile sig_atomic_t snapshot_requested = 0;
+static uint32_t snapshot_count = 0;
+
+static mt_HeapCounter *counters = NULL;
+
+static void on_sigusr1(int signal) {
+    (void)signal;
+    snapshot_requested = 1;
+}
+
+bool mt_heap_profile_start(const char *path) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_sigusr1;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGUSR1, &action, NULL) != 0) return false;
+
+    snapshot_path = path;
+    enabled = true;
+    return true;
+}
+
+
+/// Counting
+/// ========
+
+static void register_counter(mt_HeapCounter *counter) {
+    int expected = 0;
+    if (!__atomic_compare_exchange_n(&counter->registered, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return;
+
+    mt_HeapCounter *head = __atomic_load_n(&counters, __ATOMIC_ACQUIRE);
+    do {
+        counter->next = head;
+    } while (!__atomic_compare_exchange_n(&counters, &head, counter, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+}
+
+static void count(mt_HeapCounter *counter, int64_t n, int64_t bytes) {
+    __atomic_fetch_add(&counter->live_count, (uint64_t)n, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counter->live_bytes, (uint64_t)bytes, __ATOMIC_RELAXED);
+    if (n > 0) {
+        __atomic_fetch_add(&counter->total_count, (uint64_t)n, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&counter->total_bytes, (uint64_t)bytes, __ATOMIC_RELAXED);
+    }
+}
+
+/// Write a snapshot if one was requested since the last one.  This
+/// runs outside of the signal handler since writing files isn't
+/// async-signal-safe.  Threads race to claim the request, so each
+/// signal produces exactly one snapshot with a number of its own.
+static void write_requested_snapshot() {
+    if (!__atomic_exchange_n(&snapshot_requested, 0, __ATOMIC_ACQ_REL)) return;
+
+    char path[4096];
+    uint32_t number = __atomic_add_fetch(&snapshot_count, 1, __ATOMIC_RELAXED);
+    snprintf(path, sizeof(path), "%s.%u", snapshot_path, number);
+
+    FILE *out = fopen(path, "w");
+    if (!out) return;
+
+    mt_heap_profile_write(out);
+    fclose(out);
+}
+
+void *mt_heap_alloc(mt_HeapCounter *site, mt_HeapCounter *kind, size_t size) {
+    if (!enabled) return malloc(size);
+    if (snapshot_requested) write_requested_snapshot();
+
+    Header *header = malloc(sizeof(Header) + size);
+    if (!header) return NULL;
+
+    register_counter(site);
+    count(site, 1, (int64_t)size);
+    if (kind) {
+        register_counter(kind);
+        count(kind, 1, (int64_t)size);
+    }
+
+    header->info.site = site;
+    header->info.kind = kind;
+    header->info.size = size;
+    return header + 1;
+}
+
+void mt_heap_free(void *data) {
+    if (!enabled || !data) {
+        free(data);
+        return;
+    }
+
+    Header *header = (Header *)data - 1;
+    count(header->info.site, -1, -(int64_t)header->info.size);
+    if (header->info.kind) count(header->info.kind, -1, -(int64_t)header->info.size);
+    free(header);
+}
+
+
+/// Snapshots
+/// =========
+
+static int compare_counters(const void *a, const void *b) {
+    const mt_HeapCounter *x = *(const mt_HeapCounter **)a;
+    const mt_HeapCounter *y = *(const mt_HeapCounter **)b;
+
+    // Sites, which have a file, sort before kinds.
+    if (!x->file != !y->file) return x->file ? -1 : 1;
+    if (x->file) {
+        int files = strcmp(x->file, y->file);
+        if (files != 0) return files;
+        if (x->line != y->line) return x->line < y->line ? -1 : 1;
+    }
+
+    return strcmp(x->name, y->name);
+}
+
+bool mt_heap_profile_write(FILE *out) {
+    size_t ncounters = 0;
+    mt_HeapCounter *head = __atomic_load_n(&counters, __ATOMIC_ACQUIRE);
+    for (mt_HeapCounter *counter = head; counter; counter = counter->next) ncounters++;
+
+    mt_HeapCounter **sorted = malloc(sizeof(mt_HeapCounter *) * (ncounters + 1));
+    if (!sorted) return false;
+
+    size_t i = 0;
+    for (mt_HeapCounter *counter = head; counter && i < ncounters; counter = counter->next) sorted[i++] = counter;
+    qsort(sorted, ncounters, sizeof(mt_HeapCounter *), compare_counters);
+
+    bool ok = fprintf(out, "# monty heap snapshot v1\n# site|kind live_count live_bytes total_count total_bytes name location\n") >= 0;
+    for (i = 0; ok && i < ncounters; i++) {
+        mt_HeapCounter *counter = sorted[i];
+        int written = fprintf(
+            out,
+            "%s %llu %llu %llu %llu %s ",
+            counter->file ? "site" : "kind",
+            (unsigned long long)__atomic_load_n(&counter->live_count, __ATOMIC_RELAXED),
+            (unsigned long long)__atomic_load_n(&counter->live_bytes, __ATOMIC_RELAXED),
+            (unsigned long long)__atomic_load_n(&counter->total_count, __ATOMIC_RELAXED),
+            (unsigned long long)__atomic_load_n(&counter->total_bytes, __ATOMIC_RELAXED),
+            counter->name
+        );
+
+        if (written >= 0) {
+            written = counter->file ? fprintf(out, "%s:%u\n", counter->file, counter->line) : fprintf(out, "-\n");
+        }
+
+        ok = written >= 0;
+    }
+
+    free(sorted);
+    return ok;
+}
@@ -0,0 +1,296 @@
+// For accept4.
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "io.h"
+
+mt_IoLoop *mt_io_loop_init() {
+    mt_IoLoop *loop = calloc(1, sizeof(mt_IoLoop));
+    if (!loop) return NULL;
+
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epoll_fd < 0) {
+        free(loop);
+        return NULL;
+    }
+
+    return loop;
+}
+
+static void free_requests(mt_IoRequest *request) {
+    while (request) {
+        mt_IoRequest *next = request->next;
+        free(request);
+        request = next;
+    }
+}
+
+static void restore_flags(int fd, mt_IoWaiters *waiters) {
+    if (!waiters->nonblocking) return;
+
+    fcntl(fd, F_SETFL, waiters->flags);
+    waiters->nonblocking = false;
+}
+
+void mt_io_loop_free(mt_IoLoop *loop) {
+    for (int fd = 0; fd < loop->waiter_capacity; fd++) {
+        free_requests(loop->waiters[fd].readers);
+        free_requests(loop->waiters[fd].writers);
+        restore_flags(fd, &loop->waiters[fd]);
+    }
+
+    free_requests(loop->ready);
+    close(loop->epoll_fd);
+    free(loop->waiters);
+    free(loop);
+}
+
+
+/// Submitting
+/// ==========
+
+static mt_IoWaiters *get_waiters(mt_IoLoop *loop, int fd) {
+    if (fd >= loop->waiter_capacity) {
+        int new_capacity = loop->waiter_capacity ? loop->waiter_capacity : 64;
+        while (new_capacity <= fd) new_capacity *= 2;
+
+        mt_IoWaiters *new_waiters = realloc(loop->waiters, sizeof(mt_IoWaiters) * new_capacity);
+        if (!new_waiters) return NULL;
+
+        memset(new_waiters + loop->waiter_capacity, 0, sizeof(mt_IoWaiters) * (new_capacity - loop->waiter_capacity));
+        loop->waiters = new_waiters;
+        loop->waiter_capacity = new_capacity;
+    }
+
+    return &loop->waiters[fd];
+}
+
+static void push_ready(mt_IoLoop *loop, mt_IoRequest *request) {
+    request->next = NULL;
+    if (loop->ready_tail) {
+        loop->ready_tail->next = request;
+    } else {
+        loop->ready = request;
+    }
+
+    loop->ready_tail = request;
+}
+
+static bool submit(mt_IoLoop *loop, mt_IoOperation operation, int fd, char *buffer, size_t length, mt_IoCallback callback, void *data) {
+    mt_IoWaiters *waiters = fd >= 0 ? get_waiters(loop, fd) : NULL;
+    if (!waiters) return false;
+
+    mt_IoRequest *request = malloc(sizeof(mt_IoRequest));
+    if (!request) return false;
+
+    if (waiters->pending == 0) {
+        int flags = fcntl(fd, F_GETFL);
+        if (flags >= 0 && !(flags & O_NONBLOCK) && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0) {
+            waiters->flags = flags;
+            waiters->nonblocking = true;
+        }
+    }
+
+    request->operation = operation;
+    request->fd = fd;
+    request->buffer = buffer;
+    request->length = length;
+    request->result = 0;
+    request->error = 0;
+    request->callback = callback;
+    request->data = data;
+
+    // Requests are only attempted from mt_io_run, so callbacks never
+    // run from inside the call that submitted them.
+    push_ready(loop, request);
+    loop->pending += 1;
+    waiters->pending += 1;
+    return true;
+}
+
+bool mt_io_read(mt_IoLoop *loop, int fd, char *buffer, size_t length, mt_IoCallback callback, void *data) {
+    return submit(loop, mt_IO_READ, fd, buffer, length, callback, data);
+}
+
+bool mt_io_write(mt_IoLoop *loop, int fd, const char *buffer, size_t length, mt_IoCallback callback, void *data) {
+    return submit(loop, mt_IO_WRITE, fd, (char *)buffer, length, callback, data);
+}
+
+bool mt_io_accept(mt_IoLoop *loop, int fd, mt_IoCallback callback, void *data) {
+    return submit(loop, mt_IO_ACCEPT, fd, NULL, 0, callback, data);
+}
+
+
+/// Running
+/// =======
+
+typedef enum {
+    ATTEMPT_DONE,
+    ATTEMPT_WAIT,  ///< the fd isn't ready
+} Attempt;
+
+static Attempt attempt(mt_IoRequest *request) {
+    ssize_t n;
+    switch (request->operation) {
+    case mt_IO_READ:
+        n = read(request->fd, request->buffer, request->length);
+        break;
+
+    case mt_IO_WRITE:
+        // Writes keep going until the whole buffer is out, so result
+        // counts what's been written so far.
+        n = write(request->fd, request->buffer + request->result, request->length - (size_t)request->result);
+        if (n >= 0) {
+            request->result += n;
+            return (size_t)request->result == request->length ? ATTEMPT_DONE : ATTEMPT_WAIT;
+        }
+        break;
+
+    case mt_IO_ACCEPT:
+        n = accept4(request->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        break;
+
+    default:
+        n = -1;
+        errno = EINVAL;
+        break;
+    }
+
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return ATTEMPT_WAIT;
+
+    request->result = n < 0 ? -1 : n;
+    request->error = n < 0 ? errno : 0;
+    return ATTEMPT_DONE;
+}
+
+static mt_IoRequest **queue_of(mt_IoWaiters *waiters, mt_IoRequest *request) {
+    return request->operation == mt_IO_WRITE ? &waiters->writers : &waiters->readers;
+}
+
+/// Make the fd's epoll registration match the requests waiting on it.
+/// Returns false if the fd can't be waited on, which is the case for
+/// regular files.
+static bool update_registration(mt_IoLoop *loop, int fd, mt_IoWaiters *waiters) {
+    uint32_t events = (waiters->readers ? EPOLLIN : 0) | (waiters->writers ? EPOLLOUT : 0);
+    if (events == waiters->events && waiters->registered) return true;
+
+    struct epoll_event event = { .events = events, .data.fd = fd };
+    int op = !waiters->registered ? EPOLL_CTL_ADD : events ? EPOLL_CTL_MOD : EPOLL_CTL_DEL;
+    if (op == EPOLL_CTL_ADD && !events) return true;
+    if (epoll_ctl(loop->epoll_fd, op, fd, &event) != 0) {
+        // Closing an fd drops its registration behind the loop's back.
+        if (errno != ENOENT && errno != EBADF) return false;
+        if (op == EPOLL_CTL_MOD && epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) return false;
+    }
+
+    waiters->registered = op != EPOLL_CTL_DEL;
+    waiters->events = events;
+    return true;
+}
+
+static void complete(mt_IoLoop *loop, mt_IoRequest *request) {
+    loop->pending -= 1;
+
+    // The fd's flags and registration are reset before the callback
+    // runs since it may close the fd, after which its number could
+    // belong to another file.
+    mt_IoWaiters *waiters = &loop->waiters[request->fd];
+    waiters->pending -= 1;
+    if (waiters->pending == 0) {
+        restore_flags(request->fd, waiters);
+        if (waiters->registered) epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, request->fd, NULL);
+        waiters->registered = false;
+        waiters->events = 0;
+    }
+
+    if (request->callback) request->callback(loop, request);
+    free(request);
+}
+
+/// Attempt every ready request in order.  Requests on an fd that
+/// already has requests waiting go to the back of its queue so they
+/// can't overtake them.
+static void run_ready(mt_IoLoop *loop) {
+    mt_IoRequest *request = loop->ready;
+    loop->ready = NULL;
+    loop->ready_tail = NULL;
+
+    while (request) {
+        mt_IoRequest *next = request->next;
+        mt_IoWaiters *waiters = &loop->waiters[request->fd];
+        mt_IoRequest **queue = queue_of(waiters, request);
+
+        if (!*queue && attempt(request) == ATTEMPT_DONE) {
+            complete(loop, request);
+            request = next;
+            continue;
+        }
+
+        mt_IoRequest **tail = queue;
+        while (*tail) tail = &(*tail)->next;
+        request->next = NULL;
+        *tail = request;
+
+        // epoll can't wait on regular files, but reading or writing
+        // them never blocks for long, so they're just tried again on
+        // the next turn.
+        if (!update_registration(loop, request->fd, waiters)) {
+            *tail = NULL;
+            push_ready(loop, request);
+        }
+
+        request = next;
+    }
+}
+
+/// Serve the requests waiting on an fd that just became ready, in
+/// order, until one of them would block.  Callbacks may submit
+/// requests on new fds, which can move the waiters, so the queue is
+/// looked up again after every one.
+static void run_waiters(mt_IoLoop *loop, int fd, bool writers) {
+    while (true) {
+        mt_IoRequest **queue = writers ? &loop->waiters[fd].writers : &loop->waiters[fd].readers;
+        mt_IoRequest *request = *queue;
+        if (!request || attempt(request) == ATTEMPT_WAIT) break;
+
+        *queue = request->next;
+        complete(loop, request);
+    }
+}
+
+bool mt_io_run(mt_IoLoop *loop) {
+    struct epoll_event events[mt_IO_BATCH_SIZE];
+
+    while (loop->pending > 0) {
+        run_ready(loop);
+        if (loop->pending == 0) break;
+        if (loop->ready) continue;
+
+        int count = epoll_wait(loop->epoll_fd, events, mt_IO_BATCH_SIZE, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+
+            // Errors and hangups wake up every waiter so they can see
+            // the error or EOF for themselves.
+            uint32_t ready = events[i].events;
+            if (ready & (EPOLLIN | EPOLLERR | EPOLLHUP)) run_waiters(loop, fd, false);
+            if (ready & (EPOLLOUT | EPOLLERR | EPOLLHUP)) run_waiters(loop, fd, true);
+            update_registration(loop, fd, &loop->waiters[fd]);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,107 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "list.h"
+
+#define LIST_MIN_CAPACITY 8
+
+uint32_t mt_list_element_size(mt_TypeTag type) {
+    switch (type) {
+    case mt_TYPE_INTEGER:
+        return sizeof(int64_t);
+    case mt_TYPE_FLOAT:
+        return sizeof(double);
+    default:
+        return sizeof(void *);
+    }
+}
+
+mt_List *mt_list_init(mt_TypeTag element_type) {
+    mt_List *list = calloc(1, sizeof(mt_List));
+    if (!list) return NULL;
+
+    list->element_type = element_type;
+    list->element_size = mt_list_element_size(element_type);
+    return list;
+}
+
+bool mt_list_reserve(mt_List *list, uint32_t capacity) {
+    if (capacity <= list->capacity) return true;
+
+    char *elements = realloc(list->elements, (size_t)capacity * list->element_size);
+    if (!elements) return false;
+
+    list->elements = elements;
+    list->capacity = capacity;
+    return true;
+}
+
+static bool grow(mt_List *list) {
+    if (list->length < list->capacity) return true;
+    if (list->capacity > UINT32_MAX / 2) return false;
+    return mt_list_reserve(list, list->capacity ? list->capacity * 2 : LIST_MIN_CAPACITY);
+}
+
+bool mt_list_push(mt_List *list, const void *element) {
+    if (!grow(list)) return false;
+
+    memcpy(list->elements + (size_t)list->length * list->element_size, element, list->element_size);
+    list->length += 1;
+    return true;
+}
+
+// The typed pushes skip the memcpy so appending to an unboxed List
+// is a single store.
+bool mt_list_push_integer(mt_List *list, int64_t element) {
+    if (!grow(list)) return false;
+
+    ((int64_t *)list->elements)[list->length++] = element;
+    return true;
+}
+
+bool mt_list_push_float(mt_List *list, double element) {
+    if (!grow(list)) return false;
+
+    ((double *)list->elements)[list->length++] = element;
+    return true;
+}
+
+bool mt_list_push_pointer(mt_List *list, void *element) {
+    if (!grow(list)) return false;
+
+    ((void **)list->elements)[list->length++] = element;
+    return true;
+}
+
+void *mt_list_at(const mt_List *list, uint32_t index) {
+    if (index >= list->length) return NULL;
+    return list->elements + (size_t)index * list->element_size;
+}
+
+bool mt_list_pop(mt_List *list, void *element) {
+    if (list->length == 0) return false;
+
+    list->length -= 1;
+    if (element) memcpy(element, list->elements + (size_t)list->length * list->element_size, list->element_size);
+    return true;
+}
+
+mt_ListIterator mt_list_iter(const mt_List *list) {
+    return (mt_ListIterator){ .list = list, .index = 0 };
+}
+
+bool mt_list_has_more(const mt_ListIterator *iterator) {
+    return iterator->index < iterator->list->length;
+}
+
+void *mt_list_get_next(mt_ListIterator *iterator) {
+    const mt_List *list = iterator->list;
+    return list->elements + (size_t)iterator->index++ * list->element_size;
+}
+
+void mt_list_free(mt_List *list) {
+    free(list->elements);
+    free(list);
+}
@@ -0,0 +1,443 @@
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "common.h"
+#include "loader.h"
+#include "parser.h"
+#include "resolver.h"
+#include "str.h"
+
+/// Modules
+/// =======
+
+static void module_free(mt_Module *module) {
+    if (module->parser) mt_parser_free(module->parser);
+    if (module->cache) mt_ast_cache_close(module->cache);
+    mt_resolver_free(module->resolver);
+    free(module->imports);
+    free(module->source);
+    free(module->path);
+    free(module);
+}
+
+static bool module_error(mt_Module *module, uint32_t line, uint32_t column, const char *message) {
+    snprintf(module->error, LOADER_ERROR_LENGTH, "%s:%u:%u: %s", module->path, line, column, message);
+    return false;
+}
+
+/// Find the slot of a module in the loader's table, or the empty slot
+/// it would go in.
+static mt_Module **find_module(mt_Loader *loader, const char *path) {
+    uint32_t mask = loader->module_capacity - 1;
+    uint32_t slot = mt_string_hash(path, strlen(path)) & mask;
+    while (loader->modules[slot] && strcmp(loader->modules[slot]->path, path) != 0) {
+        slot = (slot + 1) & mask;
+    }
+
+    return &loader->modules[slot];
+}
+
+static bool grow_modules(mt_Loader *loader) {
+    mt_Module **old_modules = loader->modules;
+    uint32_t old_capacity = loader->module_capacity;
+    uint32_t new_capacity = old_capacity ? old_capacity * 2 : 16;
+
+    mt_Module **new_modules = calloc(new_capacity, sizeof(mt_Module *));
+    if (!new_modules) return false;
+
+    loader->modules = new_modules;
+    loader->module_capacity = new_capacity;
+    for (uint32_t i = 0; i < old_capacity; i++) {
+        if (old_modules[i]) *find_module(loader, old_modules[i]->path) = old_modules[i];
+    }
+
+    free(old_modules);
+    return true;
+}
+
+static bool enqueue(mt_Loader *loader, mt_Module *module) {
+    if (loader->queue_length == loader->queue_capacity) {
+        uint32_t new_capacity = loader->queue_capacity ? loader->queue_capacity * 2 : 16;
+        mt_Module **new_queue = malloc(sizeof(mt_Module *) * new_capacity);
+        if (!new_queue) return false;
+
+        for (uint32_t i = 0; i < loader->queue_length; i++) {
+            new_queue[i] = loader->queue[(loader->queue_start + i) % loader->queue_capacity];
+        }
+
+        free(loader->queue);
+        loader->queue = new_queue;
+        loader->queue_start = 0;
+        loader->queue_capacity = new_capacity;
+    }
+
+    loader->queue[(loader->queue_start + loader->queue_length) % loader->queue_capacity] = module;
+    loader->queue_length += 1;
+    loader->pending += 1;
+    pthread_cond_signal(&loader->work);
+    return true;
+}
+
+/// Look up the module at a canonical path, queueing it to be loaded
+/// if this is the first time it's been seen.  Takes ownership of
+/// path.  Must be called with the loader's lock held.
+static mt_Module *intern_module(mt_Loader *loader, char *path) {
+    if (loader->module_count * 2 >= loader->module_capacity && !grow_modules(loader)) {
+        free(path);
+        return NULL;
+    }
+
+    mt_Module **slot = find_module(loader, path);
+    if (*slot) {
+        free(path);
+        return *slot;
+    }
+
+    mt_Module *module = calloc(1, sizeof(mt_Module));
+    if (!module) {
+        free(path);
+        return NULL;
+    }
+
+    module->path = path;
+    module->state = mt_MODULE_QUEUED;
+    if (!enqueue(loader, module)) {
+        module_free(module);
+        return NULL;
+    }
+
+    *slot = module;
+    loader->module_count += 1;
+    return module;
+}
+
+
+/// Loading
+/// =======
+
+static bool parse_module(mt_Loader *loader, mt_Module *module) {
+    module->source = mt_read_entire_file(module->path);
+    if (!module->source) return module_error(module, 0, 0, "could not read file");
+
+    module->source_hash = mt_hash_source(module->source, strlen(module->source));
+    module->parser = mt_parser_init(module->path, module->source);
+    if (!module->parser) return module_error(module, 0, 0, "not enough memory");
+
+    mt_Parser *parser = module->parser;
+    module->declarations = mt_parser_skim(parser);
+    if (!module->declarations) return module_error(module, parser->error_line, parser->error_column, parser->error);
+
+    char *cache_path = NULL;
+    if (loader->use_cache) {
+        cache_path = mt_ast_cache_path(module->path, module->source_hash);
+        module->cache = cache_path ? mt_ast_cache_open(cache_path, module->source_hash) : NULL;
+        if (module->cache && !mt_ast_cache_validate(module->cache)) {
+            mt_ast_cache_close(module->cache);
+            module->cache = NULL;
+        }
+
+        if (module->cache) {
+            free(cache_path);
+            return true;
+        }
+    }
+
+    // The parser only handles a subset of the language so far, while
+    // imports only need the declarations, so modules it can't handle
+    // are still loaded.  Their parse error is kept around for when
+    // their tree is needed.
+    module->tree = mt_parser_parse(parser);
+    if (!module->tree) {
+        free(cache_path);
+        module_error(module, parser->error_line, parser->error_column, parser->error);
+        return true;
+    }
+
+    module->resolver = mt_resolver_init();
+    if (!module->resolver) {
+        free(cache_path);
+        return module_error(module, 0, 0, "not enough memory");
+    }
+
+    mt_Resolver *resolver = module->resolver;
+    if (!mt_resolver_resolve(resolver, module->tree, module->declarations)) {
+        free(cache_path);
+        return module_error(module, resolver->error_line, resolver->error_column, resolver->error);
+    }
+
+    // Failing to write the cache is fine, it just means the module
+    // will have to be parsed again next time.
+    if (cache_path) mt_ast_cache_write(cache_path, module->source_hash, module->tree);
+    free(cache_path);
+    return true;
+}
+
+/// Find the file an import refers to.  Returns its canonical path,
+/// which the caller is expected to free, or NULL if there is none.
+static char *find_import(mt_Loader *loader, mt_Module *module, mt_Declaration *declaration) {
+    char relative[PATH_MAX];
+    size_t length = declaration->name_length + strlen(mt_MODULE_EXTENSION);
+    if (length >= sizeof(relative)) return NULL;
+
+    for (size_t i = 0; i < declaration->name_length; i++) {
+        relative[i] = declaration->name[i] == '.' ? '/' : declaration->name[i];
+    }
+    strcpy(relative + declaration->name_length, mt_MODULE_EXTENSION);
+
+    char candidate[PATH_MAX];
+    const char *separator = strrchr(module->path, '/');
+    int directory_length = separator ? (int)(separator - module->path) : 0;
+    for (uint32_t i = 0; i <= loader->search_path_count; i++) {
+        int written = i == 0
+            ? snprintf(candidate, sizeof(candidate), "%.*s/%s", directory_length, module->path, relative)
+            : snprintf(candidate, sizeof(candidate), "%s/%s", loader->search_paths[i - 1], relative);
+        if (written < 0 || (size_t)written >= sizeof(candidate)) continue;
+
+        char *path = realpath(candidate, NULL);
+        if (path) return path;
+    }
+
+    return NULL;
+}
+
+/// Resolve every import of a module and queue the ones that haven't
+/// been seen yet.  Imports are resolved outside of the loader's lock
+/// since that touches the file system.
+static bool link_imports(mt_Loader *loader, mt_Module *module) {
+    mt_DeclarationList *list = module->declarations;
+    uint32_t count = 0;
+    for (size_t i = 0; i < list->length; i++) {
+        if (list->declarations[i].type == mt_DECLARATION_IMPORT) count += 1;
+    }
+
+    if (count == 0) return true;
+
+    char **paths = calloc(count, sizeof(char *));
+    module->imports = calloc(count, sizeof(mt_Module *));
+    if (!paths || !module->imports) {
+        free(paths);
+        return module_error(module, 0, 0, "not enough memory");
+    }
+
+    bool ok = true;
+    uint32_t n = 0;
+    for (size_t i = 0; ok && i < list->length; i++) {
+        mt_Declaration *declaration = &list->declarations[i];
+        if (declaration->type != mt_DECLARATION_IMPORT) continue;
+
+        paths[n] = find_import(loader, module, declaration);
+        if (!paths[n]) {
+            char message[LOADER_ERROR_LENGTH];
+            snprintf(message, sizeof(message), "could not find module '%.*s'", (int)declaration->name_length, declaration->name);
+            ok = module_error(module, declaration->line, declaration->column, message);
+        }
+
+        n += 1;
+    }
+
+    pthread_mutex_lock(&loader->lock);
+    for (uint32_t i = 0; i < n; i++) {
+        if (!ok || !paths[i]) {
+            free(paths[i]);
+            continue;
+        }
+
+        module->imports[i] = intern_module(loader, paths[i]);
+        if (!module->imports[i]) ok = module_error(module, 0, 0, "not enough memory");
+        module->import_count += module->imports[i] ? 1 : 0;
+    }
+    pthread_mutex_unlock(&loader->lock);
+
+    free(paths);
+    return ok;
+}
+
+static void load_module(mt_Loader *loader, mt_Module *module) {
+    bool ok = parse_module(loader, module) && link_imports(loader, module);
+
+    pthread_mutex_lock(&loader->lock);
+    module->state = ok ? mt_MODULE_LOADED : mt_MODULE_FAILED;
+    loader->pending -= 1;
+    if (loader->pending == 0) pthread_cond_broadcast(&loader->idle);
+    pthread_mutex_unlock(&loader->lock);
+}
+
+static void *run_worker(void *data) {
+    mt_Loader *loader = data;
+
+    pthread_mutex_lock(&loader->lock);
+    while (true) {
+        while (!loader->stopping && loader->queue_length == 0) {
+            pthread_cond_wait(&loader->work, &loader->lock);
+        }
+
+        if (loader->stopping) break;
+
+        mt_Module *module = loader->queue[loader->queue_start];
+        loader->queue_start = (loader->queue_start + 1) % loader->queue_capacity;
+        loader->queue_length -= 1;
+
+        pthread_mutex_unlock(&loader->lock);
+        load_module(loader, module);
+        pthread_mutex_lock(&loader->lock);
+    }
+    pthread_mutex_unlock(&loader->lock);
+
+    return NULL;
+}
+
+
+/// Loader
+/// ======
+
+static void stop_threads(mt_Loader *loader) {
+    pthread_mutex_lock(&loader->lock);
+    loader->stopping = true;
+    pthread_cond_broadcast(&loader->work);
+    pthread_mutex_unlock(&loader->lock);
+
+    for (uint32_t i = 0; i < loader->thread_count; i++) {
+        pthread_join(loader->threads[i], NULL);
+    }
+
+    loader->thread_count = 0;
+}
+
+mt_Loader *mt_loader_init(uint32_t threads) {
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+
+    if (threads > mt_LOADER_MAX_THREADS) threads = mt_LOADER_MAX_THREADS;
+
+    mt_Loader *loader = calloc(1, sizeof(mt_Loader));
+    if (!loader) return NULL;
+
+    loader->use_cache = true;
+    pthread_mutex_init(&loader->lock, NULL);
+    pthread_cond_init(&loader->work, NULL);
+    pthread_cond_init(&loader->idle, NULL);
+
+    for (; loader->thread_count < threads; loader->thread_count++) {
+        if (pthread_create(&loader->threads[loader->thread_count], NULL, run_worker, loader) != 0) goto fail;
+    }
+
+    return loader;
+
+fail:
+    mt_loader_free(loader);
+    return NULL;
+}
+
+bool mt_loader_add_search_path(mt_Loader *loader, const char *path) {
+    char **search_paths = realloc(loader->search_paths, sizeof(char *) * (loader->search_path_count + 1));
+    if (!search_paths) return false;
+
+    loader->search_paths = search_paths;
+    loader->search_paths[loader->search_path_count] = strdup(path);
+    if (!loader->search_paths[loader->search_path_count]) return false;
+
+    loader->search_path_count += 1;
+    return true;
+}
+
+/// Find the first module reachable from root that failed to load, in
+/// the order imports are declared, so the same error is reported no
+/// matter which thread loaded what first.
+static mt_Module *find_failure(mt_Loader *loader, mt_Module *root, bool *ok) {
+    mt_Module **stack = malloc(sizeof(mt_Module *) * loader->module_count);
+    mt_Module **visited = calloc(loader->module_capacity, sizeof(mt_Module *));
+    mt_Module *failed = NULL;
+    *ok = stack && visited;
+    if (!*ok) goto done;
+
+    uint32_t depth = 0;
+    stack[depth++] = root;
+    visited[find_module(loader, root->path) - loader->modules] = root;
+    while (depth > 0 && !failed) {
+        mt_Module *module = stack[--depth];
+        if (module->state == mt_MODULE_FAILED) {
+            failed = module;
+            break;
+        }
+
+        // Push imports in reverse so the first one is visited first.
+        for (uint32_t i = module->import_count; i > 0; i--) {
+            mt_Module *import = module->imports[i - 1];
+            size_t slot = (size_t)(find_module(loader, import->path) - loader->modules);
+            if (visited[slot]) continue;
+
+            visited[slot] = import;
+            stack[depth++] = import;
+        }
+    }
+
+done:
+    free(stack);
+    free(visited);
+    return failed;
+}
+
+mt_Module *mt_loader_load(mt_Loader *loader, const char *path) {
+    loader->error[0] = '\0';
+
+    char *canonical = realpath(path, NULL);
+    if (!canonical) {
+        snprintf(loader->error, LOADER_ERROR_LENGTH, "%s: could not read file", path);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&loader->lock);
+    mt_Module *root = intern_module(loader, canonical);
+    while (loader->pending > 0) {
+        pthread_cond_wait(&loader->idle, &loader->lock);
+    }
+    pthread_mutex_unlock(&loader->lock);
+
+    if (!root) {
+        snprintf(loader->error, LOADER_ERROR_LENGTH, "not enough memory");
+        return NULL;
+    }
+
+    bool ok;
+    mt_Module *failed = find_failure(loader, root, &ok);
+    if (!ok) {
+        snprintf(loader->error, LOADER_ERROR_LENGTH, "not enough memory");
+        return NULL;
+    }
+
+    if (failed) {
+        memcpy(loader->error, failed->error, LOADER_ERROR_LENGTH);
+        return NULL;
+    }
+
+    return root;
+}
+
+void mt_loader_free(mt_Loader *loader) {
+    stop_threads(loader);
+
+    for (uint32_t i = 0; i < loader->module_capacity; i++) {
+        if (loader->modules[i]) module_free(loader->modules[i]);
+    }
+
+    for (uint32_t i = 0; i < loader->search_path_count; i++) {
+        free(loader->search_paths[i]);
+    }
+
+    pthread_cond_destroy(&loader->idle);
+    pthread_cond_destroy(&loader->work);
+    pthread_mutex_destroy(&loader->lock);
+    free(loader->search_paths);
+    free(loader->modules);
+    free(loader->queue);
+    free(loader);
+}
@@ -0,0 +1,261 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "list.h"
+#include "map.h"
+
+#define CONTROL_EMPTY 0x80
+#define CONTROL_DELETED 0xfe
+#define NOT_FOUND UINT32_MAX
+
+mt_Map *mt_map_init(mt_TypeTag key_type, mt_TypeTag value_type) {
+    mt_Map *map = calloc(1, sizeof(mt_Map));
+    if (!map) return NULL;
+
+    map->key_type = key_type;
+    map->value_type = value_type;
+    map->value_size = mt_list_element_size(value_type);
+    return map;
+}
+
+void mt_map_free(mt_Map *map) {
+    // The control bytes, keys and values share one allocation.
+    free(map->control);
+    free(map);
+}
+
+
+/// Hashing
+/// =======
+
+static uint64_t hash_key(const mt_Map *map, mt_MapKey key) {
+    // Strings carry their hash, so string keys never look at their
+    // contents here.  Everything goes through a finalizer so both the
+    // group index and the control bits get well-mixed bits.
+    uint64_t hash = map->key_type == mt_TYPE_STRING ? key.string->hash : (uint64_t)key.integer;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static uint8_t control_bits(uint64_t hash) {
+    return hash & 0x7f;
+}
+
+static bool keys_equal(const mt_Map *map, mt_MapKey a, mt_MapKey b) {
+    if (map->key_type != mt_TYPE_STRING) return a.integer == b.integer;
+    if (a.string == b.string) return true;
+    return a.string->hash == b.string->hash && mt_string_equal(a.string, b.string);
+}
+
+
+/// Groups
+/// ======
+
+/// Get a bitmask of the slots in a group whose control byte is byte.
+static uint32_t match_byte(const uint8_t *group, uint8_t byte) {
+#ifdef __SSE2__
+    __m128i control = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)byte)));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < mt_MAP_GROUP_SIZE; i++) {
+        if (group[i] == byte) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+/// Get a bitmask of the slots in a group that don't hold a key, which
+/// are exactly the ones whose control byte has its high bit set.
+static uint32_t match_free(const uint8_t *group) {
+#ifdef __SSE2__
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < mt_MAP_GROUP_SIZE; i++) {
+        if (group[i] & 0x80) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+/// Groups are probed triangularly, which visits every group exactly
+/// once since the number of groups is a power of 2.
+typedef struct {
+    uint32_t mask;
+    uint32_t group;
+    uint32_t stride;
+} Probe;
+
+static Probe probe_start(const mt_Map *map, uint64_t hash) {
+    uint32_t mask = map->capacity / mt_MAP_GROUP_SIZE - 1;
+    return (Probe){ .mask = mask, .group = (uint32_t)(hash >> 7) & mask, .stride = 0 };
+}
+
+static void probe_next(Probe *probe) {
+    probe->stride += 1;
+    probe->group = (probe->group + probe->stride) & probe->mask;
+}
+
+static uint32_t find(const mt_Map *map, mt_MapKey key, uint64_t hash) {
+    if (map->capacity == 0) return NOT_FOUND;
+
+    uint8_t bits = control_bits(hash);
+    Probe probe = probe_start(map, hash);
+    for (uint32_t i = 0; i <= probe.mask; i++, probe_next(&probe)) {
+        const uint8_t *group = map->control + probe.group * mt_MAP_GROUP_SIZE;
+        for (uint32_t matches = match_byte(group, bits); matches; matches &= matches - 1) {
+            uint32_t slot = probe.group * mt_MAP_GROUP_SIZE + (uint32_t)__builtin_ctz(matches);
+            if (keys_equal(map, map->keys[slot], key)) return slot;
+        }
+
+        // Insertions only ever move on from a group that's full, so
+        // the key can't be any further along.
+        if (match_byte(group, CONTROL_EMPTY)) return NOT_FOUND;
+    }
+
+    return NOT_FOUND;
+}
+
+/// Find the first slot along a hash's probe sequence that doesn't
+/// hold a key.  The table must have at least one.
+static uint32_t find_free(const mt_Map *map, uint64_t hash) {
+    Probe probe = probe_start(map, hash);
+    while (true) {
+        uint32_t free_slots = match_free(map->control + probe.group * mt_MAP_GROUP_SIZE);
+        if (free_slots) return probe.group * mt_MAP_GROUP_SIZE + (uint32_t)__builtin_ctz(free_slots);
+        probe_next(&probe);
+    }
+}
+
+
+/// Resizing
+/// ========
+
+static void *value_at(const mt_Map *map, uint32_t slot) {
+    return map->values + (size_t)slot * map->value_size;
+}
+
+static bool resize(mt_Map *map, uint32_t capacity) {
+    size_t values_offset = (size_t)capacity * (1 + sizeof(mt_MapKey));
+    uint8_t *control = malloc(values_offset + (size_t)capacity * map->value_size);
+    if (!control) return false;
+
+    mt_Map old = *map;
+    map->control = control;
+    map->keys = (mt_MapKey *)(control + capacity);
+    map->values = (char *)control + values_offset;
+    map->capacity = capacity;
+    map->deleted = 0;
+    memset(control, CONTROL_EMPTY, capacity);
+
+    for (uint32_t slot = 0; slot < old.capacity; slot++) {
+        if (old.control[slot] & 0x80) continue;
+
+        uint64_t hash = hash_key(map, old.keys[slot]);
+        uint32_t new_slot = find_free(map, hash);
+        map->control[new_slot] = control_bits(hash);
+        map->keys[new_slot] = old.keys[slot];
+        memcpy(value_at(map, new_slot), value_at(&old, slot), map->value_size);
+    }
+
+    free(old.control);
+    return true;
+}
+
+/// Make sure there's room for one more key while keeping at least an
+/// eighth of the slots empty so unsuccessful lookups stay short.
+static bool reserve_one(mt_Map *map) {
+    uint64_t limit = (uint64_t)map->capacity * 7 / 8;
+    if (map->count + map->deleted + 1 <= limit) return true;
+
+    // Tables that are mostly tombstones are rehashed in place rather
+    // than grown.
+    uint32_t capacity = map->capacity ? map->capacity : mt_MAP_GROUP_SIZE;
+    if ((uint64_t)(map->count + 1) * 16 > (uint64_t)capacity * 7) {
+        if (capacity > UINT32_MAX / 2) return false;
+        capacity *= 2;
+    }
+
+    return resize(map, capacity);
+}
+
+
+/// Access
+/// ======
+
+void *mt_map_get(const mt_Map *map, mt_MapKey key) {
+    uint32_t slot = find(map, key, hash_key(map, key));
+    return slot == NOT_FOUND ? NULL : value_at(map, slot);
+}
+
+void *mt_map_put(mt_Map *map, mt_MapKey key, bool *inserted) {
+    uint64_t hash = hash_key(map, key);
+    uint32_t slot = find(map, key, hash);
+    if (inserted) *inserted = slot == NOT_FOUND;
+    if (slot != NOT_FOUND) return value_at(map, slot);
+
+    if (!reserve_one(map)) return NULL;
+
+    slot = find_free(map, hash);
+    if (map->control[slot] == CONTROL_DELETED) map->deleted -= 1;
+    map->control[slot] = control_bits(hash);
+    map->keys[slot] = key;
+    map->count += 1;
+
+    void *value = value_at(map, slot);
+    memset(value, 0, map->value_size);
+    return value;
+}
+
+bool mt_map_remove(mt_Map *map, mt_MapKey key) {
+    uint32_t slot = find(map, key, hash_key(map, key));
+    if (slot == NOT_FOUND) return false;
+
+    // Lookups stop at a group with an empty slot, so if this group
+    // already has one then no key can have been pushed past it and
+    // the slot can be emptied instead of leaving a tombstone.
+    uint8_t *group = map->control + slot / mt_MAP_GROUP_SIZE * mt_MAP_GROUP_SIZE;
+    if (match_byte(group, CONTROL_EMPTY)) {
+        map->control[slot] = CONTROL_EMPTY;
+    } else {
+        map->control[slot] = CONTROL_DELETED;
+        map->deleted += 1;
+    }
+
+    map->count -= 1;
+    return true;
+}
+
+
+/// Iteration
+/// =========
+
+mt_MapIterator mt_map_iter(const mt_Map *map) {
+    return (mt_MapIterator){ .map = map, .slot = 0 };
+}
+
+bool mt_map_has_more(mt_MapIterator *iterator) {
+    const mt_Map *map = iterator->map;
+    while (iterator->slot < map->capacity && (map->control[iterator->slot] & 0x80)) {
+        iterator->slot += 1;
+    }
+
+    return iterator->slot < map->capacity;
+}
+
+mt_MapKey mt_map_get_next(mt_MapIterator *iterator, void **value) {
+    uint32_t slot = iterator->slot++;
+    if (value) *value = value_at(iterator->map, slot);
+    return iterator->map->keys[slot];
+}
@@ -0,0 +1,287 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "match.h"
+#include "str.h"
+
+/// Jump tables are used when at least this many keys fill at least
+/// half of the range between the smallest and the largest key.
+#define JUMP_TABLE_MIN_KEYS 4
+
+mt_DecisionTree *mt_match_init() {
+    mt_DecisionTree *tree = malloc(sizeof(mt_DecisionTree));
+    if (!tree) return NULL;
+
+    memset(tree->switches, 0, sizeof(tree->switches));
+    tree->default_arm = mt_NO_ARM;
+
+    memset(tree->error, 0, MATCH_ERROR_LENGTH);
+    tree->error_line = 0;
+    tree->error_column = 0;
+
+    return tree;
+}
+
+static void free_switch(mt_Switch *s) {
+    free(s->keys);
+    free(s->strings);
+    free(s->arms);
+    memset(s, 0, sizeof(mt_Switch));
+}
+
+static void match_error(mt_DecisionTree *tree, mt_Pattern *pattern, const char *message) {
+    snprintf(tree->error, MATCH_ERROR_LENGTH, "%s", message);
+    tree->error_line = pattern ? pattern->line : 0;
+    tree->error_column = pattern ? pattern->column : 0;
+}
+
+
+/// Keyed switches
+/// ==============
+
+typedef struct {
+    int64_t key;
+    uint32_t arm;
+} Entry;
+
+static int64_t pattern_key(mt_Pattern *pattern) {
+    switch (pattern->type) {
+    case mt_PATTERN_INTEGER: return pattern->value.as_integer;
+    case mt_PATTERN_BOOLEAN: return pattern->value.as_boolean ? 1 : 0;
+    case mt_PATTERN_RECORD:  return pattern->value.as_shape;
+    default:                 return 0;
+    }
+}
+
+static int compare_entries(const void *a, const void *b) {
+    const Entry *x = a;
+    const Entry *y = b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return x->arm < y->arm ? -1 : x->arm > y->arm;
+}
+
+/// Build the switch for integers, booleans or shapes from entries in
+/// source order.  The arm of the first case that shadows another is
+/// stored in redundant if it comes before the one already there.
+static bool build_keyed(mt_Switch *s, Entry *entries, uint32_t count, uint32_t *redundant) {
+    qsort(entries, count, sizeof(Entry), compare_entries);
+
+    // Only the first case for every key is reachable.
+    uint32_t unique = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (unique > 0 && entries[unique - 1].key == entries[i].key) {
+            if (entries[i].arm < *redundant) *redundant = entries[i].arm;
+            continue;
+        }
+
+        entries[unique++] = entries[i];
+    }
+
+    int64_t min = entries[0].key;
+    uint64_t range = (uint64_t)entries[unique - 1].key - (uint64_t)min;
+    if (unique >= JUMP_TABLE_MIN_KEYS && range < (uint64_t)unique * 2) {
+        s->type = mt_SWITCH_JUMP_TABLE;
+        s->base = min;
+        s->count = (uint32_t)range + 1;
+        s->arms = malloc(sizeof(uint32_t) * s->count);
+        if (!s->arms) return false;
+
+        for (uint32_t i = 0; i < s->count; i++) s->arms[i] = mt_NO_ARM;
+        for (uint32_t i = 0; i < unique; i++) {
+            s->arms[(uint64_t)entries[i].key - (uint64_t)min] = entries[i].arm;
+        }
+
+        return true;
+    }
+
+    s->type = mt_SWITCH_SEARCH;
+    s->count = unique;
+    s->keys = malloc(sizeof(int64_t) * unique);
+    s->arms = malloc(sizeof(uint32_t) * unique);
+    if (!s->keys || !s->arms) return false;
+
+    for (uint32_t i = 0; i < unique; i++) {
+        s->keys[i] = entries[i].key;
+        s->arms[i] = entries[i].arm;
+    }
+
+    return true;
+}
+
+static uint32_t select_keyed(mt_Switch *s, int64_t key) {
+    if (s->type == mt_SWITCH_JUMP_TABLE) {
+        uint64_t offset = (uint64_t)key - (uint64_t)s->base;
+        return offset < s->count ? s->arms[offset] : mt_NO_ARM;
+    }
+
+    uint32_t lo = 0;
+    uint32_t hi = s->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (s->keys[mid] == key) return s->arms[mid];
+        if (s->keys[mid] < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return mt_NO_ARM;
+}
+
+
+/// String switches
+/// ===============
+
+static uint32_t *find_string_slot(mt_Switch *s, mt_String *key) {
+    uint32_t mask = s->count - 1;
+    uint32_t slot = key->hash & mask;
+    while (s->arms[slot] != mt_NO_ARM && !mt_string_equal(&s->strings[slot], key)) {
+        slot = (slot + 1) & mask;
+    }
+
+    return &s->arms[slot];
+}
+
+static bool build_strings(mt_Switch *s, mt_Pattern *cases, uint32_t count, uint32_t nstrings, uint32_t *redundant) {
+    uint32_t capacity = 8;
+    while (capacity < nstrings * 2) capacity *= 2;
+
+    s->type = mt_SWITCH_HASH;
+    s->count = capacity;
+    s->strings = malloc(sizeof(mt_String) * capacity);
+    s->arms = malloc(sizeof(uint32_t) * capacity);
+    if (!s->strings || !s->arms) return false;
+
+    for (uint32_t i = 0; i < capacity; i++) s->arms[i] = mt_NO_ARM;
+    for (uint32_t i = 0; i < count; i++) {
+        if (cases[i].type != mt_PATTERN_STRING) continue;
+
+        mt_String *key = &cases[i].value.as_string;
+        uint32_t *arm = find_string_slot(s, key);
+        if (*arm != mt_NO_ARM) {
+            if (i < *redundant) *redundant = i;
+            continue;
+        }
+
+        *arm = i;
+        s->strings[arm - s->arms] = *key;
+    }
+
+    return true;
+}
+
+
+/// Compilation
+/// ===========
+
+bool mt_match_compile(mt_DecisionTree *tree, mt_Pattern *cases, uint32_t count) {
+    Entry *entries = NULL;
+    uint32_t counts[mt_PATTERN_KIND_COUNT] = { 0 };
+    uint32_t redundant = mt_NO_ARM;
+
+    if (count == 0) {
+        match_error(tree, NULL, "match expressions must have at least one case");
+        return false;
+    }
+
+    // Nothing after a wildcard can match.
+    uint32_t reachable = count;
+    tree->default_arm = mt_NO_ARM;
+    for (uint32_t i = 0; i < count; i++) {
+        if (cases[i].type == mt_PATTERN_WILDCARD) {
+            tree->default_arm = i;
+            reachable = i + 1;
+            break;
+        }
+
+        counts[cases[i].type]++;
+    }
+
+    if (reachable < count) redundant = reachable;
+
+    entries = malloc(sizeof(Entry) * count);
+    if (!entries) goto oom;
+
+    for (int kind = 0; kind < mt_PATTERN_KIND_COUNT; kind++) {
+        mt_Switch *s = &tree->switches[kind];
+        free_switch(s);
+        if (counts[kind] == 0) continue;
+
+        if (kind == mt_PATTERN_STRING) {
+            if (!build_strings(s, cases, reachable, counts[kind], &redundant)) goto oom;
+            continue;
+        }
+
+        uint32_t nentries = 0;
+        for (uint32_t i = 0; i < reachable; i++) {
+            if ((int)cases[i].type != kind) continue;
+            entries[nentries].key = pattern_key(&cases[i]);
+            entries[nentries].arm = i;
+            nentries++;
+        }
+
+        if (!build_keyed(s, entries, nentries, &redundant)) goto oom;
+    }
+
+    free(entries);
+
+    // A match that covers both booleans and nothing else can't fall
+    // through to its wildcard.
+    bool only_booleans = counts[mt_PATTERN_BOOLEAN] == reachable - (tree->default_arm != mt_NO_ARM);
+    mt_Switch *booleans = &tree->switches[mt_PATTERN_BOOLEAN];
+    bool covers_booleans = booleans->type != mt_SWITCH_NONE && booleans->count == 2;
+    if (only_booleans && covers_booleans && tree->default_arm != mt_NO_ARM && tree->default_arm < redundant) {
+        redundant = tree->default_arm;
+    }
+
+    if (redundant != mt_NO_ARM) {
+        match_error(tree, &cases[redundant], "this case is unreachable because the cases before it cover every value it matches");
+        return false;
+    }
+
+    if (tree->default_arm == mt_NO_ARM && !(only_booleans && covers_booleans)) {
+        match_error(tree, &cases[count - 1], "match is not exhaustive, add a '_' case to cover the remaining values");
+        return false;
+    }
+
+    return true;
+
+oom:
+    free(entries);
+    match_error(tree, NULL, "not enough memory");
+    return false;
+}
+
+uint32_t mt_match_select(mt_DecisionTree *tree, mt_Pattern *value) {
+    mt_Switch *s = &tree->switches[value->type];
+    uint32_t arm = mt_NO_ARM;
+    switch (s->type) {
+    case mt_SWITCH_NONE:
+        break;
+
+    case mt_SWITCH_JUMP_TABLE:
+    case mt_SWITCH_SEARCH:
+        arm = select_keyed(s, pattern_key(value));
+        break;
+
+    case mt_SWITCH_HASH:
+        arm = *find_string_slot(s, &value->value.as_string);
+        break;
+    }
+
+    return arm != mt_NO_ARM ? arm : tree->default_arm;
+}
+
+void mt_match_free(mt_DecisionTree *tree) {
+    if (!tree) return;
+
+    for (int kind = 0; kind < mt_PATTERN_KIND_COUNT; kind++) {
+        free_switch(&tree->switches[kind]);
+    }
+
+    free(tree);
+}
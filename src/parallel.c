@@ -0,0 +1,235 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "parallel.h"
+
+/// Chunks
+/// ======
+
+static bool take_chunk(mt_Worker *worker, uint32_t *chunk) {
+    pthread_mutex_lock(&worker->lock);
+    bool found = worker->next < worker->end;
+    if (found) *chunk = worker->next++;
+    pthread_mutex_unlock(&worker->lock);
+    return found;
+}
+
+/// Steal the back half of the first other worker's chunks that has
+/// any left, keeping the first stolen chunk and queueing the rest.
+static bool steal_chunk(mt_Worker *thief, uint32_t *chunk) {
+    mt_WorkPool *pool = thief->pool;
+    for (uint32_t offset = 1; offset < pool->worker_count; offset++) {
+        mt_Worker *victim = &pool->workers[(thief->id + offset) % pool->worker_count];
+
+        pthread_mutex_lock(&victim->lock);
+        uint32_t remaining = victim->end - victim->next;
+        uint32_t end = victim->end;
+        if (victim->next < victim->end) victim->end -= (remaining + 1) / 2;
+        uint32_t start = victim->end;
+        pthread_mutex_unlock(&victim->lock);
+
+        if (start == end) continue;
+
+        pthread_mutex_lock(&thief->lock);
+        thief->next = start + 1;
+        thief->end = end;
+        pthread_mutex_unlock(&thief->lock);
+
+        *chunk = start;
+        return true;
+    }
+
+    return false;
+}
+
+static void run_chunk(mt_Worker *worker, uint32_t chunk) {
+    mt_WorkPool *pool = worker->pool;
+    mt_ParallelLoop *loop = pool->loop;
+
+    // Loops can span all of int64_t, so offsets are computed unsigned.
+    uint64_t grain = (uint64_t)pool->grain;
+    int64_t start = (int64_t)((uint64_t)loop->start + (uint64_t)chunk * grain);
+    int64_t end = (uint64_t)loop->end - (uint64_t)start > grain ? (int64_t)((uint64_t)start + grain) : loop->end;
+    void *result = NULL;
+    if (loop->result_size > 0) {
+        result = pool->results + (size_t)chunk * loop->result_size;
+        memcpy(result, loop->identity, loop->result_size);
+    }
+
+    loop->body(worker, start, end, result, loop->data);
+    worker->arena_used = 0;
+}
+
+static void run_chunks(mt_Worker *worker) {
+    uint32_t chunk;
+    while (take_chunk(worker, &chunk) || steal_chunk(worker, &chunk)) {
+        run_chunk(worker, chunk);
+    }
+}
+
+static void *run_worker(void *data) {
+    mt_Worker *worker = data;
+    mt_WorkPool *pool = worker->pool;
+    uint64_t generation = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while (!pool->stopping && pool->generation == generation) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+
+        if (pool->stopping) break;
+
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+        run_chunks(worker);
+        pthread_mutex_lock(&pool->lock);
+
+        pool->busy -= 1;
+        if (pool->busy == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+
+/// Pools
+/// =====
+
+mt_WorkPool *mt_work_pool_init(uint32_t workers) {
+    if (workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+
+    if (workers > mt_WORK_POOL_MAX_WORKERS) workers = mt_WORK_POOL_MAX_WORKERS;
+
+    mt_WorkPool *pool = calloc(1, sizeof(mt_WorkPool));
+    if (!pool) return NULL;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    // The first worker is the calling thread, so it doesn't get a
+    // thread of its own.
+    for (; pool->worker_count < workers; pool->worker_count++) {
+        mt_Worker *worker = &pool->workers[pool->worker_count];
+        worker->pool = pool;
+        worker->id = pool->worker_count;
+        pthread_mutex_init(&worker->lock, NULL);
+
+        worker->arena = malloc(mt_WORKER_ARENA_SIZE);
+        if (!worker->arena) goto fail;
+
+        if (worker->id > 0 && pthread_create(&worker->thread, NULL, run_worker, worker) != 0) {
+            free(worker->arena);
+            goto fail;
+        }
+    }
+
+    return pool;
+
+fail:
+    pthread_mutex_destroy(&pool->workers[pool->worker_count].lock);
+    mt_work_pool_free(pool);
+    return NULL;
+}
+
+/// Divide rounding up without overflowing for lengths close to
+/// UINT64_MAX.
+static uint64_t divide_up(uint64_t n, uint64_t d) {
+    return n / d + (n % d != 0);
+}
+
+bool mt_parallel_for(mt_WorkPool *pool, mt_ParallelLoop *loop, void *result) {
+    if (loop->end <= loop->start) {
+        if (result) memcpy(result, loop->identity, loop->result_size);
+        return true;
+    }
+
+    // The grain only depends on the loop so results are reduced the
+    // same way however many workers there are.
+    uint64_t length = (uint64_t)loop->end - (uint64_t)loop->start;
+    uint64_t grain = loop->grain > 0 ? (uint64_t)loop->grain : divide_up(length, mt_PARALLEL_MAX_CHUNKS);
+    if (divide_up(length, grain) > UINT32_MAX) grain = divide_up(length, UINT32_MAX);
+    uint32_t chunk_count = (uint32_t)divide_up(length, grain);
+
+    char *results = NULL;
+    if (loop->result_size > 0) {
+        results = malloc(loop->result_size * chunk_count);
+        if (!results) return false;
+    }
+
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        mt_Worker *worker = &pool->workers[i];
+        pthread_mutex_lock(&worker->lock);
+        worker->next = (uint32_t)((uint64_t)chunk_count * i / pool->worker_count);
+        worker->end = (uint32_t)((uint64_t)chunk_count * (i + 1) / pool->worker_count);
+        pthread_mutex_unlock(&worker->lock);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->loop = loop;
+    pool->grain = (int64_t)grain;
+    pool->chunk_count = chunk_count;
+    pool->results = results;
+    pool->busy = pool->worker_count - 1;
+    pool->generation += 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    run_chunks(&pool->workers[0]);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pool->loop = NULL;
+    pool->results = NULL;
+    pthread_mutex_unlock(&pool->lock);
+
+    if (result) {
+        memcpy(result, loop->identity, loop->result_size);
+        for (uint32_t i = 0; i < chunk_count; i++) {
+            loop->reduce(result, results + (size_t)i * loop->result_size, loop->data);
+        }
+    }
+
+    free(results);
+    return true;
+}
+
+void *mt_worker_alloc(mt_Worker *worker, size_t size) {
+    size_t align = _Alignof(max_align_t);
+    size_t start = (worker->arena_used + align - 1) & ~(align - 1);
+    if (size > mt_WORKER_ARENA_SIZE - start || start > mt_WORKER_ARENA_SIZE) return NULL;
+
+    worker->arena_used = start + size;
+    return worker->arena + start;
+}
+
+void mt_work_pool_free(mt_WorkPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (uint32_t i = 0; i < pool->worker_count; i++) {
+        mt_Worker *worker = &pool->workers[i];
+        if (i > 0) pthread_join(worker->thread, NULL);
+        pthread_mutex_destroy(&worker->lock);
+        free(worker->arena);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
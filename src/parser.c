@@ -3,8 +3,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "dump.h"
+#include "heap.h"
 #include "parser.h"
 #include "scanner.h"
+#include "stats.h"
+#include "writer.h"
 
 /// Node
 /// ====
@@ -24,7 +28,8 @@ static void node_list_reverse(mt_NodeList **list) {
 }
 
 static mt_NodeList *node_list_cons(mt_NodeList *old_head, mt_Node *el) {
-    mt_NodeList *head = malloc(sizeof(mt_NodeList));
+    mt_HEAP_SITE(site);
+    mt_NodeList *head = mt_heap_alloc(&site, NULL, sizeof(mt_NodeList));
     head->value = el;
     head->next = old_head;
     return head;
@@ -35,56 +40,74 @@ static void node_list_free(mt_NodeList *head) {
     while (head) {
         head = head->next;
         mt_node_free(current->value);
-        free(current);
+        mt_heap_free(current);
         current = head;
     }
 }
 
+static const char *NODE_NAMES[] = {
+    "MODULE",
+    "STRING",
+    "TYPE",
+    "NAME",
+    "INTEGER",
+    "FLOAT",
+};
+
+/// Heap profiles break nodes down by type.
+static mt_HeapCounter NODE_KINDS[] = {
+    mt_HEAP_KIND("MODULE"),
+    mt_HEAP_KIND("STRING"),
+    mt_HEAP_KIND("TYPE"),
+    mt_HEAP_KIND("NAME"),
+    mt_HEAP_KIND("INTEGER"),
+    mt_HEAP_KIND("FLOAT"),
+};
+
+const char *mt_node_type_name(mt_NodeType type) {
+    return NODE_NAMES[type];
+}
+
 mt_Node *mt_node_init(mt_NodeType type, uint32_t line, uint32_t column) {
-    mt_Node *node = malloc(sizeof(mt_Node));
+    mt_HEAP_SITE(site);
+    mt_Node *node = mt_heap_alloc(&site, &NODE_KINDS[type], sizeof(mt_Node));
     if (!node) return NULL;
 
+    mt_STATS_COUNT(mt_STATS_NODES, type);
     node->type = type;
     node->value.as_node_list = NULL;
+    node->binding.type = mt_BINDING_UNRESOLVED;
+    node->binding.index = 0;
     node->line = line;
     node->column = column;
     return node;
 }
 
-static void dump_node(mt_Node *node, FILE *out, uint32_t depth, char *terminator) {
-    mt_NodeList *head = NULL;
+void mt_node_dump(mt_Node *node, FILE *out) {
+    mt_Writer *writer = mt_writer_init(out);
+    if (!writer) return;
 
-    for (uint32_t i = 0; i < depth; i++) fprintf(out, " ");
+    mt_dump_tree(writer, mt_DUMP_TEXT, node);
+    mt_writer_free(writer);
+}
 
+void mt_node_free(mt_Node *node) {
     switch (node->type) {
-    case mt_NODE_TYPE:   fprintf(out, "TYPE(%s)", node->value.as_string); break;
-    case mt_NODE_NAME:   fprintf(out, "NAME(%s)", node->value.as_string); break;
-    case mt_NODE_STRING: fprintf(out, "STRING(\"%s\")", node->value.as_string); break;
-
     case mt_NODE_MODULE:
-        fprintf(out, "MODULE(\n");
-        head = node->value.as_node_list;
-        while (head) {
-            dump_node(head->value, out, depth + 2, ",\n");
-            head = head->next;
-        }
-        fprintf(out, ")");
+        node_list_free(node->value.as_node_list);
         break;
-    }
 
-    fprintf(out, "%s", terminator);
-}
-
-void mt_node_dump(mt_Node *node, FILE *out) {
-    dump_node(node, out, 0, "\n");
-}
+    case mt_NODE_STRING:
+    case mt_NODE_TYPE:
+    case mt_NODE_NAME:
+        mt_string_free(&node->value.as_string);
+        break;
 
-void mt_node_free(mt_Node *node) {
-    if (node->type == mt_NODE_MODULE)
-        node_list_free(node->value.as_node_list);
+    default:
+        break;
+    }
 
-    // TODO(bogdan): free value based on the node type.
-    free(node);
+    mt_heap_free(node);
 }
 
 
@@ -103,23 +126,34 @@ static mt_Node *node_from_token(mt_Token *token) {
     switch (token->type) {
     case mt_TOKEN_CAP_NAME:
         node = mt_node_init(mt_NODE_TYPE, token->line, token->column);
-        node->value.as_string = malloc(sizeof(char) * token->length + 1);
-        node->value.as_string[token->length] = 0;
-        memcpy(node->value.as_string, token->start, token->length);
+        mt_string_init_view(&node->value.as_string, token->start, token->length);
         return node;
 
     case mt_TOKEN_NAME:
         node = mt_node_init(mt_NODE_NAME, token->line, token->column);
-        node->value.as_string = malloc(sizeof(char) * token->length + 1);
-        node->value.as_string[token->length] = 0;
-        memcpy(node->value.as_string, token->start, token->length);
+        mt_string_init_view(&node->value.as_string, token->start, token->length);
         return node;
 
     case mt_TOKEN_STRING:
         node = mt_node_init(mt_NODE_STRING, token->line, token->column);
-        node->value.as_string = malloc(sizeof(char) * token->length - 1);
-        node->value.as_string[token->length - 1] = 0;
-        memcpy(node->value.as_string, token->start + 1, token->length - 2);
+
+        // Decoded values only live as long as the scanner.
+        if (!token->value.as_string.decoded) {
+            mt_string_init_view(&node->value.as_string, token->value.as_string.data, token->value.as_string.length);
+        } else if (!mt_string_init(&node->value.as_string, token->value.as_string.data, token->value.as_string.length)) {
+            mt_heap_free(node);
+            return NULL;
+        }
+        return node;
+
+    case mt_TOKEN_INTEGER:
+        node = mt_node_init(mt_NODE_INTEGER, token->line, token->column);
+        node->value.as_integer = token->value.as_integer;
+        return node;
+
+    case mt_TOKEN_FLOAT:
+        node = mt_node_init(mt_NODE_FLOAT, token->line, token->column);
+        node->value.as_double = token->value.as_double;
         return node;
 
     default:
@@ -127,15 +161,39 @@ static mt_Node *node_from_token(mt_Token *token) {
     }
 }
 
-static mt_Node *parse_expression(mt_Parser *parser) {
-    mt_Token *token = advance(parser);
-
+static void parse_error(mt_Parser *parser, mt_Token *token) {
     switch (token->type) {
+    case mt_TOKEN_ERROR:
+        snprintf(parser->error, PARSER_ERROR_LENGTH, "%.*s", (int)token->length, token->start);
+        break;
+
+    case mt_TOKEN_EOF:
+        snprintf(parser->error, PARSER_ERROR_LENGTH, "unexpected end of input");
+        break;
+
+    case mt_TOKEN_STRING:
+    case mt_TOKEN_NAME:
+    case mt_TOKEN_CAP_NAME:
+    case mt_TOKEN_INTEGER:
+    case mt_TOKEN_FLOAT:
+        snprintf(parser->error, PARSER_ERROR_LENGTH, "not enough memory");
+        break;
+
     default:
-        return node_from_token(parser->previous_token);
+        snprintf(parser->error, PARSER_ERROR_LENGTH, "unexpected '%.*s'", (int)token->length, token->start);
+        break;
     }
 
-    return NULL;
+    parser->error_line = token->line;
+    parser->error_column = token->column;
+}
+
+static mt_Node *parse_expression(mt_Parser *parser) {
+    advance(parser);
+
+    mt_Node *node = node_from_token(parser->previous_token);
+    if (!node) parse_error(parser, parser->previous_token);
+    return node;
 }
 
 mt_Parser *mt_parser_init(char *filename, char *source) {
@@ -148,6 +206,7 @@ mt_Parser *mt_parser_init(char *filename, char *source) {
     parser->previous_token = NULL;
     parser->current_token = NULL;
     parser->tree = NULL;
+    parser->declarations = NULL;
 
     memset(parser->error, 0, PARSER_ERROR_LENGTH);
     parser->error_line = 0;
@@ -172,16 +231,34 @@ fail:
     return NULL;
 }
 
+static bool skip_import(mt_Parser *parser) {
+    mt_Token *token = advance(parser);
+    while (token->type == mt_TOKEN_NAME) {
+        token = advance(parser);
+        if (token->type != mt_TOKEN_DOT) return true;
+        token = advance(parser);
+    }
+
+    snprintf(parser->error, PARSER_ERROR_LENGTH, "expected a module name after 'import'");
+    parser->error_line = token->line;
+    parser->error_column = token->column;
+    return false;
+}
+
 mt_Node *mt_parser_parse(mt_Parser *parser) {
     mt_Node *tree = parser->tree;
     mt_Node *node = NULL;
 
     advance(parser);
     while (true) {
-        node = parse_expression(parser);
-        if (!node) return NULL;
+        if (parser->current_token->type == mt_TOKEN_IMPORT) {
+            if (!skip_import(parser)) return NULL;
+        } else {
+            node = parse_expression(parser);
+            if (!node) return NULL;
 
-        tree->value.as_node_list = node_list_cons(tree->value.as_node_list, node);
+            tree->value.as_node_list = node_list_cons(tree->value.as_node_list, node);
+        }
 
         if (parser->current_token->type == mt_TOKEN_EOF) {
             break;
@@ -192,11 +269,300 @@ mt_Node *mt_parser_parse(mt_Parser *parser) {
     return parser->tree;
 }
 
+
+
+/// Skimming
+/// ========
+
+typedef struct {
+    mt_Token token;  ///< the keyword that opened the block
+    size_t declaration;  ///< the index of the block's declaration or mt_NO_PARENT
+} Block;
+
+static bool opens_block(mt_TokenType type) {
+    switch (type) {
+    case mt_TOKEN_DEF:
+    case mt_TOKEN_RECORD:
+    case mt_TOKEN_EXTEND:
+    case mt_TOKEN_PROTOCOL:
+    case mt_TOKEN_FOR:
+    case mt_TOKEN_IF:
+    case mt_TOKEN_MATCH:
+    case mt_TOKEN_WHILE:
+    case mt_TOKEN_WITH:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+static bool is_end_a_name(mt_Token *previous, mt_Token *token) {
+    // "end" doubles as a name, eg. "Integer end," inside of a record,
+    // "Range(0, end, 1)" or "self.range.end".  Blocks are always
+    // closed by an "end" at the start of a line.
+    if (previous->type == mt_TOKEN_EOF) return false;
+    return previous->type == mt_TOKEN_DOT || previous->line == token->line;
+}
+
+static void skim_error(mt_Parser *parser, mt_Token *token, const char *message, mt_Token *keyword) {
+    if (keyword) {
+        snprintf(
+            parser->error,
+            PARSER_ERROR_LENGTH,
+            message,
+            (int)keyword->length,
+            keyword->start,
+            keyword->line
+        );
+    } else {
+        snprintf(parser->error, PARSER_ERROR_LENGTH, "%.*s", (int)strlen(message), message);
+    }
+
+    parser->error_line = token->line;
+    parser->error_column = token->column;
+}
+
+static bool skim_scan(mt_Parser *parser, mt_Scanner *scanner, mt_Token *token) {
+    do {
+        mt_scanner_scan(scanner, token);
+    } while (token->type == mt_TOKEN_COMMENT);
+
+    if (token->type == mt_TOKEN_ERROR) {
+        snprintf(parser->error, PARSER_ERROR_LENGTH, "%.*s", (int)token->length, token->start);
+        parser->error_line = token->line;
+        parser->error_column = token->column;
+        return false;
+    }
+
+    return true;
+}
+
+static bool skim_header(mt_Parser *parser, mt_Scanner *scanner, mt_Declaration *declaration, mt_Token *keyword) {
+    mt_Token token;
+
+    if (declaration->type != mt_DECLARATION_DEF) {
+        if (!skim_scan(parser, scanner, &token)) return false;
+        if (token.type != mt_TOKEN_CAP_NAME) {
+            skim_error(parser, &token, "expected a type name after '%.*s' on line %d", keyword);
+            return false;
+        }
+
+        declaration->name = token.start;
+        declaration->name_length = token.length;
+        declaration->body = (size_t)(token.start + token.length - parser->source);
+        return true;
+    }
+
+    // Functions may declare a return type, so their name is the last
+    // name before the parameter list.
+    declaration->name = NULL;
+    while (true) {
+        if (!skim_scan(parser, scanner, &token)) return false;
+        if (token.type == mt_TOKEN_LPAREN && declaration->name) break;
+        if (token.type == mt_TOKEN_NAME) {
+            declaration->name = token.start;
+            declaration->name_length = token.length;
+        } else if (token.type == mt_TOKEN_EOF || opens_block(token.type) || token.type == mt_TOKEN_END) {
+            skim_error(parser, &token, "expected a parameter list after '%.*s' on line %d", keyword);
+            return false;
+        }
+    }
+
+    while (token.type != mt_TOKEN_RPAREN) {
+        if (!skim_scan(parser, scanner, &token)) return false;
+        if (token.type == mt_TOKEN_EOF) {
+            skim_error(parser, &token, "unexpected end of file in the parameter list of '%.*s' on line %d", keyword);
+            return false;
+        }
+    }
+
+    declaration->body = (size_t)(token.start + token.length - parser->source);
+    return true;
+}
+
+/// Module paths are names separated by dots, without any whitespace
+/// in between.  The token that follows the path is left in token.
+static bool skim_import(mt_Parser *parser, mt_Scanner *scanner, mt_Declaration *declaration, mt_Token *token, mt_Token *previous) {
+    mt_Token keyword;
+    mt_token_copy(token, &keyword);
+    if (!skim_scan(parser, scanner, token)) return false;
+    if (token->type != mt_TOKEN_NAME) {
+        skim_error(parser, token, "expected a module name after '%.*s' on line %d", &keyword);
+        return false;
+    }
+
+    declaration->name = token->start;
+    while (true) {
+        mt_token_copy(token, previous);
+        if (!skim_scan(parser, scanner, token)) return false;
+        if (token->type != mt_TOKEN_DOT || token->start != previous->start + previous->length) break;
+
+        mt_token_copy(token, previous);
+        if (!skim_scan(parser, scanner, token)) return false;
+        if (token->type != mt_TOKEN_NAME || token->start != previous->start + previous->length) {
+            skim_error(parser, token, "expected a module name after '.'", NULL);
+            return false;
+        }
+    }
+
+    declaration->name_length = (size_t)(previous->start + previous->length - declaration->name);
+    declaration->body = (size_t)(previous->start + previous->length - parser->source);
+    declaration->end = declaration->body;
+    return true;
+}
+
+static mt_Declaration *add_declaration(mt_DeclarationList *list, mt_DeclarationType type) {
+    if (list->length == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 16;
+        mt_Declaration *declarations = realloc(list->declarations, sizeof(mt_Declaration) * list->capacity);
+        if (!declarations) return NULL;
+        list->declarations = declarations;
+    }
+
+    mt_STATS_COUNT(mt_STATS_DECLARATIONS, type);
+    mt_Declaration *declaration = &list->declarations[list->length++];
+    declaration->type = type;
+    return declaration;
+}
+
+mt_DeclarationList *mt_parser_skim(mt_Parser *parser) {
+    if (parser->declarations) return parser->declarations;
+
+    mt_DeclarationList *list = malloc(sizeof(mt_DeclarationList));
+    mt_Scanner *scanner = mt_scanner_init(parser->source);
+    Block *blocks = NULL;
+    size_t nblocks = 0;
+    size_t blocks_capacity = 0;
+    if (list) {
+        list->declarations = NULL;
+        list->length = 0;
+        list->capacity = 0;
+    }
+
+    if (!list || !scanner) goto fail;
+
+    mt_Token token = { .type = mt_TOKEN_EOF };
+    mt_Token previous;
+    bool pending = false;  // whether skim_import already scanned the next token
+    while (true) {
+        if (pending) {
+            pending = false;
+        } else {
+            mt_token_copy(&token, &previous);
+            if (!skim_scan(parser, scanner, &token)) goto fail;
+        }
+
+        if (token.type == mt_TOKEN_EOF) break;
+
+        if (token.type == mt_TOKEN_IMPORT) {
+            if (nblocks > 0) {
+                skim_error(parser, &token, "imports must be at the top level", NULL);
+                goto fail;
+            }
+
+            mt_Declaration *declaration = add_declaration(list, mt_DECLARATION_IMPORT);
+            if (!declaration) goto fail;
+
+            declaration->parent = mt_NO_PARENT;
+            declaration->start = (size_t)(token.start - parser->source);
+            declaration->line = token.line;
+            declaration->column = token.column;
+            if (!skim_import(parser, scanner, declaration, &token, &previous)) goto fail;
+
+            pending = true;
+            continue;
+        }
+
+        if (token.type == mt_TOKEN_END && !is_end_a_name(&previous, &token)) {
+            if (nblocks == 0) {
+                skim_error(parser, &token, "unexpected 'end'", NULL);
+                goto fail;
+            }
+
+            Block *block = &blocks[--nblocks];
+            if (block->declaration != mt_NO_PARENT) {
+                list->declarations[block->declaration].end = (size_t)(token.start + token.length - parser->source);
+            }
+
+            continue;
+        }
+
+        if (!opens_block(token.type)) continue;
+
+        if (nblocks == blocks_capacity) {
+            blocks_capacity = blocks_capacity ? blocks_capacity * 2 : 16;
+            Block *new_blocks = realloc(blocks, sizeof(Block) * blocks_capacity);
+            if (!new_blocks) goto fail;
+            blocks = new_blocks;
+        }
+
+        Block *block = &blocks[nblocks++];
+        mt_token_copy(&token, &block->token);
+        block->declaration = mt_NO_PARENT;
+
+        mt_DeclarationType type;
+        switch (token.type) {
+        case mt_TOKEN_DEF:      type = mt_DECLARATION_DEF; break;
+        case mt_TOKEN_RECORD:   type = mt_DECLARATION_RECORD; break;
+        case mt_TOKEN_EXTEND:   type = mt_DECLARATION_EXTEND; break;
+        case mt_TOKEN_PROTOCOL: type = mt_DECLARATION_PROTOCOL; break;
+        default: continue;
+        }
+
+        // The innermost enclosing declaration is the parent, even if
+        // other kinds of blocks sit in between.
+        size_t parent = mt_NO_PARENT;
+        for (size_t i = nblocks - 1; i > 0; i--) {
+            if (blocks[i - 1].declaration != mt_NO_PARENT) {
+                parent = blocks[i - 1].declaration;
+                break;
+            }
+        }
+
+        block->declaration = list->length;
+        mt_Declaration *declaration = add_declaration(list, type);
+        if (!declaration) goto fail;
+
+        declaration->parent = parent;
+        declaration->start = (size_t)(token.start - parser->source);
+        declaration->end = 0;
+        declaration->line = token.line;
+        declaration->column = token.column;
+        if (!skim_header(parser, scanner, declaration, &block->token)) goto fail;
+    }
+
+    if (nblocks > 0) {
+        Block *block = &blocks[nblocks - 1];
+        skim_error(parser, &token, "expected 'end' to close '%.*s' on line %d", &block->token);
+        goto fail;
+    }
+
+    free(blocks);
+    mt_scanner_free(scanner);
+    parser->declarations = list;
+    return list;
+
+fail:
+    free(blocks);
+    if (scanner) mt_scanner_free(scanner);
+    if (list) {
+        free(list->declarations);
+        free(list);
+    }
+
+    return NULL;
+}
+
 void mt_parser_free(mt_Parser *parser) {
     if (parser->scanner) mt_scanner_free(parser->scanner);
     if (parser->previous_token) mt_token_free(parser->previous_token);
     if (parser->current_token) mt_token_free(parser->current_token);
     if (parser->tree) mt_node_free(parser->tree);
+    if (parser->declarations) {
+        free(parser->declarations->declarations);
+        free(parser->declarations);
+    }
 
     free(parser);
 }
@@ -0,0 +1,63 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "print.h"
+
+static char buffer[mt_WRITER_BUFFER_SIZE];
+static mt_Writer writer;
+static bool initialized = false;
+
+static void flush_at_exit(void) {
+    mt_writer_flush(&writer);
+}
+
+mt_Writer *mt_print_writer() {
+    if (initialized) return &writer;
+
+    writer.out = stdout;
+    writer.line_buffered = isatty(STDOUT_FILENO);
+    writer.buffer = buffer;
+    writer.length = 0;
+    writer.capacity = sizeof(buffer);
+    writer.failed = false;
+
+    // If the handler can't be registered, the best we can do is to
+    // flush as often as a terminal would.
+    if (atexit(flush_at_exit) != 0) writer.line_buffered = true;
+    initialized = true;
+    return &writer;
+}
+
+void mt_print_string(const mt_String *string) {
+    mt_Writer *out = mt_print_writer();
+    mt_writer_write(out, mt_string_data(string), string->length);
+    mt_writer_write_char(out, '\n');
+}
+
+void mt_print_integer(int64_t n) {
+    mt_Writer *out = mt_print_writer();
+    mt_writer_write_int(out, n);
+    mt_writer_write_char(out, '\n');
+}
+
+void mt_print_float(double n) {
+    mt_Writer *out = mt_print_writer();
+    mt_writer_write_double(out, n);
+    mt_writer_write_char(out, '\n');
+}
+
+void mt_print_boolean(bool b) {
+    mt_Writer *out = mt_print_writer();
+    if (b) {
+        mt_writer_write(out, "True\n", 5);
+    } else {
+        mt_writer_write(out, "False\n", 6);
+    }
+}
+
+bool mt_print_flush() {
+    return mt_writer_flush(mt_print_writer());
+}
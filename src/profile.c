@@ -0,0 +1,182 @@
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "profile.h"
+
+/// The number of distinct stacks a profile can hold.  Must be a power
+/// of two.
+#define STACK_TABLE_SIZE 4096
+
+typedef struct {
+    const char *name;
+    uint32_t line;
+} Frame;
+
+typedef struct {
+    uint64_t count;  ///< 0 if the slot is empty
+    uint32_t hash;
+    uint32_t depth;
+    Frame frames[mt_PROFILE_MAX_DEPTH];
+} Stack;
+
+/// The stack is shared by every thread, so frames should only be
+/// pushed from the main thread.  It may be deeper than
+/// mt_PROFILE_MAX_DEPTH, in which case only the outermost frames are
+/// recorded.
+static Frame frames[mt_PROFILE_MAX_DEPTH];
+static volatile sig_atomic_t depth = 0;
+static volatile sig_atomic_t running = 0;
+
+static Stack *stacks = NULL;
+static uint64_t dropped = 0;
+static struct sigaction previous_action;
+
+
+/// Sampling
+/// ========
+
+static uint32_t hash_frames(Frame *frames, uint32_t n) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t name = (uint64_t)(uintptr_t)frames[i].name;
+        hash = (hash ^ (uint32_t)name) * 16777619u;
+        hash = (hash ^ (uint32_t)(name >> 32)) * 16777619u;
+        hash = (hash ^ frames[i].line) * 16777619u;
+    }
+
+    return hash;
+}
+
+static bool same_frames(Stack *stack, Frame *frames, uint32_t n, uint32_t hash) {
+    if (stack->hash != hash || stack->depth != n) return false;
+    for (uint32_t i = 0; i < n; i++) {
+        if (stack->frames[i].name != frames[i].name || stack->frames[i].line != frames[i].line) return false;
+    }
+
+    return true;
+}
+
+/// Record the current stack.  Runs in signal context, so it must not
+/// allocate or call anything that isn't async-signal-safe.
+static void on_sigprof(int signal) {
+    (void)signal;
+
+    uint32_t n = depth < mt_PROFILE_MAX_DEPTH ? (uint32_t)depth : mt_PROFILE_MAX_DEPTH;
+    uint32_t hash = hash_frames(frames, n);
+    uint32_t slot = hash & (STACK_TABLE_SIZE - 1);
+    for (uint32_t probes = 0; probes < STACK_TABLE_SIZE; probes++) {
+        Stack *stack = &stacks[slot];
+        if (stack->count == 0) {
+            stack->hash = hash;
+            stack->depth = n;
+            for (uint32_t i = 0; i < n; i++) stack->frames[i] = frames[i];
+            stack->count = 1;
+            return;
+        }
+
+        if (same_frames(stack, frames, n, hash)) {
+            stack->count++;
+            return;
+        }
+
+        slot = (slot + 1) & (STACK_TABLE_SIZE - 1);
+    }
+
+    dropped++;
+}
+
+bool mt_profile_start(uint32_t frequency) {
+    if (running || frequency == 0 || frequency > 1000000) return false;
+
+    if (!stacks) {
+        stacks = calloc(STACK_TABLE_SIZE, sizeof(Stack));
+        if (!stacks) return false;
+    } else {
+        memset(stacks, 0, sizeof(Stack) * STACK_TABLE_SIZE);
+    }
+
+    depth = 0;
+    dropped = 0;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_sigprof;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &previous_action) != 0) return false;
+
+    struct itimerval timer;
+    uint64_t interval = 1000000 / frequency;
+    timer.it_interval.tv_sec = (time_t)(interval / 1000000);
+    timer.it_interval.tv_usec = (suseconds_t)(interval % 1000000);
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+        sigaction(SIGPROF, &previous_action, NULL);
+        return false;
+    }
+
+    running = 1;
+    return true;
+}
+
+void mt_profile_stop() {
+    if (!running) return;
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, NULL);
+    sigaction(SIGPROF, &previous_action, NULL);
+    running = 0;
+}
+
+void mt_profile_push(const char *name, uint32_t line) {
+    if (!running) return;
+
+    if (depth < mt_PROFILE_MAX_DEPTH) {
+        frames[depth].name = name;
+        frames[depth].line = line;
+    }
+
+    // The frame must be in place before a sample can see it.
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    depth = depth + 1;
+}
+
+void mt_profile_pop() {
+    if (depth > 0) depth = depth - 1;
+}
+
+
+/// Output
+/// ======
+
+bool mt_profile_write(FILE *out) {
+    if (!stacks) return true;
+
+    for (uint32_t i = 0; i < STACK_TABLE_SIZE; i++) {
+        Stack *stack = &stacks[i];
+        if (stack->count == 0) continue;
+
+        if (stack->depth == 0 && fputs("[unknown]", out) == EOF) return false;
+        for (uint32_t j = 0; j < stack->depth; j++) {
+            Frame *frame = &stack->frames[j];
+            int written = frame->line > 0
+                ? fprintf(out, "%s%s:%u", j > 0 ? ";" : "", frame->name, frame->line)
+                : fprintf(out, "%s%s", j > 0 ? ";" : "", frame->name);
+            if (written < 0) return false;
+        }
+
+        if (fprintf(out, " %llu\n", (unsigned long long)stack->count) < 0) return false;
+    }
+
+    return true;
+}
+
+uint64_t mt_profile_dropped() {
+    return dropped;
+}
@@ -0,0 +1,233 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parser.h"
+#include "resolver.h"
+#include "stats.h"
+#include "str.h"
+
+// The builtin names are interned at build time.
+#include "builtin_table.h"
+
+/// Make room for one more item in an array.
+static bool reserve(void **items, uint32_t count, uint32_t *capacity, size_t size) {
+    if (count < *capacity) return true;
+
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 16;
+    void *new_items = realloc(*items, size * new_capacity);
+    if (!new_items) return false;
+
+    *items = new_items;
+    *capacity = new_capacity;
+    return true;
+}
+
+mt_Resolver *mt_resolver_init() {
+    mt_Resolver *resolver = malloc(sizeof(mt_Resolver));
+    if (!resolver) return NULL;
+
+    resolver->builtins = BUILTIN_STRINGS;
+    resolver->globals = NULL;
+    resolver->global_count = 0;
+    resolver->global_capacity = 0;
+    resolver->global_table = NULL;
+    resolver->global_table_capacity = 0;
+    resolver->locals = NULL;
+    resolver->local_count = 0;
+    resolver->local_capacity = 0;
+    resolver->scopes = NULL;
+    resolver->scope_count = 0;
+    resolver->scope_capacity = 0;
+
+    memset(resolver->error, 0, RESOLVER_ERROR_LENGTH);
+    resolver->error_line = 0;
+    resolver->error_column = 0;
+
+    return resolver;
+}
+
+
+/// Globals
+/// =======
+
+static uint32_t *find_global_entry(mt_Resolver *resolver, mt_String *name) {
+    uint32_t mask = resolver->global_table_capacity - 1;
+    uint32_t slot = name->hash & mask;
+    while (resolver->global_table[slot]) {
+        if (mt_string_equal(&resolver->globals[resolver->global_table[slot] - 1], name)) break;
+        slot = (slot + 1) & mask;
+    }
+
+    return &resolver->global_table[slot];
+}
+
+/// Keep the table at most half full.
+static bool grow_global_table(mt_Resolver *resolver) {
+    if (resolver->global_count * 2 < resolver->global_table_capacity) return true;
+
+    uint32_t capacity = resolver->global_table_capacity ? resolver->global_table_capacity * 2 : 32;
+    uint32_t *table = calloc(capacity, sizeof(uint32_t));
+    if (!table) return false;
+
+    free(resolver->global_table);
+    resolver->global_table = table;
+    resolver->global_table_capacity = capacity;
+    for (uint32_t i = 0; i < resolver->global_count; i++) {
+        *find_global_entry(resolver, &resolver->globals[i]) = i + 1;
+    }
+
+    return true;
+}
+
+bool mt_resolver_declare_global(mt_Resolver *resolver, const char *name, size_t length, uint32_t *slot) {
+    if (!grow_global_table(resolver)) return false;
+    if (!reserve((void **)&resolver->globals, resolver->global_count, &resolver->global_capacity, sizeof(mt_String))) return false;
+
+    mt_String *global = &resolver->globals[resolver->global_count];
+    mt_string_init_view(global, name, length);
+
+    uint32_t *entry = find_global_entry(resolver, global);
+    if (!*entry) *entry = ++resolver->global_count;
+
+    *slot = *entry - 1;
+    return true;
+}
+
+
+/// Scopes
+/// ======
+
+bool mt_resolver_push_scope(mt_Resolver *resolver) {
+    if (!reserve((void **)&resolver->scopes, resolver->scope_count, &resolver->scope_capacity, sizeof(uint32_t))) return false;
+
+    resolver->scopes[resolver->scope_count++] = resolver->local_count;
+    return true;
+}
+
+void mt_resolver_pop_scope(mt_Resolver *resolver) {
+    if (resolver->scope_count == 0) return;
+
+    resolver->local_count = resolver->scopes[--resolver->scope_count];
+}
+
+bool mt_resolver_declare_local(mt_Resolver *resolver, const char *name, size_t length, uint32_t *reg) {
+    if (resolver->scope_count == 0) return false;
+    if (!reserve((void **)&resolver->locals, resolver->local_count, &resolver->local_capacity, sizeof(mt_String))) return false;
+
+    mt_string_init_view(&resolver->locals[resolver->local_count], name, length);
+    *reg = resolver->local_count++;
+    return true;
+}
+
+
+/// Resolution
+/// ==========
+
+static mt_Binding lookup(mt_Resolver *resolver, mt_String *name) {
+    mt_Binding binding = { .type = mt_BINDING_UNRESOLVED, .index = 0 };
+
+    // Scopes are small so scanning them is cheaper than hashing.
+    // Shadowing means the innermost declaration wins.
+    for (uint32_t i = resolver->local_count; i > 0; i--) {
+        if (mt_string_equal(&resolver->locals[i - 1], name)) {
+            binding.type = mt_BINDING_LOCAL;
+            binding.index = i - 1;
+            return binding;
+        }
+    }
+
+    if (resolver->global_count > 0) {
+        uint32_t entry = *find_global_entry(resolver, name);
+        if (entry) {
+            binding.type = mt_BINDING_GLOBAL;
+            binding.index = entry - 1;
+            return binding;
+        }
+    }
+
+    uint32_t mask = BUILTIN_TABLE_CAPACITY - 1;
+    for (uint32_t slot = name->hash & mask; BUILTIN_TABLE[slot]; slot = (slot + 1) & mask) {
+        uint32_t id = BUILTIN_TABLE[slot] - 1;
+        if (mt_string_equal(&resolver->builtins[id], name)) {
+            binding.type = mt_BINDING_BUILTIN;
+            binding.index = id;
+            return binding;
+        }
+    }
+
+    return binding;
+}
+
+mt_Binding mt_resolver_lookup(mt_Resolver *resolver, mt_String *name) {
+    mt_Binding binding = lookup(resolver, name);
+    mt_STATS_COUNT(mt_STATS_LOOKUPS, binding.type);
+    return binding;
+}
+
+static bool resolve_node(mt_Resolver *resolver, mt_Node *node) {
+    switch (node->type) {
+    case mt_NODE_MODULE:
+        for (mt_NodeList *head = node->value.as_node_list; head; head = head->next) {
+            if (!resolve_node(resolver, head->value)) return false;
+        }
+        return true;
+
+    case mt_NODE_NAME:
+        node->binding = mt_resolver_lookup(resolver, &node->value.as_string);
+        if (node->binding.type == mt_BINDING_UNRESOLVED) {
+            snprintf(
+                resolver->error,
+                RESOLVER_ERROR_LENGTH,
+                "undefined name '%.*s'",
+                (int)node->value.as_string.length,
+                mt_string_data(&node->value.as_string)
+            );
+            resolver->error_line = node->line;
+            resolver->error_column = node->column;
+            return false;
+        }
+        return true;
+
+    default:
+        return true;
+    }
+}
+
+bool mt_resolver_resolve(mt_Resolver *resolver, mt_Node *tree, mt_DeclarationList *declarations) {
+    for (size_t i = 0; declarations && i < declarations->length; i++) {
+        mt_Declaration *declaration = &declarations->declarations[i];
+        if (declaration->parent != mt_NO_PARENT) continue;
+
+        // "import a.b" binds a, the same way it would in Python.
+        size_t length = declaration->name_length;
+        if (declaration->type == mt_DECLARATION_IMPORT) {
+            const char *dot = memchr(declaration->name, '.', length);
+            if (dot) length = (size_t)(dot - declaration->name);
+        } else if (declaration->type != mt_DECLARATION_DEF) {
+            continue;
+        }
+
+        uint32_t slot;
+        if (!mt_resolver_declare_global(resolver, declaration->name, length, &slot)) {
+            snprintf(resolver->error, RESOLVER_ERROR_LENGTH, "not enough memory");
+            resolver->error_line = declaration->line;
+            resolver->error_column = declaration->column;
+            return false;
+        }
+    }
+
+    return resolve_node(resolver, tree);
+}
+
+void mt_resolver_free(mt_Resolver *resolver) {
+    if (!resolver) return;
+
+    free(resolver->globals);
+    free(resolver->global_table);
+    free(resolver->locals);
+    free(resolver->scopes);
+    free(resolver);
+}
@@ -1,10 +1,20 @@
+#include <pthread.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "heap.h"
 #include "scanner.h"
+#include "scanner_table.h"
+#include "stats.h"
+#include "utf8.h"
 #include "utils.h"
 
 /// Token
@@ -40,7 +50,8 @@ static char *TOKEN_DEBUG_NAMES[] = {
     "TOKEN_CAP_NAME",
     "TOKEN_NAME",
     "TOKEN_STRING",
-    "TOKEN_NUMBER",
+    "TOKEN_INTEGER",
+    "TOKEN_FLOAT",
 
     "TOKEN_AND",
     "TOKEN_DEF",
@@ -50,6 +61,7 @@ static char *TOKEN_DEBUG_NAMES[] = {
     "TOKEN_FALSE",
     "TOKEN_FOR",
     "TOKEN_IF",
+    "TOKEN_IMPORT",
     "TOKEN_IN",
     "TOKEN_MATCH",
     "TOKEN_NOT",
@@ -69,12 +81,17 @@ mt_Token *mt_token_init() {
     token->type = mt_TOKEN_EOF;
     token->start = NULL;
     token->length = 0;
+    memset(&token->value, 0, sizeof(token->value));
     token->line = 0;
     token->column = 0;
 
     return token;
 }
 
+const char *mt_token_type_name(mt_TokenType type) {
+    return TOKEN_DEBUG_NAMES[type];
+}
+
 void mt_token_debug(mt_Token *token, char *buf, size_t bufsz) {
     char value[255] = "";
     memcpy(value, token->start, MIN(token->length, sizeof(value) - 1));
@@ -94,6 +111,7 @@ void mt_token_copy(mt_Token *src, mt_Token *dst) {
     dst->type = src->type;
     dst->start = src->start;
     dst->length = src->length;
+    dst->value = src->value;
     dst->line = src->line;
     dst->column = src->column;
 }
@@ -107,6 +125,7 @@ static void load_token(mt_Scanner *scanner, mt_Token *token, mt_TokenType type)
     token->type = type;
     token->start = scanner->start;
     token->length = (size_t)(scanner->current - scanner->start);
+    token->value.as_integer = 0;
     token->line = scanner->line;
     token->column = scanner->column - token->length + 1;
 }
@@ -115,6 +134,7 @@ static void fail_token(mt_Scanner *scanner, mt_Token *token, char *message) {
     token->type = mt_TOKEN_ERROR;
     token->start = message;
     token->length = strlen(message);
+    token->value.as_integer = 0;
     token->line = scanner->line;
     token->column = scanner->column - (size_t)(scanner->current - scanner->start) + 1;
 }
@@ -171,6 +191,10 @@ static bool is_alpha(char c) {
     return is_lo_alpha(c) || is_hi_alpha(c);
 }
 
+static bool is_name_type(mt_TokenType type) {
+    return type == mt_TOKEN_NAME || type == mt_TOKEN_CAP_NAME || (type >= mt_TOKEN_AND && type <= mt_TOKEN_WITH);
+}
+
 static bool match_keyword(mt_Scanner *scanner, const char *keyword) {
     size_t length = (size_t)(scanner->current - scanner->start);
     return length == strlen(keyword) && memcmp(scanner->start, keyword, length) == 0;
@@ -185,11 +209,32 @@ static void load_comment(mt_Scanner *scanner, mt_Token *token) {
     load_token(scanner, token, mt_TOKEN_COMMENT);
 }
 
-static void load_name(mt_Scanner *scanner, mt_Token *token) {
-    while (is_alpha(*scanner->current) || is_digit(*scanner->current) || *scanner->current == '_') {
-        scanner->current += 1;
-        scanner->column += 1;
+/// Consume the code point at the current position if it satisfies
+/// a predicate.  Columns are counted in bytes.
+static bool match_code_point(mt_Scanner *scanner, bool (*predicate)(uint32_t)) {
+    size_t length;
+    uint32_t c = mt_utf8_decode(scanner->current, &length);
+    if (c == mt_UTF8_INVALID || !predicate(c)) return false;
+
+    scanner->current += length;
+    scanner->column += (uint32_t)length;
+    return true;
+}
+
+static void consume_name(mt_Scanner *scanner) {
+    while (true) {
+        char c = *scanner->current;
+        if (is_alpha(c) || is_digit(c) || c == '_') {
+            scanner->current += 1;
+            scanner->column += 1;
+        } else if ((uint8_t)c < 0x80 || !match_code_point(scanner, mt_unicode_is_xid_continue)) {
+            break;
+        }
     }
+}
+
+static void load_name(mt_Scanner *scanner, mt_Token *token) {
+    consume_name(scanner);
 
     if (match_keyword(scanner, "and"))           load_token(scanner, token, mt_TOKEN_AND);
     else if (match_keyword(scanner, "def"))      load_token(scanner, token, mt_TOKEN_DEF);
@@ -199,6 +244,7 @@ static void load_name(mt_Scanner *scanner, mt_Token *token) {
     else if (match_keyword(scanner, "false"))    load_token(scanner, token, mt_TOKEN_FALSE);
     else if (match_keyword(scanner, "for"))      load_token(scanner, token, mt_TOKEN_FOR);
     else if (match_keyword(scanner, "if"))       load_token(scanner, token, mt_TOKEN_IF);
+    else if (match_keyword(scanner, "import"))   load_token(scanner, token, mt_TOKEN_IMPORT);
     else if (match_keyword(scanner, "in"))       load_token(scanner, token, mt_TOKEN_IN);
     else if (match_keyword(scanner, "match"))    load_token(scanner, token, mt_TOKEN_MATCH);
     else if (match_keyword(scanner, "not"))      load_token(scanner, token, mt_TOKEN_NOT);
@@ -213,61 +259,379 @@ static void load_name(mt_Scanner *scanner, mt_Token *token) {
 }
 
 static void load_cap_name(mt_Scanner *scanner, mt_Token *token) {
-    while (is_alpha(*scanner->current) || is_digit(*scanner->current) || *scanner->current == '_') {
-        scanner->current += 1;
-        scanner->column += 1;
+    consume_name(scanner);
+    load_token(scanner, token, mt_TOKEN_CAP_NAME);
+}
+
+/// Load a token that starts with a non-ASCII code point.  Only
+/// identifiers can, and they're names unless they start with an
+/// uppercase letter.
+static void load_unicode(mt_Scanner *scanner, mt_Token *token) {
+    size_t length;
+    uint32_t c = mt_utf8_decode(scanner->start, &length);
+    if (c == mt_UTF8_INVALID) {
+        snprintf(scanner->error, sizeof(scanner->error), "invalid UTF-8 byte 0x%02x", (uint8_t)*scanner->start);
+        fail_token(scanner, token, scanner->error);
+        return;
     }
 
-    load_token(scanner, token, mt_TOKEN_CAP_NAME);
+    scanner->current = scanner->start + length;
+    scanner->column += (uint32_t)length - 1;
+
+    if (!mt_unicode_is_xid_start(c)) {
+        snprintf(scanner->error, sizeof(scanner->error), "unexpected token '%.*s'", (int)length, scanner->start);
+        fail_token(scanner, token, scanner->error);
+    } else if (mt_unicode_is_upper(c)) {
+        load_cap_name(scanner, token);
+    } else {
+        load_name(scanner, token);
+    }
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/// Convert eight ASCII digits to an integer using SWAR: the digits
+/// are combined pairwise, then into groups of four and finally into
+/// a single value using three multiplications.
+static uint32_t parse_eight_digits(const char *digits) {
+    uint64_t value;
+    memcpy(&value, digits, sizeof(value));
+    value = (value & 0x0F0F0F0F0F0F0F0F) * 2561 >> 8;
+    value = (value & 0x00FF00FF00FF00FF) * 6553601 >> 16;
+    return (uint32_t)((value & 0x0000FFFF0000FFFF) * 42949672960001 >> 32);
+}
+#else
+static uint32_t parse_eight_digits(const char *digits) {
+    uint32_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = value * 10 + (uint32_t)(digits[i] - '0');
+    }
+
+    return value;
+}
+#endif
+
+/// Convert a run of at most 19 ASCII digits to an integer.  The run
+/// must already have been validated.
+static uint64_t parse_digits(const char *digits, size_t length) {
+    uint64_t value = 0;
+    while (length >= 8) {
+        value = value * 100000000 + parse_eight_digits(digits);
+        digits += 8;
+        length -= 8;
+    }
+
+    while (length > 0) {
+        value = value * 10 + (uint64_t)(*digits - '0');
+        digits += 1;
+        length -= 1;
+    }
+
+    return value;
+}
+
+static const uint64_t INTEGER_POWERS_OF_TEN[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL,
+};
+
+static const double DOUBLE_POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+#define MAX_INTEGER_DIGITS 19
+#define MAX_EXACT_MANTISSA (1ULL << 53)
+
+/// Compute the value of a float literal with "fraction_length"
+/// digits after the point.  When the digits fit in a double's
+/// mantissa and the power of ten is exactly representable, a single
+/// IEEE division is correctly rounded (Clinger's fast path).  Every
+/// other literal goes through strtod, on a copy of the text so that
+/// it can't read past the end of the token.
+static double parse_float(const char *start, size_t length, size_t fraction_length) {
+    size_t integer_length = length - fraction_length - 1;
+    if (integer_length + fraction_length <= MAX_INTEGER_DIGITS && fraction_length <= 22) {
+        uint64_t mantissa = parse_digits(start, integer_length) * INTEGER_POWERS_OF_TEN[fraction_length];
+        mantissa += parse_digits(start + integer_length + 1, fraction_length);
+        if (mantissa <= MAX_EXACT_MANTISSA) {
+            return (double)mantissa / DOUBLE_POWERS_OF_TEN[fraction_length];
+        }
+    }
+
+    char small[64];
+    char *buffer = small;
+    if (length >= sizeof(small)) {
+        buffer = malloc(length + 1);
+        if (!buffer) return strtod(start, NULL);
+    }
+
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    double value = strtod(buffer, NULL);
+    if (buffer != small) free(buffer);
+    return value;
 }
 
 static void load_number(mt_Scanner *scanner, mt_Token *token) {
     const char *error = NULL;
     bool failed = false;
-    bool point_found = false;
+    char *point = NULL;
     while (is_digit(*scanner->current) || *scanner->current == '.') {
         if (*scanner->current == '.') {
-            if (point_found) {
+            if (point) {
                 failed = true;
                 error = "multiple points in number";
             }
 
-            point_found = true;
+            point = scanner->current;
         }
 
         scanner->current += 1;
         scanner->column += 1;
     }
 
-    if (*scanner->start == '0' && scanner->current - scanner->start > 1) {
+    size_t length = (size_t)(scanner->current - scanner->start);
+    if (*scanner->start == '0' && length > 1 && scanner->start[1] != '.') {
         failed = true;
         error = "numbers cannot start with 0";
     }
 
+    if (!failed && !point && length > MAX_INTEGER_DIGITS) {
+        failed = true;
+        error = "integer literal is too large";
+    }
+
     if (failed) {
         fail_token(scanner, token, (char *)error);
+    } else if (point) {
+        load_token(scanner, token, mt_TOKEN_FLOAT);
+        token->value.as_double = parse_float(scanner->start, length, (size_t)(scanner->current - point - 1));
     } else {
-        load_token(scanner, token, mt_TOKEN_NUMBER);
+        uint64_t value = parse_digits(scanner->start, length);
+        if (value > INT64_MAX) {
+            fail_token(scanner, token, "integer literal is too large");
+            return;
+        }
+
+        load_token(scanner, token, mt_TOKEN_INTEGER);
+        token->value.as_integer = (int64_t)value;
     }
 }
 
-static void load_string(mt_Scanner *scanner, mt_Token *token) {
-    char pc = 0;
+/// Decoded string literals are stored in a list of blocks so that
+/// their addresses remain stable for as long as the scanner lives.
+struct StringBlock {
+    struct StringBlock *next;
+    size_t length;
+    size_t capacity;
+    char data[];
+};
+
+#define STRING_BLOCK_SIZE 4096
+
+static char *allocate_string(mt_Scanner *scanner, size_t length) {
+    struct StringBlock *block = scanner->strings;
+    if (!block || block->capacity - block->length < length) {
+        size_t capacity = MAX(length, STRING_BLOCK_SIZE);
+        mt_HEAP_SITE(site);
+        block = mt_heap_alloc(&site, NULL, sizeof(struct StringBlock) + capacity);
+        if (!block) return NULL;
+
+        mt_STATS_COUNT(mt_STATS_SCANNER, mt_STATS_STRING_BLOCKS);
+        block->next = scanner->strings;
+        block->length = 0;
+        block->capacity = capacity;
+        scanner->strings = block;
+    }
+
+    char *data = block->data + block->length;
+    block->length += length;
+    return data;
+}
+
+static void free_strings(struct StringBlock *block) {
+    while (block) {
+        struct StringBlock *next = block->next;
+        mt_heap_free(block);
+        block = next;
+    }
+}
+
+static bool is_string_special(char c) {
+    return c == '"' || c == '\\' || c == '\n' || c == '\0';
+}
+
+/// Find the first quote, backslash, newline or NUL at or after a
+/// position.  Aligned loads never cross a page boundary so reading
+/// past the terminator is harmless, but ASan can't know that.
+__attribute__((no_sanitize_address))
+static char *find_string_special(char *current) {
+#ifdef __SSE2__
+    while (((uintptr_t)current & 15) != 0) {
+        if (is_string_special(*current)) return current;
+        current += 1;
+    }
+
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i zero = _mm_setzero_si128();
+    while (true) {
+        __m128i chunk = _mm_load_si128((const __m128i *)current);
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, zero))
+        );
+
+        int mask = _mm_movemask_epi8(hits);
+        if (mask) return current + __builtin_ctz((unsigned)mask);
+        current += 16;
+    }
+#else
+    while (!is_string_special(*current)) current += 1;
+    return current;
+#endif
+}
 
+static int hex_value(char c) {
+    if (is_digit(c)) return c - '0';
+    if ('a' <= c && c <= 'f') return c - 'a' + 10;
+    if ('A' <= c && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/// Decode a single escape sequence, not including its backslash,
+/// into out.  Returns the number of bytes written or -1 if the
+/// sequence is invalid, in which case an error message is written to
+/// the scanner's error buffer.  *current is advanced past the
+/// sequence.
+static int decode_escape(mt_Scanner *scanner, char **current, char *end, char *out) {
+    char c = **current;
+    *current += 1;
+
+    switch (c) {
+    case 'n':  *out = '\n'; return 1;
+    case 't':  *out = '\t'; return 1;
+    case 'r':  *out = '\r'; return 1;
+    case '0':  *out = '\0'; return 1;
+    case '\\': *out = '\\'; return 1;
+    case '"':  *out = '"'; return 1;
+    case '\n': return 0;
+
+    case 'x': {
+        int hi = *current < end ? hex_value((*current)[0]) : -1;
+        int lo = *current + 1 < end ? hex_value((*current)[1]) : -1;
+        if (hi < 0 || lo < 0) {
+            snprintf(scanner->error, sizeof(scanner->error), "expected two hex digits after '\\x'");
+            return -1;
+        }
+
+        *current += 2;
+        *out = (char)(hi << 4 | lo);
+        return 1;
+    }
+
+    case 'u': {
+        uint32_t code_point = 0;
+        int digits = 0;
+        if (*current < end && **current == '{') {
+            *current += 1;
+            while (*current < end && digits <= 6 && hex_value(**current) >= 0) {
+                code_point = code_point << 4 | (uint32_t)hex_value(**current);
+                digits += 1;
+                *current += 1;
+            }
+        }
+
+        if (digits == 0 || digits > 6 || *current >= end || **current != '}') {
+            snprintf(scanner->error, sizeof(scanner->error), "expected 1 to 6 hex digits between braces after '\\u'");
+            return -1;
+        }
+
+        *current += 1;
+        size_t length = mt_utf8_encode(code_point, out);
+        if (length == 0) {
+            snprintf(scanner->error, sizeof(scanner->error), "'\\u{%X}' is not a valid code point", code_point);
+            return -1;
+        }
+
+        return (int)length;
+    }
+
+    default:
+        snprintf(scanner->error, sizeof(scanner->error), "unknown escape sequence '\\%c'", c);
+        return -1;
+    }
+}
+
+/// Decode the escape sequences in a string token into a copy owned
+/// by the scanner.  Every escape sequence is at least as long as what
+/// it decodes to so the copy is never longer than the literal.  Runs
+/// between backslashes are copied wholesale.
+static bool decode_string(mt_Scanner *scanner, mt_Token *token) {
+    mt_STATS_COUNT(mt_STATS_SCANNER, mt_STATS_DECODED_STRINGS);
+
+    char *current = token->start + 1;
+    char *end = token->start + token->length - 1;
+    char *out = allocate_string(scanner, (size_t)(end - current));
+    if (!out) {
+        snprintf(scanner->error, sizeof(scanner->error), "not enough memory to decode string literal");
+        return false;
+    }
+
+    token->value.as_string.data = out;
+    token->value.as_string.decoded = true;
+
+    size_t length = 0;
+    while (current < end) {
+        char *backslash = memchr(current, '\\', (size_t)(end - current));
+        if (!backslash) backslash = end;
+
+        memcpy(out + length, current, (size_t)(backslash - current));
+        length += (size_t)(backslash - current);
+        current = backslash;
+        if (current == end) break;
+
+        current += 1;
+        int n = decode_escape(scanner, &current, end, out + length);
+        if (n < 0) return false;
+        length += (size_t)n;
+    }
+
+    token->value.as_string.length = length;
+    return true;
+}
+
+static void load_string(mt_Scanner *scanner, mt_Token *token) {
+    bool escaped = false;
     uint32_t lines = 0;
-    uint32_t column = 0;
-    while (*scanner->current != '\0' && (*scanner->current != '"' || pc == '\\')) {
-        if (*scanner->current == '\n') {
+    char *newline = NULL;
+
+    char *current = scanner->current;
+    while (true) {
+        current = find_string_special(current);
+        if (*current == '"' || *current == '\0') break;
+
+        if (*current == '\\') {
+            escaped = true;
+            current += 1;
+            if (*current == '\0') break;
+        }
+
+        if (*current == '\n') {
             lines += 1;
-            column = 0;
+            newline = current;
         }
 
-        pc = *scanner->current;
-        scanner->current += 1;
-        scanner->column += 1;
-        column += 1;
+        current += 1;
     }
 
+    scanner->column += (uint32_t)(current - scanner->current);
+    scanner->current = current;
+
     if (*scanner->current == '\0') {
         // If the string is multiline, then the line and column of the
         // following token will be wrong.  That's OK though, since
@@ -281,9 +645,19 @@ static void load_string(mt_Scanner *scanner, mt_Token *token) {
     scanner->column += 1;
     load_token(scanner, token, mt_TOKEN_STRING);
 
+    token->value.as_string.data = token->start + 1;
+    token->value.as_string.length = token->length - 2;
+    token->value.as_string.decoded = false;
+    if (escaped && !decode_string(scanner, token)) {
+        token->type = mt_TOKEN_ERROR;
+        token->start = scanner->error;
+        token->length = strlen(scanner->error);
+        token->value.as_integer = 0;
+    }
+
     if (lines > 0) {
         scanner->line += lines;
-        scanner->column = column;
+        scanner->column = (uint32_t)(current - newline);
     }
 }
 
@@ -292,6 +666,7 @@ mt_Scanner *mt_scanner_init(char *buffer) {
     if (!scanner) return NULL;
 
     memset(scanner->error, 0, 255);
+    scanner->strings = NULL;
     scanner->start = buffer;
     scanner->current = buffer;
     scanner->line = 1;
@@ -300,7 +675,15 @@ mt_Scanner *mt_scanner_init(char *buffer) {
     return scanner;
 }
 
-void mt_scanner_scan(mt_Scanner *scanner, mt_Token *token) {
+static void fail_bang(mt_Scanner *scanner, mt_Token *token) {
+    snprintf(scanner->error, sizeof(scanner->error), "expected '=' after '!' but found '%c'", peek(scanner));
+    fail_token(scanner, token, scanner->error);
+
+    // Never step past the end of the buffer.
+    if (advance(scanner) == '\0') scanner->current = scanner->start;
+}
+
+void mt_scanner_scan_reference(mt_Scanner *scanner, mt_Token *token) {
     char c = advance(scanner);
 
     if (c == '_' || is_lo_alpha(c)) {
@@ -313,6 +696,11 @@ void mt_scanner_scan(mt_Scanner *scanner, mt_Token *token) {
         return;
     }
 
+    if ((uint8_t)c >= 0x80) {
+        load_unicode(scanner, token);
+        return;
+    }
+
     if (is_digit(c)) {
         load_number(scanner, token);
         return;
@@ -338,11 +726,7 @@ void mt_scanner_scan(mt_Scanner *scanner, mt_Token *token) {
 
     case '!':
         if (match(scanner, '=')) load_token(scanner, token, mt_TOKEN_BANG_EQUAL);
-        else {
-            snprintf(scanner->error, sizeof(scanner->error), "expected '=' after '!' but found '%c'", peek(scanner));
-            fail_token(scanner, token, scanner->error);
-            advance(scanner);
-        }
+        else                     fail_bang(scanner, token);
 
         break;
 
@@ -373,6 +757,602 @@ void mt_scanner_scan(mt_Scanner *scanner, mt_Token *token) {
     }
 }
 
+void mt_scanner_scan(mt_Scanner *scanner, mt_Token *token) {
+    char c = advance(scanner);
+
+    // Run the DFA for as long as it accepts input, remembering the
+    // last accepting state so the longest match can be recovered.
+    uint8_t state = SCANNER_TRANSITIONS[SCANNER_START][SCANNER_CLASS_MAP[(uint8_t)c]];
+    uint8_t accept = SCANNER_ACCEPTS[state];
+    char *accept_end = scanner->current;
+    char *current = scanner->current;
+    while (c != '\0') {
+        uint8_t next = SCANNER_TRANSITIONS[state][SCANNER_CLASS_MAP[(uint8_t)*current]];
+        if (next == SCANNER_DEAD) break;
+
+        state = next;
+        current += 1;
+        if (SCANNER_ACCEPTS[state] != SCANNER_ACCEPT_NONE) {
+            accept = SCANNER_ACCEPTS[state];
+            accept_end = current;
+        }
+    }
+
+    // The first byte was consumed by advance, before the loop.
+    mt_STATS_ADD(mt_STATS_SCANNER, mt_STATS_DFA_TRANSITIONS, current - scanner->current + 1);
+    scanner->column += (uint32_t)(accept_end - scanner->current);
+    scanner->current = accept_end;
+
+    switch (accept) {
+    case SCANNER_ACCEPT_NUMBER:  load_number(scanner, token); break;
+    case SCANNER_ACCEPT_STRING:  load_string(scanner, token); break;
+    case SCANNER_ACCEPT_COMMENT: load_comment(scanner, token); break;
+
+    case SCANNER_ACCEPT_NONE:
+        if (c == '!') {
+            fail_bang(scanner, token);
+            break;
+        }
+
+        if ((uint8_t)c >= 0x80) {
+            load_unicode(scanner, token);
+            break;
+        }
+
+        snprintf(scanner->error, sizeof(scanner->error), "unexpected token '%c'", c);
+        fail_token(scanner, token, scanner->error);
+        break;
+
+    default:
+        // The DFA only knows about ASCII, so names that continue past
+        // it are finished off by hand.
+        if (is_name_type((mt_TokenType)accept) && (uint8_t)*scanner->current >= 0x80) {
+            if (accept == mt_TOKEN_CAP_NAME) {
+                load_cap_name(scanner, token);
+            } else {
+                load_name(scanner, token);
+            }
+            break;
+        }
+
+        load_token(scanner, token, (mt_TokenType)accept);
+        break;
+    }
+
+    mt_STATS_COUNT(mt_STATS_TOKENS, token->type);
+}
+
 void mt_scanner_free(mt_Scanner *scanner) {
+    free_strings(scanner->strings);
     free(scanner);
 }
+
+
+/// TokenStream
+/// ===========
+
+mt_TokenStream *mt_token_stream_init() {
+    mt_TokenStream *stream = malloc(sizeof(mt_TokenStream));
+    if (!stream) return NULL;
+
+    stream->tokens = NULL;
+    stream->length = 0;
+    stream->capacity = 0;
+
+    return stream;
+}
+
+bool mt_token_stream_push(mt_TokenStream *stream, mt_Token *token) {
+    if (stream->length == stream->capacity) {
+        size_t capacity = stream->capacity ? stream->capacity * 2 : 256;
+        mt_Token *tokens = realloc(stream->tokens, sizeof(mt_Token) * capacity);
+        if (!tokens) return false;
+
+        stream->tokens = tokens;
+        stream->capacity = capacity;
+    }
+
+    mt_Token *dst = &stream->tokens[stream->length];
+    mt_token_copy(token, dst);
+
+    if (token->type == mt_TOKEN_ERROR) {
+        dst->start = malloc(sizeof(char) * (token->length + 1));
+        if (!dst->start) return false;
+
+        memcpy(dst->start, token->start, token->length);
+        dst->start[token->length] = '\0';
+    }
+
+    if (token->type == mt_TOKEN_STRING && token->value.as_string.decoded) {
+        size_t length = token->value.as_string.length;
+        dst->value.as_string.data = malloc(sizeof(char) * (length + 1));
+        if (!dst->value.as_string.data) return false;
+
+        memcpy(dst->value.as_string.data, token->value.as_string.data, length);
+        dst->value.as_string.data[length] = '\0';
+    }
+
+    stream->length += 1;
+    return true;
+}
+
+/// Free whatever a token in a stream owns.
+static void release_token(mt_Token *token) {
+    if (token->type == mt_TOKEN_ERROR) {
+        free(token->start);
+    } else if (token->type == mt_TOKEN_STRING && token->value.as_string.decoded) {
+        free(token->value.as_string.data);
+    }
+}
+
+void mt_token_stream_free(mt_TokenStream *stream) {
+    for (size_t i = 0; i < stream->length; i++) {
+        release_token(&stream->tokens[i]);
+    }
+
+    free(stream->tokens);
+    free(stream);
+}
+
+mt_TokenStream *mt_scanner_scan_all(char *source) {
+    mt_TokenStream *stream = mt_token_stream_init();
+    if (!stream) return NULL;
+
+    mt_Scanner *scanner = mt_scanner_init(source);
+    if (!scanner) goto fail;
+
+    mt_Token token;
+    do {
+        mt_scanner_scan(scanner, &token);
+        if (!mt_token_stream_push(stream, &token)) goto fail;
+    } while (token.type != mt_TOKEN_EOF);
+
+    mt_scanner_free(scanner);
+    return stream;
+
+fail:
+    if (scanner) mt_scanner_free(scanner);
+    mt_token_stream_free(stream);
+    return NULL;
+}
+
+
+/// Incremental scanning
+/// ====================
+
+char *mt_edit_apply(char *source, mt_Edit *edit) {
+    size_t length = strlen(source);
+    size_t new_length = length - edit->length + edit->text_length;
+    char *buffer = malloc(sizeof(char) * (new_length + 1));
+    if (!buffer) return NULL;
+
+    memcpy(buffer, source, edit->offset);
+    memcpy(buffer + edit->offset, edit->text, edit->text_length);
+    memcpy(
+        buffer + edit->offset + edit->text_length,
+        source + edit->offset + edit->length,
+        length - edit->offset - edit->length
+    );
+    buffer[new_length] = '\0';
+    return buffer;
+}
+
+/// Move a token to a new position in the source buffer, along with
+/// its value if it points into the source.
+static void rebase_token(mt_Token *token, char *start) {
+    token->start = start;
+    if (token->type == mt_TOKEN_STRING && !token->value.as_string.decoded) {
+        token->value.as_string.data = start + 1;
+    }
+}
+
+static bool is_positional(mt_Token *token) {
+    return token->type != mt_TOKEN_ERROR && token->type != mt_TOKEN_EOF;
+}
+
+bool mt_token_stream_edit(
+    mt_TokenStream *stream,
+    char *old_source,
+    char *new_source,
+    mt_Edit *edit,
+    mt_TokenSplice *splice
+) {
+    mt_Token *tokens = stream->tokens;
+    ptrdiff_t delta = (ptrdiff_t)edit->text_length - (ptrdiff_t)edit->length;
+    size_t edit_end = edit->offset + edit->length;
+
+    // Every token that starts before the edit ends before the last
+    // such token starts, so rescanning from it is enough.
+    size_t restart = 0;
+    bool found = false;
+    for (size_t i = stream->length; i > 0; i--) {
+        mt_Token *token = &tokens[i - 1];
+        if (is_positional(token) && (size_t)(token->start - old_source) < edit->offset) {
+            restart = i - 1;
+            found = true;
+            break;
+        }
+    }
+
+    mt_Scanner scanner;
+    memset(scanner.error, 0, sizeof(scanner.error));
+    scanner.strings = NULL;
+    if (found) {
+        scanner.current = new_source + (tokens[restart].start - old_source);
+        scanner.line = tokens[restart].line;
+        scanner.column = tokens[restart].column - 1;
+    } else {
+        scanner.current = new_source;
+        scanner.line = 1;
+        scanner.column = 0;
+    }
+    scanner.start = scanner.current;
+
+    mt_TokenStream *scanned = mt_token_stream_init();
+    if (!scanned) return false;
+
+    // A rescanned token past the edit that starts at the same offset
+    // and column as an old token was scanned from the same state, so
+    // every token from there on is the same modulo its line number.
+    size_t resync = stream->length;
+    size_t candidate = restart;
+    mt_Token token;
+    while (true) {
+        mt_scanner_scan(&scanner, &token);
+
+        if (is_positional(&token)) {
+            size_t offset = (size_t)(token.start - new_source);
+            if (offset >= edit->offset + edit->text_length) {
+                size_t old_offset = (size_t)((ptrdiff_t)offset - delta);
+                while (candidate < stream->length && (
+                           !is_positional(&tokens[candidate]) ||
+                           (size_t)(tokens[candidate].start - old_source) < old_offset)) {
+                    candidate += 1;
+                }
+
+                mt_Token *old = candidate < stream->length ? &tokens[candidate] : NULL;
+                if (old &&
+                    old_offset >= edit_end &&
+                    (size_t)(old->start - old_source) == old_offset &&
+                    old->type == token.type &&
+                    old->length == token.length &&
+                    old->column == token.column) {
+                    resync = candidate;
+                    break;
+                }
+            }
+        }
+
+        if (!mt_token_stream_push(scanned, &token)) goto fail;
+        if (token.type == mt_TOKEN_EOF) break;
+    }
+
+    size_t removed = resync - restart;
+    size_t new_length = stream->length - removed + scanned->length;
+    if (new_length > stream->capacity) {
+        tokens = realloc(stream->tokens, sizeof(mt_Token) * new_length);
+        if (!tokens) goto fail;
+
+        stream->tokens = tokens;
+        stream->capacity = new_length;
+    }
+
+    for (size_t i = restart; i < resync; i++) {
+        release_token(&tokens[i]);
+    }
+
+    int64_t line_delta = resync < stream->length ? (int64_t)token.line - tokens[resync].line : 0;
+    memmove(
+        &tokens[restart + scanned->length],
+        &tokens[resync],
+        sizeof(mt_Token) * (stream->length - resync)
+    );
+    memcpy(&tokens[restart], scanned->tokens, sizeof(mt_Token) * scanned->length);
+
+    for (size_t i = 0; i < restart; i++) {
+        if (tokens[i].type != mt_TOKEN_ERROR) {
+            rebase_token(&tokens[i], new_source + (tokens[i].start - old_source));
+        }
+    }
+
+    for (size_t i = restart + scanned->length; i < new_length; i++) {
+        if (tokens[i].type != mt_TOKEN_ERROR) {
+            rebase_token(&tokens[i], new_source + (tokens[i].start - old_source) + delta);
+        }
+
+        tokens[i].line = (uint32_t)((int64_t)tokens[i].line + line_delta);
+    }
+
+    if (splice) {
+        splice->start = restart;
+        splice->removed = removed;
+        splice->inserted = scanned->length;
+    }
+
+    stream->length = new_length;
+
+    // Ownership of the error messages and decoded strings was
+    // transferred to the stream.
+    scanned->length = 0;
+    mt_token_stream_free(scanned);
+    free_strings(scanner.strings);
+    return true;
+
+fail:
+    mt_token_stream_free(scanned);
+    free_strings(scanner.strings);
+    return false;
+}
+
+
+/// Parallel scanning
+/// =================
+///
+/// The buffer is split into chunks that each start right after a
+/// newline, so the only scanner state that can carry over a chunk
+/// boundary is "inside a (multiline) string literal".  Every chunk
+/// is lexed twice, speculatively: once assuming it starts outside
+/// of a string and once assuming it starts inside one.  Tokens are
+/// assigned to the chunk their first character is in and lines are
+/// counted relative to the start of the chunk.  A final linear pass
+/// then walks the chunks, picks whichever speculation matches the
+/// state the previous chunk left off in and shifts line numbers.
+/// Anything neither speculation accounts for (eg. an error that
+/// swallowed the first character of the next chunk) is rescanned
+/// sequentially during that pass.
+
+typedef struct {
+    mt_TokenStream *stream;
+
+    bool ok;  ///< false if scanning ran out of memory
+    bool valid;  ///< false if the speculation turned out to be impossible
+    bool eof;  ///< whether the EOF token was reached
+
+    char *entry;  ///< where scanning began
+    uint32_t entry_line;
+    uint32_t entry_column;
+
+    bool spilled;  ///< whether the last token extends past the end of the chunk
+    char *exit;  ///< where the next token would be scanned from
+    uint32_t exit_line;
+    uint32_t exit_column;
+} ChunkScan;
+
+typedef struct {
+    char *start;
+    char *end;
+    bool first;
+    uint32_t newlines;
+
+    ChunkScan outside;
+    ChunkScan inside;
+} Chunk;
+
+static bool is_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static void scan_chunk(Chunk *chunk, ChunkScan *scan, char *from, uint32_t line, uint32_t column) {
+    mt_Scanner scanner;
+    mt_Token token;
+
+    scan->ok = true;
+    scan->valid = true;
+    scan->eof = false;
+    scan->entry = from;
+    scan->entry_line = line;
+    scan->entry_column = column;
+
+    scan->stream = mt_token_stream_init();
+    if (!scan->stream) {
+        scan->ok = false;
+        return;
+    }
+
+    memset(scanner.error, 0, sizeof(scanner.error));
+    scanner.strings = NULL;
+    scanner.start = from;
+    scanner.current = from;
+    scanner.line = line;
+    scanner.column = column;
+
+    while (true) {
+        // Peek past the whitespace so that tokens belonging to the
+        // next chunk are never scanned, since they may be arbitrarily
+        // long.
+        char *next = scanner.current;
+        while (is_whitespace(*next)) next++;
+        if (next >= chunk->end && *next != '\0') break;
+
+        mt_scanner_scan(&scanner, &token);
+        if (!mt_token_stream_push(scan->stream, &token)) {
+            free_strings(scanner.strings);
+            scan->ok = false;
+            return;
+        }
+
+        if (token.type == mt_TOKEN_EOF) {
+            scan->eof = true;
+            break;
+        }
+    }
+
+    free_strings(scanner.strings);
+    scan->spilled = scanner.current > chunk->end;
+    scan->exit = scanner.current;
+    scan->exit_line = scanner.line;
+    scan->exit_column = scanner.column;
+}
+
+static void scan_chunk_inside_string(Chunk *chunk) {
+    // This mirrors "load_string".  Chunks always start after a newline
+    // so the first character can never be escaped.
+    char *newline = chunk->start - 1;
+    uint32_t lines = 0;
+
+    char *current = chunk->start;
+    while (current < chunk->end && *current != '"') {
+        if (*current == '\\' && current + 1 < chunk->end) current += 1;
+        if (*current == '\n') {
+            newline = current;
+            lines += 1;
+        }
+
+        current += 1;
+    }
+
+    if (current >= chunk->end) {
+        chunk->inside.ok = true;
+        chunk->inside.valid = false;
+        chunk->inside.stream = NULL;
+        return;
+    }
+
+    scan_chunk(chunk, &chunk->inside, current + 1, 1 + lines, (uint32_t)(current - newline));
+}
+
+static void *scan_chunk_worker(void *arg) {
+    Chunk *chunk = arg;
+
+    chunk->newlines = 0;
+    for (char *c = chunk->start; c < chunk->end; c++) {
+        if (*c == '\n') chunk->newlines += 1;
+    }
+
+    scan_chunk(chunk, &chunk->outside, chunk->start, 1, 0);
+    if (!chunk->first) {
+        scan_chunk_inside_string(chunk);
+    } else {
+        chunk->inside.ok = true;
+        chunk->inside.valid = false;
+        chunk->inside.stream = NULL;
+    }
+
+    return NULL;
+}
+
+static bool stitch_chunk_scan(mt_TokenStream *stream, ChunkScan *scan, uint32_t base_line) {
+    for (size_t i = 0; i < scan->stream->length; i++) {
+        mt_Token *token = &scan->stream->tokens[i];
+        token->line += base_line - 1;
+        if (!mt_token_stream_push(stream, token)) return false;
+    }
+
+    return true;
+}
+
+mt_TokenStream *mt_scanner_scan_parallel(char *source, size_t nthreads) {
+    size_t length = strlen(source);
+    if (nthreads <= 1 || length == 0) {
+        return mt_scanner_scan_all(source);
+    }
+
+    Chunk *chunks = calloc(nthreads, sizeof(Chunk));
+    pthread_t *threads = calloc(nthreads, sizeof(pthread_t));
+    mt_TokenStream *stream = mt_token_stream_init();
+    ChunkScan fallback = { .stream = NULL };
+    size_t nchunks = 0;
+    size_t nspawned = 0;
+    bool ok = chunks && threads && stream;
+    if (!ok) goto done;
+
+    char *end = source + length;
+    char *start = source;
+    size_t chunk_size = MAX(length / nthreads, 1);
+    while (start < end && nchunks < nthreads) {
+        char *chunk_end = start + chunk_size;
+        if (nchunks == nthreads - 1 || chunk_end >= end) {
+            chunk_end = end;
+        } else {
+            chunk_end = memchr(chunk_end, '\n', (size_t)(end - chunk_end));
+            chunk_end = chunk_end ? chunk_end + 1 : end;
+        }
+
+        chunks[nchunks].start = start;
+        chunks[nchunks].end = chunk_end;
+        chunks[nchunks].first = nchunks == 0;
+        nchunks += 1;
+        start = chunk_end;
+    }
+
+    for (; nspawned < nchunks; nspawned++) {
+        if (pthread_create(&threads[nspawned], NULL, scan_chunk_worker, &chunks[nspawned]) != 0) {
+            ok = false;
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < nspawned; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    if (!ok) goto done;
+
+    bool at_start = true;
+    char *resume = NULL;
+    uint32_t resume_line = 0;
+    uint32_t resume_column = 0;
+    uint32_t base_line = 1;
+    for (size_t i = 0; i < nchunks; i++) {
+        Chunk *chunk = &chunks[i];
+        ChunkScan *scan = NULL;
+
+        if (!chunk->outside.ok || !chunk->inside.ok) {
+            ok = false;
+            goto done;
+        }
+
+        if (at_start) {
+            scan = &chunk->outside;
+        } else if (resume < chunk->end) {
+            uint32_t line = resume_line - base_line + 1;
+            if (chunk->inside.valid &&
+                chunk->inside.entry == resume &&
+                chunk->inside.entry_line == line &&
+                chunk->inside.entry_column == resume_column) {
+                scan = &chunk->inside;
+            } else {
+                if (fallback.stream) mt_token_stream_free(fallback.stream);
+                scan_chunk(chunk, &fallback, resume, line, resume_column);
+                if (!fallback.ok) {
+                    ok = false;
+                    goto done;
+                }
+
+                scan = &fallback;
+            }
+        }
+
+        if (scan) {
+            if (!stitch_chunk_scan(stream, scan, base_line)) {
+                ok = false;
+                goto done;
+            }
+
+            if (scan->eof) break;
+
+            at_start = !scan->spilled;
+            resume = scan->exit;
+            resume_line = scan->exit_line + base_line - 1;
+            resume_column = scan->exit_column;
+        }
+
+        base_line += chunk->newlines;
+    }
+
+done:
+    if (fallback.stream) mt_token_stream_free(fallback.stream);
+    for (size_t i = 0; chunks && i < nchunks; i++) {
+        if (chunks[i].outside.stream) mt_token_stream_free(chunks[i].outside.stream);
+        if (chunks[i].inside.stream) mt_token_stream_free(chunks[i].inside.stream);
+    }
+
+    free(chunks);
+    free(threads);
+    if (!ok && stream) {
+        mt_token_stream_free(stream);
+        return NULL;
+    }
+
+    return stream;
+}
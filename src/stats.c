@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "parser.h"
+#include "scanner.h"
+#include "stats.h"
+
+uint64_t mt_stats[mt_STATS_GROUP_COUNT][mt_STATS_MAX_KEYS];
+
+_Static_assert(mt_TOKEN_WITH < mt_STATS_MAX_KEYS, "every token type must fit in a stats group");
+
+static const char *GROUP_NAMES[] = {
+    "tokens",
+    "nodes",
+    "declarations",
+    "lookups",
+    "scanner",
+};
+
+static const char *DECLARATION_NAMES[] = {
+    "DEF",
+    "RECORD",
+    "EXTEND",
+    "PROTOCOL",
+    "IMPORT",
+};
+
+static const char *BINDING_NAMES[] = {
+    "UNRESOLVED",
+    "LOCAL",
+    "GLOBAL",
+    "BUILTIN",
+};
+
+static const char *SCANNER_EVENT_NAMES[] = {
+    "DFA_TRANSITIONS",
+    "DECODED_STRINGS",
+    "STRING_BLOCKS",
+};
+
+static const char *key_name(mt_StatsGroup group, int key) {
+    switch (group) {
+    case mt_STATS_TOKENS:       return mt_token_type_name((mt_TokenType)key);
+    case mt_STATS_NODES:        return mt_node_type_name((mt_NodeType)key);
+    case mt_STATS_DECLARATIONS: return DECLARATION_NAMES[key];
+    case mt_STATS_LOOKUPS:      return BINDING_NAMES[key];
+    case mt_STATS_SCANNER:      return SCANNER_EVENT_NAMES[key];
+    default:                    return "?";
+    }
+}
+
+typedef struct {
+    int key;
+    uint64_t count;
+} Row;
+
+static int compare_rows(const void *a, const void *b) {
+    const Row *x = a;
+    const Row *y = b;
+    if (x->count != y->count) return x->count > y->count ? -1 : 1;
+    return x->key - y->key;
+}
+
+void mt_stats_report(FILE *out) {
+    for (int group = 0; group < mt_STATS_GROUP_COUNT; group++) {
+        Row rows[mt_STATS_MAX_KEYS];
+        int nrows = 0;
+        uint64_t total = 0;
+        for (int key = 0; key < mt_STATS_MAX_KEYS; key++) {
+            uint64_t count = __atomic_load_n(&mt_stats[group][key], __ATOMIC_RELAXED);
+            if (count == 0) continue;
+
+            rows[nrows].key = key;
+            rows[nrows].count = count;
+            nrows++;
+            total += count;
+        }
+
+        if (nrows == 0) continue;
+
+        qsort(rows, nrows, sizeof(Row), compare_rows);
+        if (group == mt_STATS_SCANNER) {
+            fprintf(out, "%s:\n", GROUP_NAMES[group]);
+        } else {
+            fprintf(out, "%s: %llu\n", GROUP_NAMES[group], (unsigned long long)total);
+        }
+        for (int i = 0; i < nrows; i++) {
+            fprintf(out, "  %-20s %12llu", key_name(group, rows[i].key), (unsigned long long)rows[i].count);
+
+            // Scanner events count different things, so they don't
+            // add up to anything meaningful.
+            if (group != mt_STATS_SCANNER) {
+                fprintf(out, " %6.2f%%", 100.0 * (double)rows[i].count / (double)total);
+            }
+
+            fputc('\n', out);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "heap.h"
+#include "str.h"
+
+uint32_t mt_string_hash(const char *data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static bool is_small(const mt_String *string) {
+    return string->length <= mt_STRING_SMALL_CAPACITY;
+}
+
+bool mt_string_init(mt_String *string, const char *data, size_t length) {
+    string->length = (uint32_t)length;
+    string->hash = mt_string_hash(data, length);
+    string->owned = false;
+
+    if (is_small(string)) {
+        memcpy(string->as.small, data, length);
+        string->as.small[length] = '\0';
+        return true;
+    }
+
+    mt_HEAP_SITE(site);
+    char *copy = mt_heap_alloc(&site, NULL, sizeof(char) * (length + 1));
+    if (!copy) return false;
+
+    memcpy(copy, data, length);
+    copy[length] = '\0';
+    string->as.large = copy;
+    string->owned = true;
+    return true;
+}
+
+void mt_string_init_view(mt_String *string, const char *data, size_t length) {
+    if (length <= mt_STRING_SMALL_CAPACITY) {
+        mt_string_init(string, data, length);
+        return;
+    }
+
+    string->length = (uint32_t)length;
+    string->hash = mt_string_hash(data, length);
+    string->owned = false;
+    string->as.large = data;
+}
+
+const char *mt_string_data(const mt_String *string) {
+    return is_small(string) ? string->as.small : string->as.large;
+}
+
+bool mt_string_equal(const mt_String *a, const mt_String *b) {
+    if (a->length != b->length || a->hash != b->hash) return false;
+    return memcmp(mt_string_data(a), mt_string_data(b), a->length) == 0;
+}
+
+void mt_string_free(mt_String *string) {
+    if (string->owned) mt_heap_free((char *)string->as.large);
+    string->owned = false;
+}
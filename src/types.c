@@ -0,0 +1,328 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parser.h"
+#include "scanner.h"
+#include "str.h"
+#include "types.h"
+
+mt_TypeTable *mt_types_init() {
+    mt_TypeTable *table = malloc(sizeof(mt_TypeTable));
+    if (!table) return NULL;
+
+    table->shapes = NULL;
+    table->shape_count = 0;
+    table->shape_capacity = 0;
+
+    memset(table->error, 0, TYPES_ERROR_LENGTH);
+    table->error_line = 0;
+    table->error_column = 0;
+
+    return table;
+}
+
+const char *mt_types_tag_name(mt_TypeTag tag) {
+    switch (tag) {
+    case mt_TYPE_UNKNOWN: return "UNKNOWN";
+    case mt_TYPE_INTEGER: return "INTEGER";
+    case mt_TYPE_FLOAT:   return "FLOAT";
+    case mt_TYPE_STRING:  return "STRING";
+    case mt_TYPE_BOOLEAN: return "BOOLEAN";
+    case mt_TYPE_RECORD:  return "RECORD";
+    }
+
+    return "UNKNOWN";
+}
+
+
+/// Shapes
+/// ======
+
+typedef struct {
+    mt_TypeTable *table;
+    mt_Scanner *scanner;
+    mt_Token token;
+    mt_Token previous;
+} Reader;
+
+static void read_error(Reader *reader, const char *message, mt_Shape *shape) {
+    snprintf(
+        reader->table->error,
+        TYPES_ERROR_LENGTH,
+        message,
+        (int)shape->name.length,
+        mt_string_data(&shape->name)
+    );
+    reader->table->error_line = reader->token.line;
+    reader->table->error_column = reader->token.column;
+}
+
+static bool next(Reader *reader) {
+    mt_token_copy(&reader->token, &reader->previous);
+    do {
+        mt_scanner_scan(reader->scanner, &reader->token);
+    } while (reader->token.type == mt_TOKEN_COMMENT);
+
+    if (reader->token.type == mt_TOKEN_ERROR) {
+        snprintf(reader->table->error, TYPES_ERROR_LENGTH, "%.*s", (int)reader->token.length, reader->token.start);
+        reader->table->error_line = reader->token.line;
+        reader->table->error_column = reader->token.column;
+        return false;
+    }
+
+    return true;
+}
+
+/// Skip from an opening bracket or paren to the one that closes it.
+static bool skip_group(Reader *reader, mt_TokenType open, mt_TokenType close, mt_Shape *shape) {
+    uint32_t depth = 0;
+    do {
+        if (reader->token.type == mt_TOKEN_EOF) {
+            read_error(reader, "unexpected end of file in '%.*s'", shape);
+            return false;
+        }
+
+        if (reader->token.type == open) depth++;
+        if (reader->token.type == close) depth--;
+        if (!next(reader)) return false;
+    } while (depth > 0);
+
+    return true;
+}
+
+static bool is_shape_end(Reader *reader) {
+    // Same rule as skimming: "end" closes a block only when it starts
+    // a line, otherwise it's a field named "end".
+    return reader->token.type == mt_TOKEN_END && reader->previous.line != reader->token.line;
+}
+
+static bool add_field(mt_Shape *shape, uint32_t *capacity, mt_Field **field) {
+    if (shape->field_count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 8;
+        mt_Field *fields = realloc(shape->fields, sizeof(mt_Field) * *capacity);
+        if (!fields) return false;
+        shape->fields = fields;
+    }
+
+    *field = &shape->fields[shape->field_count];
+    (*field)->index = shape->field_count++;
+    return true;
+}
+
+/// Read the body of a record, eg. "Integer start, Integer end,", or
+/// of a protocol, eg. "Boolean has_more(self)".
+static bool read_shape(Reader *reader, mt_Shape *shape) {
+    uint32_t capacity = 0;
+
+    if (!next(reader)) return false;
+    if (reader->token.type == mt_TOKEN_LBRACKET) {
+        if (!skip_group(reader, mt_TOKEN_LBRACKET, mt_TOKEN_RBRACKET, shape)) return false;
+    }
+
+    while (!is_shape_end(reader)) {
+        mt_Field *field;
+        if (!add_field(shape, &capacity, &field)) {
+            read_error(reader, "not enough memory to read '%.*s'", shape);
+            return false;
+        }
+
+        field->type = mt_TYPE_UNKNOWN;
+        field->record = 0;
+        mt_string_init_view(&field->type_name, "", 0);
+        if (reader->token.type == mt_TOKEN_CAP_NAME) {
+            mt_string_init_view(&field->type_name, reader->token.start, reader->token.length);
+            if (!next(reader)) return false;
+            if (reader->token.type == mt_TOKEN_LBRACKET) {
+                if (!skip_group(reader, mt_TOKEN_LBRACKET, mt_TOKEN_RBRACKET, shape)) return false;
+            }
+        } else if (shape->type == mt_DECLARATION_RECORD) {
+            read_error(reader, "expected a field type in record '%.*s'", shape);
+            return false;
+        }
+
+        bool is_name = reader->token.type == mt_TOKEN_NAME || (reader->token.type == mt_TOKEN_END && !is_shape_end(reader));
+        if (!is_name) {
+            read_error(reader, "expected a field name in '%.*s'", shape);
+            return false;
+        }
+
+        mt_string_init_view(&field->name, reader->token.start, reader->token.length);
+        if (!next(reader)) return false;
+
+        if (shape->type == mt_DECLARATION_PROTOCOL) {
+            if (reader->token.type != mt_TOKEN_LPAREN) {
+                read_error(reader, "expected a parameter list in protocol '%.*s'", shape);
+                return false;
+            }
+
+            if (!skip_group(reader, mt_TOKEN_LPAREN, mt_TOKEN_RPAREN, shape)) return false;
+        }
+
+        if (reader->token.type == mt_TOKEN_COMMA) {
+            if (!next(reader)) return false;
+        } else if (reader->token.type == mt_TOKEN_EOF) {
+            read_error(reader, "unexpected end of file in '%.*s'", shape);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static mt_TypeTag tag_from_name(mt_TypeTable *table, mt_String *name, uint32_t *record) {
+    static const struct {
+        const char *name;
+        mt_TypeTag tag;
+    } BUILTIN_TYPES[] = {
+        { "Integer", mt_TYPE_INTEGER },
+        { "Float", mt_TYPE_FLOAT },
+        { "String", mt_TYPE_STRING },
+        { "Boolean", mt_TYPE_BOOLEAN },
+    };
+
+    const char *data = mt_string_data(name);
+    for (size_t i = 0; i < sizeof(BUILTIN_TYPES) / sizeof(BUILTIN_TYPES[0]); i++) {
+        const char *builtin = BUILTIN_TYPES[i].name;
+        if (name->length == strlen(builtin) && memcmp(data, builtin, name->length) == 0) {
+            return BUILTIN_TYPES[i].tag;
+        }
+    }
+
+    mt_Shape *shape = mt_types_shape(table, name);
+    if (shape && shape->type == mt_DECLARATION_RECORD) {
+        *record = (uint32_t)(shape - table->shapes);
+        return mt_TYPE_RECORD;
+    }
+
+    return mt_TYPE_UNKNOWN;
+}
+
+bool mt_types_load(mt_TypeTable *table, char *source, mt_DeclarationList *declarations) {
+    Reader reader = { .table = table };
+    for (size_t i = 0; i < declarations->length; i++) {
+        mt_Declaration *declaration = &declarations->declarations[i];
+        if (declaration->type != mt_DECLARATION_RECORD && declaration->type != mt_DECLARATION_PROTOCOL) continue;
+
+        if (table->shape_count == table->shape_capacity) {
+            uint32_t capacity = table->shape_capacity ? table->shape_capacity * 2 : 16;
+            mt_Shape *shapes = realloc(table->shapes, sizeof(mt_Shape) * capacity);
+            if (!shapes) goto oom;
+            table->shapes = shapes;
+            table->shape_capacity = capacity;
+        }
+
+        mt_Shape *shape = &table->shapes[table->shape_count++];
+        shape->type = declaration->type;
+        shape->fields = NULL;
+        shape->field_count = 0;
+        mt_string_init_view(&shape->name, declaration->name, declaration->name_length);
+
+        // Headers never span lines, so the body starts on the same
+        // line as the declaration.
+        reader.scanner = mt_scanner_init(source + declaration->body);
+        if (!reader.scanner) goto oom;
+        reader.scanner->line = declaration->line;
+        reader.scanner->column = declaration->column + (uint32_t)(declaration->body - declaration->start);
+        reader.token = (mt_Token){ .type = mt_TOKEN_EOF, .line = declaration->line };
+
+        bool ok = read_shape(&reader, shape);
+        mt_scanner_free(reader.scanner);
+        if (!ok) return false;
+    }
+
+    // Records may refer to records declared after them, so field
+    // types can only be resolved once every shape is known.
+    for (uint32_t i = 0; i < table->shape_count; i++) {
+        mt_Shape *shape = &table->shapes[i];
+        for (uint32_t j = 0; j < shape->field_count; j++) {
+            mt_Field *field = &shape->fields[j];
+            field->type = tag_from_name(table, &field->type_name, &field->record);
+        }
+    }
+
+    return true;
+
+oom:
+    snprintf(table->error, TYPES_ERROR_LENGTH, "not enough memory");
+    table->error_line = 0;
+    table->error_column = 0;
+    return false;
+}
+
+mt_Shape *mt_types_shape(mt_TypeTable *table, mt_String *name) {
+    for (uint32_t i = 0; i < table->shape_count; i++) {
+        if (mt_string_equal(&table->shapes[i].name, name)) return &table->shapes[i];
+    }
+
+    return NULL;
+}
+
+mt_Field *mt_types_field(mt_Shape *shape, mt_String *name) {
+    for (uint32_t i = 0; i < shape->field_count; i++) {
+        if (mt_string_equal(&shape->fields[i].name, name)) return &shape->fields[i];
+    }
+
+    return NULL;
+}
+
+
+/// Inference
+/// =========
+
+mt_TypeTag mt_types_of_node(mt_Node *node) {
+    switch (node->type) {
+    case mt_NODE_INTEGER: return mt_TYPE_INTEGER;
+    case mt_NODE_FLOAT:   return mt_TYPE_FLOAT;
+    case mt_NODE_STRING:  return mt_TYPE_STRING;
+    default:              return mt_TYPE_UNKNOWN;
+    }
+}
+
+mt_Specialization mt_types_specialize(mt_TokenType operator, mt_TypeTag lhs, mt_TypeTag rhs) {
+    mt_Specialization generic = { .operands = mt_TYPE_UNKNOWN, .result = mt_TYPE_UNKNOWN };
+    if (lhs != rhs) return generic;
+
+    switch (operator) {
+    case mt_TOKEN_PLUS:
+        if (lhs == mt_TYPE_STRING) return (mt_Specialization){ lhs, lhs };
+        // fallthrough
+    case mt_TOKEN_MINUS:
+    case mt_TOKEN_STAR:
+    case mt_TOKEN_SLASH:
+        if (lhs == mt_TYPE_INTEGER || lhs == mt_TYPE_FLOAT) return (mt_Specialization){ lhs, lhs };
+        return generic;
+
+    case mt_TOKEN_PERCENT:
+        if (lhs == mt_TYPE_INTEGER) return (mt_Specialization){ lhs, lhs };
+        return generic;
+
+    case mt_TOKEN_LESS:
+    case mt_TOKEN_LESS_EQUAL:
+    case mt_TOKEN_GREATER:
+    case mt_TOKEN_GREATER_EQUAL:
+        if (lhs == mt_TYPE_INTEGER || lhs == mt_TYPE_FLOAT) return (mt_Specialization){ lhs, mt_TYPE_BOOLEAN };
+        return generic;
+
+    case mt_TOKEN_EQUAL_EQUAL:
+    case mt_TOKEN_BANG_EQUAL:
+        if (lhs == mt_TYPE_UNKNOWN || lhs == mt_TYPE_RECORD) return generic;
+        return (mt_Specialization){ lhs, mt_TYPE_BOOLEAN };
+
+    default:
+        return generic;
+    }
+}
+
+void mt_types_free(mt_TypeTable *table) {
+    if (!table) return;
+
+    for (uint32_t i = 0; i < table->shape_count; i++) {
+        free(table->shapes[i].fields);
+    }
+
+    free(table->shapes);
+    free(table);
+}
@@ -0,0 +1,371 @@
+// Generated by tools/gen_unicode_table.py from Unicode 14.0.0.  Do not edit.
+
+static const uint32_t XID_START_RANGES[] = {
+    0x00055000, 0x0005a800, 0x0005d000, 0x00060016, 0x0006c01e, 0x0007c1c9,
+    0x0016300b, 0x00170004, 0x00176000, 0x00177000, 0x001b8004, 0x001bb001,
+    0x001bd802, 0x001bf800, 0x001c3000, 0x001c4002, 0x001c6000, 0x001c7013,
+    0x001d1852, 0x001fb88a, 0x002450a5, 0x00298825, 0x002ac800, 0x002b0028,
+    0x002e801a, 0x002f7803, 0x0031002a, 0x00337001, 0x00338862, 0x0036a800,
+    0x00372801, 0x00377001, 0x0037d002, 0x0037f800, 0x00388000, 0x0038901d,
+    0x003a6858, 0x003d8800, 0x003e5020, 0x003fa001, 0x003fd000, 0x00400015,
+    0x0040d000, 0x00412000, 0x00414000, 0x00420018, 0x0043000a, 0x00438017,
+    0x00444805, 0x00450029, 0x00482035, 0x0049e800, 0x004a8000, 0x004ac009,
+    0x004b880f, 0x004c2807, 0x004c7801, 0x004c9815, 0x004d5006, 0x004d9000,
+    0x004db003, 0x004de800, 0x004e7000, 0x004ee001, 0x004ef802, 0x004f8001,
+    0x004fe000, 0x00502805, 0x00507801, 0x00509815, 0x00515006, 0x00519001,
+    0x0051a801, 0x0051c001, 0x0052c803, 0x0052f000, 0x00539002, 0x00542808,
+    0x00547802, 0x00549815, 0x00555006, 0x00559001, 0x0055a804, 0x0055e800,
+    0x00568000, 0x00570001, 0x0057c800, 0x00582807, 0x00587801, 0x00589815,
+    0x00595006, 0x00599001, 0x0059a804, 0x0059e800, 0x005ae001, 0x005af802,
+    0x005b8800, 0x005c1800, 0x005c2805, 0x005c7002, 0x005c9003, 0x005cc801,
+    0x005ce000, 0x005cf001, 0x005d1801, 0x005d4002, 0x005d700b, 0x005e8000,
+    0x00602807, 0x00607002, 0x00609016, 0x0061500f, 0x0061e800, 0x0062c002,
+    0x0062e800, 0x00630001, 0x00640000, 0x00642807, 0x00647002, 0x00649016,
+    0x00655009, 0x0065a804, 0x0065e800, 0x0066e801, 0x00670001, 0x00678801,
+    0x00682008, 0x00687002, 0x00689028, 0x0069e800, 0x006a7000, 0x006aa002,
+    0x006af802, 0x006bd005, 0x006c2811, 0x006cd017, 0x006d9808, 0x006de800,
+    0x006e0006, 0x0070082f, 0x00719000, 0x00720006, 0x00740801, 0x00742000,
+    0x00743004, 0x00746017, 0x00752800, 0x00753809, 0x00759000, 0x0075e800,
+    0x00760004, 0x00763000, 0x0076e003, 0x00780000, 0x007a0007, 0x007a4823,
+    0x007c4004, 0x0080002a, 0x0081f800, 0x00828005, 0x0082d003, 0x00830800,
+    0x00832801, 0x00837002, 0x0083a80c, 0x00847000, 0x00850025, 0x00863800,
+    0x00866800, 0x0086802a, 0x0087e14c, 0x00925003, 0x00928006, 0x0092c000,
+    0x0092d003, 0x00930028, 0x00945003, 0x00948020, 0x00959003, 0x0095c006,
+    0x00960000, 0x00961003, 0x0096400e, 0x0096c038, 0x00989003, 0x0098c042,
+    0x009c000f, 0x009d0055, 0x009fc005, 0x00a00a6b, 0x00b37810, 0x00b40819,
+    0x00b5004a, 0x00b7700a, 0x00b80011, 0x00b8f812, 0x00ba0011, 0x00bb000c,
+    0x00bb7002, 0x00bc0033, 0x00beb800, 0x00bee000, 0x00c10058, 0x00c40028,
+    0x00c55000, 0x00c58045, 0x00c8001e, 0x00ca801d, 0x00cb8004, 0x00cc002b,
+    0x00cd8019, 0x00d00016, 0x00d10034, 0x00d53800, 0x00d8282e, 0x00da2807,
+    0x00dc181d, 0x00dd7001, 0x00ddd02b, 0x00e00023, 0x00e26802, 0x00e2d023,
+    0x00e40008, 0x00e4802a, 0x00e5e802, 0x00e74803, 0x00e77005, 0x00e7a801,
+    0x00e7d000, 0x00e800bf, 0x00f00115, 0x00f8c005, 0x00f90025, 0x00fa4005,
+    0x00fa8007, 0x00fac800, 0x00fad800, 0x00fae800, 0x00faf81e, 0x00fc0034,
+    0x00fdb006, 0x00fdf000, 0x00fe1002, 0x00fe3006, 0x00fe8003, 0x00feb005,
+    0x00ff000c, 0x00ff9002, 0x00ffb006, 0x01038800, 0x0103f800, 0x0104800c,
+    0x01081000, 0x01083800, 0x01085009, 0x0108a800, 0x0108c005, 0x01092000,
+    0x01093000, 0x01094000, 0x0109500f, 0x0109e003, 0x010a2804, 0x010a7000,
+    0x010b0028, 0x016000e4, 0x01675803, 0x01679001, 0x01680025, 0x01693800,
+    0x01696800, 0x01698037, 0x016b7800, 0x016c0016, 0x016d0006, 0x016d4006,
+    0x016d8006, 0x016dc006, 0x016e0006, 0x016e4006, 0x016e8006, 0x016ec006,
+    0x01802802, 0x01810808, 0x01818804, 0x0181c004, 0x01820855, 0x0184e802,
+    0x01850859, 0x0187e003, 0x0188282a, 0x0189885d, 0x018d001f, 0x018f800f,
+    0x01a007ff, 0x01e007ff, 0x022007ff, 0x026001bf, 0x027007ff, 0x02b007ff,
+    0x02f007ff, 0x033007ff, 0x037007ff, 0x03b007ff, 0x03f007ff, 0x043007ff,
+    0x047007ff, 0x04b007ff, 0x04f0068c, 0x0526802d, 0x0528010c, 0x0530800f,
+    0x05315001, 0x0532002e, 0x0533f81e, 0x0535004f, 0x0538b808, 0x05391066,
+    0x053c583f, 0x053e8001, 0x053e9800, 0x053ea804, 0x053f900f, 0x05401802,
+    0x05403803, 0x05406016, 0x05420033, 0x05441031, 0x05479005, 0x0547d800,
+    0x0547e801, 0x0548501b, 0x05498016, 0x054b001c, 0x054c202e, 0x054e7800,
+    0x054f0004, 0x054f3009, 0x054fd004, 0x05500028, 0x05520002, 0x05522007,
+    0x05530016, 0x0553d000, 0x0553f031, 0x05558800, 0x0555a801, 0x0555c804,
+    0x05560000, 0x05561000, 0x0556d802, 0x0557000a, 0x05579002, 0x05580805,
+    0x05584805, 0x05588805, 0x05590006, 0x05594006, 0x0559802a, 0x055ae00d,
+    0x055b8072, 0x056007ff, 0x05a007ff, 0x05e007ff, 0x062007ff, 0x066007ff,
+    0x06a003a3, 0x06bd8016, 0x06be5830, 0x07c8016d, 0x07d38069, 0x07d80006,
+    0x07d89804, 0x07d8e800, 0x07d8f809, 0x07d9500c, 0x07d9c004, 0x07d9f000,
+    0x07da0001, 0x07da1801, 0x07da306b, 0x07de988a, 0x07e320d9, 0x07ea803f,
+    0x07ec9035, 0x07ef8009, 0x07f38800, 0x07f39800, 0x07f3b800, 0x07f3c800,
+    0x07f3d800, 0x07f3e800, 0x07f3f87d, 0x07f90819, 0x07fa0819, 0x07fb3037,
+    0x07fd001e, 0x07fe1005, 0x07fe5005, 0x07fe9005, 0x07fed002, 0x0800000b,
+    0x08006819, 0x08014012, 0x0801e001, 0x0801f80e, 0x0802800d, 0x0804007a,
+    0x080a0034, 0x0814001c, 0x08150030, 0x0818001f, 0x0819681d, 0x081a8025,
+    0x081c001d, 0x081d0023, 0x081e4007, 0x081e8804, 0x0820009d, 0x08258023,
+    0x0826c023, 0x08280027, 0x08298033, 0x082b800a, 0x082be00e, 0x082c6006,
+    0x082ca001, 0x082cb80a, 0x082d180e, 0x082d9806, 0x082dd801, 0x08300136,
+    0x083a0015, 0x083b0007, 0x083c0005, 0x083c3829, 0x083d9008, 0x08400005,
+    0x08404000, 0x0840502b, 0x0841b801, 0x0841e000, 0x0841f816, 0x08430016,
+    0x0844001e, 0x08470012, 0x0847a001, 0x08480015, 0x08490019, 0x084c0037,
+    0x084df001, 0x08500000, 0x08508003, 0x0850a802, 0x0850c81c, 0x0853001c,
+    0x0854001c, 0x08560007, 0x0856481b, 0x08580035, 0x085a0015, 0x085b0012,
+    0x085c0011, 0x08600048, 0x08640032, 0x08660032, 0x08680023, 0x08740029,
+    0x08758001, 0x0878001c, 0x08793800, 0x08798015, 0x087b8011, 0x087d8014,
+    0x087f0016, 0x08801834, 0x08838801, 0x0883a800, 0x0884182c, 0x08868018,
+    0x08881823, 0x088a2000, 0x088a3800, 0x088a8022, 0x088bb000, 0x088c182f,
+    0x088e0803, 0x088ed000, 0x088ee000, 0x08900011, 0x08909818, 0x08940006,
+    0x08944000, 0x08945003, 0x0894780e, 0x0894f809, 0x0895802e, 0x08982807,
+    0x08987801, 0x08989815, 0x08995006, 0x08999001, 0x0899a804, 0x0899e800,
+    0x089a8000, 0x089ae804, 0x08a00034, 0x08a23803, 0x08a2f802, 0x08a4002f,
+    0x08a62001, 0x08a63800, 0x08ac002e, 0x08aec003, 0x08b0002f, 0x08b22000,
+    0x08b4002a, 0x08b5c000, 0x08b8001a, 0x08ba0006, 0x08c0002b, 0x08c5003f,
+    0x08c7f807, 0x08c84800, 0x08c86007, 0x08c8a801, 0x08c8c017, 0x08c9f800,
+    0x08ca0800, 0x08cd0007, 0x08cd5026, 0x08cf0800, 0x08cf1800, 0x08d00000,
+    0x08d05827, 0x08d1d000, 0x08d28000, 0x08d2e02d, 0x08d4e800, 0x08d58048,
+    0x08e00008, 0x08e05024, 0x08e20000, 0x08e3901d, 0x08e80006, 0x08e84001,
+    0x08e85825, 0x08ea3000, 0x08eb0005, 0x08eb3801, 0x08eb501f, 0x08ecc000,
+    0x08f70012, 0x08fd8000, 0x09000399, 0x0920006e, 0x092400c3, 0x097c8060,
+    0x0980042e, 0x0a200246, 0x0b400238, 0x0b52001e, 0x0b53804e, 0x0b56801d,
+    0x0b58002f, 0x0b5a0003, 0x0b5b1814, 0x0b5be812, 0x0b72003f, 0x0b78004a,
+    0x0b7a8000, 0x0b7c980c, 0x0b7f0001, 0x0b7f1800, 0x0b8007ff, 0x0bc007ff,
+    0x0c0007f7, 0x0c4004d5, 0x0c680008, 0x0d7f8003, 0x0d7fa806, 0x0d7fe801,
+    0x0d800122, 0x0d8a8002, 0x0d8b2003, 0x0d8b818b, 0x0de0006a, 0x0de3800c,
+    0x0de40008, 0x0de48009, 0x0ea00054, 0x0ea2b046, 0x0ea4f001, 0x0ea51000,
+    0x0ea52801, 0x0ea54803, 0x0ea5700b, 0x0ea5d800, 0x0ea5e806, 0x0ea62840,
+    0x0ea83803, 0x0ea86807, 0x0ea8b006, 0x0ea8f01b, 0x0ea9d803, 0x0eaa0004,
+    0x0eaa3000, 0x0eaa5006, 0x0eaa9153, 0x0eb54018, 0x0eb61018, 0x0eb6e01e,
+    0x0eb7e018, 0x0eb8b01e, 0x0eb9b018, 0x0eba801e, 0x0ebb8018, 0x0ebc501e,
+    0x0ebd5018, 0x0ebe2007, 0x0ef8001e, 0x0f08002c, 0x0f09b806, 0x0f0a7000,
+    0x0f14801d, 0x0f16002b, 0x0f3f0006, 0x0f3f4003, 0x0f3f6801, 0x0f3f800e,
+    0x0f4000c4, 0x0f480043, 0x0f4a5800, 0x0f700003, 0x0f70281a, 0x0f710801,
+    0x0f712000, 0x0f713800, 0x0f714809, 0x0f71a003, 0x0f71c800, 0x0f71d800,
+    0x0f721000, 0x0f723800, 0x0f724800, 0x0f725800, 0x0f726802, 0x0f728801,
+    0x0f72a000, 0x0f72b800, 0x0f72c800, 0x0f72d800, 0x0f72e800, 0x0f72f800,
+    0x0f730801, 0x0f732000, 0x0f733803, 0x0f736006, 0x0f73a003, 0x0f73c803,
+    0x0f73f000, 0x0f740009, 0x0f745810, 0x0f750802, 0x0f752804, 0x0f755810,
+    0x100007ff, 0x104007ff, 0x108007ff, 0x10c007ff, 0x110007ff, 0x114007ff,
+    0x118007ff, 0x11c007ff, 0x120007ff, 0x124007ff, 0x128007ff, 0x12c007ff,
+    0x130007ff, 0x134007ff, 0x138007ff, 0x13c007ff, 0x140007ff, 0x144007ff,
+    0x148007ff, 0x14c007ff, 0x150006df, 0x153807ff, 0x157807ff, 0x15b80038,
+    0x15ba00dd, 0x15c107ff, 0x160107ff, 0x16410681, 0x167587ff, 0x16b587ff,
+    0x16f587ff, 0x17358530, 0x17c0021d, 0x180007ff, 0x184007ff, 0x1880034a,
+};
+
+static const uint32_t XID_CONTINUE_RANGES[] = {
+    0x00055000, 0x0005a800, 0x0005b800, 0x0005d000, 0x00060016, 0x0006c01e,
+    0x0007c1c9, 0x0016300b, 0x00170004, 0x00176000, 0x00177000, 0x00180074,
+    0x001bb001, 0x001bd802, 0x001bf800, 0x001c3004, 0x001c6000, 0x001c7013,
+    0x001d1852, 0x001fb88a, 0x00241804, 0x002450a5, 0x00298825, 0x002ac800,
+    0x002b0028, 0x002c882c, 0x002df800, 0x002e0801, 0x002e2001, 0x002e3800,
+    0x002e801a, 0x002f7803, 0x0030800a, 0x00310049, 0x00337065, 0x0036a807,
+    0x0036f809, 0x00375012, 0x0037f800, 0x0038803a, 0x003a6864, 0x003e0035,
+    0x003fd000, 0x003fe800, 0x0040002d, 0x0042001b, 0x0043000a, 0x00438017,
+    0x00444805, 0x0044c049, 0x00471880, 0x004b3009, 0x004b8812, 0x004c2807,
+    0x004c7801, 0x004c9815, 0x004d5006, 0x004d9000, 0x004db003, 0x004de008,
+    0x004e3801, 0x004e5803, 0x004eb800, 0x004ee001, 0x004ef804, 0x004f300b,
+    0x004fe000, 0x004ff000, 0x00500802, 0x00502805, 0x00507801, 0x00509815,
+    0x00515006, 0x00519001, 0x0051a801, 0x0051c001, 0x0051e000, 0x0051f004,
+    0x00523801, 0x00525802, 0x00528800, 0x0052c803, 0x0052f000, 0x0053300f,
+    0x00540802, 0x00542808, 0x00547802, 0x00549815, 0x00555006, 0x00559001,
+    0x0055a804, 0x0055e009, 0x00563802, 0x00565802, 0x00568000, 0x00570003,
+    0x00573009, 0x0057c806, 0x00580802, 0x00582807, 0x00587801, 0x00589815,
+    0x00595006, 0x00599001, 0x0059a804, 0x0059e008, 0x005a3801, 0x005a5802,
+    0x005aa802, 0x005ae001, 0x005af804, 0x005b3009, 0x005b8800, 0x005c1001,
+    0x005c2805, 0x005c7002, 0x005c9003, 0x005cc801, 0x005ce000, 0x005cf001,
+    0x005d1801, 0x005d4002, 0x005d700b, 0x005df004, 0x005e3002, 0x005e5003,
+    0x005e8000, 0x005eb800, 0x005f3009, 0x0060000c, 0x00607002, 0x00609016,
+    0x0061500f, 0x0061e008, 0x00623002, 0x00625003, 0x0062a801, 0x0062c002,
+    0x0062e800, 0x00630003, 0x00633009, 0x00640003, 0x00642807, 0x00647002,
+    0x00649016, 0x00655009, 0x0065a804, 0x0065e008, 0x00663002, 0x00665003,
+    0x0066a801, 0x0066e801, 0x00670003, 0x00673009, 0x00678801, 0x0068000c,
+    0x00687002, 0x00689032, 0x006a3002, 0x006a5004, 0x006aa003, 0x006af804,
+    0x006b3009, 0x006bd005, 0x006c0802, 0x006c2811, 0x006cd017, 0x006d9808,
+    0x006de800, 0x006e0006, 0x006e5000, 0x006e7805, 0x006eb000, 0x006ec007,
+    0x006f3009, 0x006f9001, 0x00700839, 0x0072000e, 0x00728009, 0x00740801,
+    0x00742000, 0x00743004, 0x00746017, 0x00752800, 0x00753816, 0x00760004,
+    0x00763000, 0x00764005, 0x00768009, 0x0076e003, 0x00780000, 0x0078c001,
+    0x00790009, 0x0079a800, 0x0079b800, 0x0079c800, 0x0079f009, 0x007a4823,
+    0x007b8813, 0x007c3011, 0x007cc823, 0x007e3000, 0x00800049, 0x0082804d,
+    0x00850025, 0x00863800, 0x00866800, 0x0086802a, 0x0087e14c, 0x00925003,
+    0x00928006, 0x0092c000, 0x0092d003, 0x00930028, 0x00945003, 0x00948020,
+    0x00959003, 0x0095c006, 0x00960000, 0x00961003, 0x0096400e, 0x0096c038,
+    0x00989003, 0x0098c042, 0x009ae802, 0x009b4808, 0x009c000f, 0x009d0055,
+    0x009fc005, 0x00a00a6b, 0x00b37810, 0x00b40819, 0x00b5004a, 0x00b7700a,
+    0x00b80015, 0x00b8f815, 0x00ba0013, 0x00bb000c, 0x00bb7002, 0x00bb9001,
+    0x00bc0053, 0x00beb800, 0x00bee001, 0x00bf0009, 0x00c05802, 0x00c0780a,
+    0x00c10058, 0x00c4002a, 0x00c58045, 0x00c8001e, 0x00c9000b, 0x00c9800b,
+    0x00ca3027, 0x00cb8004, 0x00cc002b, 0x00cd8019, 0x00ce800a, 0x00d0001b,
+    0x00d1003e, 0x00d3001c, 0x00d3f80a, 0x00d48009, 0x00d53800, 0x00d5800d,
+    0x00d5f80f, 0x00d8004c, 0x00da8009, 0x00db5808, 0x00dc0073, 0x00e00037,
+    0x00e20009, 0x00e26830, 0x00e40008, 0x00e4802a, 0x00e5e802, 0x00e68002,
+    0x00e6a026, 0x00e80215, 0x00f8c005, 0x00f90025, 0x00fa4005, 0x00fa8007,
+    0x00fac800, 0x00fad800, 0x00fae800, 0x00faf81e, 0x00fc0034, 0x00fdb006,
+    0x00fdf000, 0x00fe1002, 0x00fe3006, 0x00fe8003, 0x00feb005, 0x00ff000c,
+    0x00ff9002, 0x00ffb006, 0x0101f801, 0x0102a000, 0x01038800, 0x0103f800,
+    0x0104800c, 0x0106800c, 0x01070800, 0x0107280b, 0x01081000, 0x01083800,
+    0x01085009, 0x0108a800, 0x0108c005, 0x01092000, 0x01093000, 0x01094000,
+    0x0109500f, 0x0109e003, 0x010a2804, 0x010a7000, 0x010b0028, 0x016000e4,
+    0x01675808, 0x01680025, 0x01693800, 0x01696800, 0x01698037, 0x016b7800,
+    0x016bf817, 0x016d0006, 0x016d4006, 0x016d8006, 0x016dc006, 0x016e0006,
+    0x016e4006, 0x016e8006, 0x016ec006, 0x016f001f, 0x01802802, 0x0181080e,
+    0x01818804, 0x0181c004, 0x01820855, 0x0184c801, 0x0184e802, 0x01850859,
+    0x0187e003, 0x0188282a, 0x0189885d, 0x018d001f, 0x018f800f, 0x01a007ff,
+    0x01e007ff, 0x022007ff, 0x026001bf, 0x027007ff, 0x02b007ff, 0x02f007ff,
+    0x033007ff, 0x037007ff, 0x03b007ff, 0x03f007ff, 0x043007ff, 0x047007ff,
+    0x04b007ff, 0x04f0068c, 0x0526802d, 0x0528010c, 0x0530801b, 0x0532002f,
+    0x0533a009, 0x0533f872, 0x0538b808, 0x05391066, 0x053c583f, 0x053e8001,
+    0x053e9800, 0x053ea804, 0x053f9035, 0x05416000, 0x05420033, 0x05440045,
+    0x05468009, 0x05470017, 0x0547d800, 0x0547e830, 0x05498023, 0x054b001c,
+    0x054c0040, 0x054e780a, 0x054f001e, 0x05500036, 0x0552000d, 0x05528009,
+    0x05530016, 0x0553d048, 0x0556d802, 0x0557000f, 0x05579004, 0x05580805,
+    0x05584805, 0x05588805, 0x05590006, 0x05594006, 0x0559802a, 0x055ae00d,
+    0x055b807a, 0x055f6001, 0x055f8009, 0x056007ff, 0x05a007ff, 0x05e007ff,
+    0x062007ff, 0x066007ff, 0x06a003a3, 0x06bd8016, 0x06be5830, 0x07c8016d,
+    0x07d38069, 0x07d80006, 0x07d89804, 0x07d8e80b, 0x07d9500c, 0x07d9c004,
+    0x07d9f000, 0x07da0001, 0x07da1801, 0x07da306b, 0x07de988a, 0x07e320d9,
+    0x07ea803f, 0x07ec9035, 0x07ef8009, 0x07f0000f, 0x07f1000f, 0x07f19801,
+    0x07f26802, 0x07f38800, 0x07f39800, 0x07f3b800, 0x07f3c800, 0x07f3d800,
+    0x07f3e800, 0x07f3f87d, 0x07f88009, 0x07f90819, 0x07f9f800, 0x07fa0819,
+    0x07fb3058, 0x07fe1005, 0x07fe5005, 0x07fe9005, 0x07fed002, 0x0800000b,
+    0x08006819, 0x08014012, 0x0801e001, 0x0801f80e, 0x0802800d, 0x0804007a,
+    0x080a0034, 0x080fe800, 0x0814001c, 0x08150030, 0x08170000, 0x0818001f,
+    0x0819681d, 0x081a802a, 0x081c001d, 0x081d0023, 0x081e4007, 0x081e8804,
+    0x0820009d, 0x08250009, 0x08258023, 0x0826c023, 0x08280027, 0x08298033,
+    0x082b800a, 0x082be00e, 0x082c6006, 0x082ca001, 0x082cb80a, 0x082d180e,
+    0x082d9806, 0x082dd801, 0x08300136, 0x083a0015, 0x083b0007, 0x083c0005,
+    0x083c3829, 0x083d9008, 0x08400005, 0x08404000, 0x0840502b, 0x0841b801,
+    0x0841e000, 0x0841f816, 0x08430016, 0x0844001e, 0x08470012, 0x0847a001,
+    0x08480015, 0x08490019, 0x084c0037, 0x084df001, 0x08500003, 0x08502801,
+    0x08506007, 0x0850a802, 0x0850c81c, 0x0851c002, 0x0851f800, 0x0853001c,
+    0x0854001c, 0x08560007, 0x0856481d, 0x08580035, 0x085a0015, 0x085b0012,
+    0x085c0011, 0x08600048, 0x08640032, 0x08660032, 0x08680027, 0x08698009,
+    0x08740029, 0x08755801, 0x08758001, 0x0878001c, 0x08793800, 0x08798020,
+    0x087b8015, 0x087d8014, 0x087f0016, 0x08800046, 0x0883300f, 0x0883f83b,
+    0x08861000, 0x08868018, 0x08878009, 0x08880034, 0x0889b009, 0x088a2003,
+    0x088a8023, 0x088bb000, 0x088c0044, 0x088e4803, 0x088e700c, 0x088ee000,
+    0x08900011, 0x08909824, 0x0891f000, 0x08940006, 0x08944000, 0x08945003,
+    0x0894780e, 0x0894f809, 0x0895803a, 0x08978009, 0x08980003, 0x08982807,
+    0x08987801, 0x08989815, 0x08995006, 0x08999001, 0x0899a804, 0x0899d809,
+    0x089a3801, 0x089a5802, 0x089a8000, 0x089ab800, 0x089ae806, 0x089b3006,
+    0x089b8004, 0x08a0004a, 0x08a28009, 0x08a2f003, 0x08a40045, 0x08a63800,
+    0x08a68009, 0x08ac0035, 0x08adc008, 0x08aec005, 0x08b00040, 0x08b22000,
+    0x08b28009, 0x08b40038, 0x08b60009, 0x08b8001a, 0x08b8e80e, 0x08b98009,
+    0x08ba0006, 0x08c0003a, 0x08c50049, 0x08c7f807, 0x08c84800, 0x08c86007,
+    0x08c8a801, 0x08c8c01d, 0x08c9b801, 0x08c9d808, 0x08ca8009, 0x08cd0007,
+    0x08cd502d, 0x08ced007, 0x08cf1801, 0x08d0003e, 0x08d23800, 0x08d28049,
+    0x08d4e800, 0x08d58048, 0x08e00008, 0x08e0502c, 0x08e1c008, 0x08e28009,
+    0x08e3901d, 0x08e49015, 0x08e5480d, 0x08e80006, 0x08e84001, 0x08e8582b,
+    0x08e9d000, 0x08e9e001, 0x08e9f808, 0x08ea8009, 0x08eb0005, 0x08eb3801,
+    0x08eb5024, 0x08ec8001, 0x08ec9805, 0x08ed0009, 0x08f70016, 0x08fd8000,
+    0x09000399, 0x0920006e, 0x092400c3, 0x097c8060, 0x0980042e, 0x0a200246,
+    0x0b400238, 0x0b52001e, 0x0b530009, 0x0b53804e, 0x0b560009, 0x0b56801d,
+    0x0b578004, 0x0b580036, 0x0b5a0003, 0x0b5a8009, 0x0b5b1814, 0x0b5be812,
+    0x0b72003f, 0x0b78004a, 0x0b7a7838, 0x0b7c7810, 0x0b7f0001, 0x0b7f1801,
+    0x0b7f8001, 0x0b8007ff, 0x0bc007ff, 0x0c0007f7, 0x0c4004d5, 0x0c680008,
+    0x0d7f8003, 0x0d7fa806, 0x0d7fe801, 0x0d800122, 0x0d8a8002, 0x0d8b2003,
+    0x0d8b818b, 0x0de0006a, 0x0de3800c, 0x0de40008, 0x0de48009, 0x0de4e801,
+    0x0e78002d, 0x0e798016, 0x0e8b2804, 0x0e8b6805, 0x0e8bd807, 0x0e8c2806,
+    0x0e8d5003, 0x0e921002, 0x0ea00054, 0x0ea2b046, 0x0ea4f001, 0x0ea51000,
+    0x0ea52801, 0x0ea54803, 0x0ea5700b, 0x0ea5d800, 0x0ea5e806, 0x0ea62840,
+    0x0ea83803, 0x0ea86807, 0x0ea8b006, 0x0ea8f01b, 0x0ea9d803, 0x0eaa0004,
+    0x0eaa3000, 0x0eaa5006, 0x0eaa9153, 0x0eb54018, 0x0eb61018, 0x0eb6e01e,
+    0x0eb7e018, 0x0eb8b01e, 0x0eb9b018, 0x0eba801e, 0x0ebb8018, 0x0ebc501e,
+    0x0ebd5018, 0x0ebe2007, 0x0ebe7031, 0x0ed00036, 0x0ed1d831, 0x0ed3a800,
+    0x0ed42000, 0x0ed4d804, 0x0ed5080e, 0x0ef8001e, 0x0f000006, 0x0f004010,
+    0x0f00d806, 0x0f011801, 0x0f013004, 0x0f08002c, 0x0f09800d, 0x0f0a0009,
+    0x0f0a7000, 0x0f14801e, 0x0f160039, 0x0f3f0006, 0x0f3f4003, 0x0f3f6801,
+    0x0f3f800e, 0x0f4000c4, 0x0f468006, 0x0f48004b, 0x0f4a8009, 0x0f700003,
+    0x0f70281a, 0x0f710801, 0x0f712000, 0x0f713800, 0x0f714809, 0x0f71a003,
+    0x0f71c800, 0x0f71d800, 0x0f721000, 0x0f723800, 0x0f724800, 0x0f725800,
+    0x0f726802, 0x0f728801, 0x0f72a000, 0x0f72b800, 0x0f72c800, 0x0f72d800,
+    0x0f72e800, 0x0f72f800, 0x0f730801, 0x0f732000, 0x0f733803, 0x0f736006,
+    0x0f73a003, 0x0f73c803, 0x0f73f000, 0x0f740009, 0x0f745810, 0x0f750802,
+    0x0f752804, 0x0f755810, 0x0fdf8009, 0x100007ff, 0x104007ff, 0x108007ff,
+    0x10c007ff, 0x110007ff, 0x114007ff, 0x118007ff, 0x11c007ff, 0x120007ff,
+    0x124007ff, 0x128007ff, 0x12c007ff, 0x130007ff, 0x134007ff, 0x138007ff,
+    0x13c007ff, 0x140007ff, 0x144007ff, 0x148007ff, 0x14c007ff, 0x150006df,
+    0x153807ff, 0x157807ff, 0x15b80038, 0x15ba00dd, 0x15c107ff, 0x160107ff,
+    0x16410681, 0x167587ff, 0x16b587ff, 0x16f587ff, 0x17358530, 0x17c0021d,
+    0x180007ff, 0x184007ff, 0x1880034a, 0x700800ef,
+};
+
+static const uint32_t UPPERCASE_RANGES[] = {
+    0x00060016, 0x0006c006, 0x00080000, 0x00081000, 0x00082000, 0x00083000,
+    0x00084000, 0x00085000, 0x00086000, 0x00087000, 0x00088000, 0x00089000,
+    0x0008a000, 0x0008b000, 0x0008c000, 0x0008d000, 0x0008e000, 0x0008f000,
+    0x00090000, 0x00091000, 0x00092000, 0x00093000, 0x00094000, 0x00095000,
+    0x00096000, 0x00097000, 0x00098000, 0x00099000, 0x0009a000, 0x0009b000,
+    0x0009c800, 0x0009d800, 0x0009e800, 0x0009f800, 0x000a0800, 0x000a1800,
+    0x000a2800, 0x000a3800, 0x000a5000, 0x000a6000, 0x000a7000, 0x000a8000,
+    0x000a9000, 0x000aa000, 0x000ab000, 0x000ac000, 0x000ad000, 0x000ae000,
+    0x000af000, 0x000b0000, 0x000b1000, 0x000b2000, 0x000b3000, 0x000b4000,
+    0x000b5000, 0x000b6000, 0x000b7000, 0x000b8000, 0x000b9000, 0x000ba000,
+    0x000bb000, 0x000bc001, 0x000bd800, 0x000be800, 0x000c0801, 0x000c2000,
+    0x000c3001, 0x000c4802, 0x000c7003, 0x000c9801, 0x000cb002, 0x000ce001,
+    0x000cf801, 0x000d1000, 0x000d2000, 0x000d3001, 0x000d4800, 0x000d6000,
+    0x000d7001, 0x000d8802, 0x000da800, 0x000db801, 0x000de000, 0x000e2001,
+    0x000e3801, 0x000e5001, 0x000e6800, 0x000e7800, 0x000e8800, 0x000e9800,
+    0x000ea800, 0x000eb800, 0x000ec800, 0x000ed800, 0x000ef000, 0x000f0000,
+    0x000f1000, 0x000f2000, 0x000f3000, 0x000f4000, 0x000f5000, 0x000f6000,
+    0x000f7000, 0x000f8801, 0x000fa000, 0x000fb002, 0x000fd000, 0x000fe000,
+    0x000ff000, 0x00100000, 0x00101000, 0x00102000, 0x00103000, 0x00104000,
+    0x00105000, 0x00106000, 0x00107000, 0x00108000, 0x00109000, 0x0010a000,
+    0x0010b000, 0x0010c000, 0x0010d000, 0x0010e000, 0x0010f000, 0x00110000,
+    0x00111000, 0x00112000, 0x00113000, 0x00114000, 0x00115000, 0x00116000,
+    0x00117000, 0x00118000, 0x00119000, 0x0011d001, 0x0011e801, 0x00120800,
+    0x00121803, 0x00124000, 0x00125000, 0x00126000, 0x00127000, 0x001b8000,
+    0x001b9000, 0x001bb000, 0x001bf800, 0x001c3000, 0x001c4002, 0x001c6000,
+    0x001c7001, 0x001c8810, 0x001d1808, 0x001e7800, 0x001e9002, 0x001ec000,
+    0x001ed000, 0x001ee000, 0x001ef000, 0x001f0000, 0x001f1000, 0x001f2000,
+    0x001f3000, 0x001f4000, 0x001f5000, 0x001f6000, 0x001f7000, 0x001fa000,
+    0x001fb800, 0x001fc801, 0x001fe832, 0x00230000, 0x00231000, 0x00232000,
+    0x00233000, 0x00234000, 0x00235000, 0x00236000, 0x00237000, 0x00238000,
+    0x00239000, 0x0023a000, 0x0023b000, 0x0023c000, 0x0023d000, 0x0023e000,
+    0x0023f000, 0x00240000, 0x00245000, 0x00246000, 0x00247000, 0x00248000,
+    0x00249000, 0x0024a000, 0x0024b000, 0x0024c000, 0x0024d000, 0x0024e000,
+    0x0024f000, 0x00250000, 0x00251000, 0x00252000, 0x00253000, 0x00254000,
+    0x00255000, 0x00256000, 0x00257000, 0x00258000, 0x00259000, 0x0025a000,
+    0x0025b000, 0x0025c000, 0x0025d000, 0x0025e000, 0x0025f000, 0x00260001,
+    0x00261800, 0x00262800, 0x00263800, 0x00264800, 0x00265800, 0x00266800,
+    0x00268000, 0x00269000, 0x0026a000, 0x0026b000, 0x0026c000, 0x0026d000,
+    0x0026e000, 0x0026f000, 0x00270000, 0x00271000, 0x00272000, 0x00273000,
+    0x00274000, 0x00275000, 0x00276000, 0x00277000, 0x00278000, 0x00279000,
+    0x0027a000, 0x0027b000, 0x0027c000, 0x0027d000, 0x0027e000, 0x0027f000,
+    0x00280000, 0x00281000, 0x00282000, 0x00283000, 0x00284000, 0x00285000,
+    0x00286000, 0x00287000, 0x00288000, 0x00289000, 0x0028a000, 0x0028b000,
+    0x0028c000, 0x0028d000, 0x0028e000, 0x0028f000, 0x00290000, 0x00291000,
+    0x00292000, 0x00293000, 0x00294000, 0x00295000, 0x00296000, 0x00297000,
+    0x00298825, 0x00850025, 0x00863800, 0x00866800, 0x009d0055, 0x00e4802a,
+    0x00e5e802, 0x00f00000, 0x00f01000, 0x00f02000, 0x00f03000, 0x00f04000,
+    0x00f05000, 0x00f06000, 0x00f07000, 0x00f08000, 0x00f09000, 0x00f0a000,
+    0x00f0b000, 0x00f0c000, 0x00f0d000, 0x00f0e000, 0x00f0f000, 0x00f10000,
+    0x00f11000, 0x00f12000, 0x00f13000, 0x00f14000, 0x00f15000, 0x00f16000,
+    0x00f17000, 0x00f18000, 0x00f19000, 0x00f1a000, 0x00f1b000, 0x00f1c000,
+    0x00f1d000, 0x00f1e000, 0x00f1f000, 0x00f20000, 0x00f21000, 0x00f22000,
+    0x00f23000, 0x00f24000, 0x00f25000, 0x00f26000, 0x00f27000, 0x00f28000,
+    0x00f29000, 0x00f2a000, 0x00f2b000, 0x00f2c000, 0x00f2d000, 0x00f2e000,
+    0x00f2f000, 0x00f30000, 0x00f31000, 0x00f32000, 0x00f33000, 0x00f34000,
+    0x00f35000, 0x00f36000, 0x00f37000, 0x00f38000, 0x00f39000, 0x00f3a000,
+    0x00f3b000, 0x00f3c000, 0x00f3d000, 0x00f3e000, 0x00f3f000, 0x00f40000,
+    0x00f41000, 0x00f42000, 0x00f43000, 0x00f44000, 0x00f45000, 0x00f46000,
+    0x00f47000, 0x00f48000, 0x00f49000, 0x00f4a000, 0x00f4f000, 0x00f50000,
+    0x00f51000, 0x00f52000, 0x00f53000, 0x00f54000, 0x00f55000, 0x00f56000,
+    0x00f57000, 0x00f58000, 0x00f59000, 0x00f5a000, 0x00f5b000, 0x00f5c000,
+    0x00f5d000, 0x00f5e000, 0x00f5f000, 0x00f60000, 0x00f61000, 0x00f62000,
+    0x00f63000, 0x00f64000, 0x00f65000, 0x00f66000, 0x00f67000, 0x00f68000,
+    0x00f69000, 0x00f6a000, 0x00f6b000, 0x00f6c000, 0x00f6d000, 0x00f6e000,
+    0x00f6f000, 0x00f70000, 0x00f71000, 0x00f72000, 0x00f73000, 0x00f74000,
+    0x00f75000, 0x00f76000, 0x00f77000, 0x00f78000, 0x00f79000, 0x00f7a000,
+    0x00f7b000, 0x00f7c000, 0x00f7d000, 0x00f7e000, 0x00f7f000, 0x00f84007,
+    0x00f8c005, 0x00f94007, 0x00f9c007, 0x00fa4005, 0x00fac800, 0x00fad800,
+    0x00fae800, 0x00faf800, 0x00fb4007, 0x00fc4007, 0x00fcc007, 0x00fd4007,
+    0x00fdc004, 0x00fe4004, 0x00fec003, 0x00ff4004, 0x00ffc004, 0x01081000,
+    0x01083800, 0x01085802, 0x01088002, 0x0108a800, 0x0108c804, 0x01092000,
+    0x01093000, 0x01094000, 0x01095003, 0x01098003, 0x0109f001, 0x010a2800,
+    0x010c1800, 0x0160002f, 0x01630000, 0x01631002, 0x01633800, 0x01634800,
+    0x01635800, 0x01636803, 0x01639000, 0x0163a800, 0x0163f002, 0x01641000,
+    0x01642000, 0x01643000, 0x01644000, 0x01645000, 0x01646000, 0x01647000,
+    0x01648000, 0x01649000, 0x0164a000, 0x0164b000, 0x0164c000, 0x0164d000,
+    0x0164e000, 0x0164f000, 0x01650000, 0x01651000, 0x01652000, 0x01653000,
+    0x01654000, 0x01655000, 0x01656000, 0x01657000, 0x01658000, 0x01659000,
+    0x0165a000, 0x0165b000, 0x0165c000, 0x0165d000, 0x0165e000, 0x0165f000,
+    0x01660000, 0x01661000, 0x01662000, 0x01663000, 0x01664000, 0x01665000,
+    0x01666000, 0x01667000, 0x01668000, 0x01669000, 0x0166a000, 0x0166b000,
+    0x0166c000, 0x0166d000, 0x0166e000, 0x0166f000, 0x01670000, 0x01671000,
+    0x01675800, 0x01676800, 0x01679000, 0x05320000, 0x05321000, 0x05322000,
+    0x05323000, 0x05324000, 0x05325000, 0x05326000, 0x05327000, 0x05328000,
+    0x05329000, 0x0532a000, 0x0532b000, 0x0532c000, 0x0532d000, 0x0532e000,
+    0x0532f000, 0x05330000, 0x05331000, 0x05332000, 0x05333000, 0x05334000,
+    0x05335000, 0x05336000, 0x05340000, 0x05341000, 0x05342000, 0x05343000,
+    0x05344000, 0x05345000, 0x05346000, 0x05347000, 0x05348000, 0x05349000,
+    0x0534a000, 0x0534b000, 0x0534c000, 0x0534d000, 0x05391000, 0x05392000,
+    0x05393000, 0x05394000, 0x05395000, 0x05396000, 0x05397000, 0x05399000,
+    0x0539a000, 0x0539b000, 0x0539c000, 0x0539d000, 0x0539e000, 0x0539f000,
+    0x053a0000, 0x053a1000, 0x053a2000, 0x053a3000, 0x053a4000, 0x053a5000,
+    0x053a6000, 0x053a7000, 0x053a8000, 0x053a9000, 0x053aa000, 0x053ab000,
+    0x053ac000, 0x053ad000, 0x053ae000, 0x053af000, 0x053b0000, 0x053b1000,
+    0x053b2000, 0x053b3000, 0x053b4000, 0x053b5000, 0x053b6000, 0x053b7000,
+    0x053bc800, 0x053bd800, 0x053be801, 0x053c0000, 0x053c1000, 0x053c2000,
+    0x053c3000, 0x053c5800, 0x053c6800, 0x053c8000, 0x053c9000, 0x053cb000,
+    0x053cc000, 0x053cd000, 0x053ce000, 0x053cf000, 0x053d0000, 0x053d1000,
+    0x053d2000, 0x053d3000, 0x053d4000, 0x053d5004, 0x053d8004, 0x053db000,
+    0x053dc000, 0x053dd000, 0x053de000, 0x053df000, 0x053e0000, 0x053e1000,
+    0x053e2003, 0x053e4800, 0x053e8000, 0x053eb000, 0x053ec000, 0x053fa800,
+    0x07f90819, 0x08200027, 0x08258023, 0x082b800a, 0x082be00e, 0x082c6006,
+    0x082ca001, 0x08640032, 0x08c5001f, 0x0b72001f, 0x0ea00019, 0x0ea1a019,
+    0x0ea34019, 0x0ea4e000, 0x0ea4f001, 0x0ea51000, 0x0ea52801, 0x0ea54803,
+    0x0ea57007, 0x0ea68019, 0x0ea82001, 0x0ea83803, 0x0ea86807, 0x0ea8b006,
+    0x0ea9c001, 0x0ea9d803, 0x0eaa0004, 0x0eaa3000, 0x0eaa5006, 0x0eab6019,
+    0x0ead0019, 0x0eaea019, 0x0eb04019, 0x0eb1e019, 0x0eb38019, 0x0eb54018,
+    0x0eb71018, 0x0eb8e018, 0x0ebab018, 0x0ebc8018, 0x0ebe5000, 0x0f480021,
+};
+
@@ -0,0 +1,173 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "unicode_table.h"
+#include "utf8.h"
+
+/// Validation
+/// ==========
+
+/// Find the offset of the first non-ASCII byte in a buffer.
+static size_t ascii_prefix(const unsigned char *data, size_t length) {
+    size_t i = 0;
+
+#ifdef __SSE2__
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(data + i));
+        int mask = _mm_movemask_epi8(chunk);
+        if (mask) return i + (size_t)__builtin_ctz((unsigned)mask);
+    }
+#else
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (word & 0x8080808080808080) break;
+    }
+#endif
+
+    while (i < length && data[i] < 0x80) i++;
+    return i;
+}
+
+static bool is_continuation(unsigned char c) {
+    return (c & 0xC0) == 0x80;
+}
+
+/// Get the length of the well-formed sequence at the start of a
+/// buffer, or 0 if it's malformed.  Bytes are checked one at a time
+/// so that a NUL terminator always stops the check.
+static size_t sequence_length(const unsigned char *data, size_t remaining) {
+    unsigned char c = data[0];
+    if (c < 0x80) return 1;
+    if (c < 0xC2) return 0;
+
+    if (c < 0xE0) {
+        return remaining >= 2 && is_continuation(data[1]) ? 2 : 0;
+    }
+
+    if (c < 0xF0) {
+        unsigned char lo = c == 0xE0 ? 0xA0 : 0x80;
+        unsigned char hi = c == 0xED ? 0x9F : 0xBF;
+        if (remaining < 3 || data[1] < lo || data[1] > hi) return 0;
+        return is_continuation(data[2]) ? 3 : 0;
+    }
+
+    if (c < 0xF5) {
+        unsigned char lo = c == 0xF0 ? 0x90 : 0x80;
+        unsigned char hi = c == 0xF4 ? 0x8F : 0xBF;
+        if (remaining < 4 || data[1] < lo || data[1] > hi) return 0;
+        return is_continuation(data[2]) && is_continuation(data[3]) ? 4 : 0;
+    }
+
+    return 0;
+}
+
+bool mt_utf8_validate(const char *buffer, size_t length, size_t *error_offset) {
+    const unsigned char *data = (const unsigned char *)buffer;
+
+    size_t i = 0;
+    while (i < length) {
+        i += ascii_prefix(data + i, length - i);
+
+        // Validate sequences one by one until the next run of ASCII.
+        while (i < length && data[i] >= 0x80) {
+            size_t n = sequence_length(data + i, length - i);
+            if (n == 0) {
+                if (error_offset) *error_offset = i;
+                return false;
+            }
+
+            i += n;
+        }
+    }
+
+    return true;
+}
+
+uint32_t mt_utf8_decode(const char *buffer, size_t *length) {
+    const unsigned char *data = (const unsigned char *)buffer;
+
+    *length = sequence_length(data, 4);
+    switch (*length) {
+    case 1: return data[0];
+    case 2: return (uint32_t)(data[0] & 0x1F) << 6 | (data[1] & 0x3F);
+    case 3: return (uint32_t)(data[0] & 0x0F) << 12 | (uint32_t)(data[1] & 0x3F) << 6 | (data[2] & 0x3F);
+    case 4: return (uint32_t)(data[0] & 0x07) << 18 | (uint32_t)(data[1] & 0x3F) << 12 | (uint32_t)(data[2] & 0x3F) << 6 | (data[3] & 0x3F);
+    }
+
+    *length = 1;
+    return mt_UTF8_INVALID;
+}
+
+size_t mt_utf8_encode(uint32_t c, char *out) {
+    if (c < 0x80) {
+        out[0] = (char)c;
+        return 1;
+    }
+
+    if (c < 0x800) {
+        out[0] = (char)(0xC0 | c >> 6);
+        out[1] = (char)(0x80 | (c & 0x3F));
+        return 2;
+    }
+
+    if (c < 0x10000) {
+        if (c >= 0xD800 && c <= 0xDFFF) return 0;
+
+        out[0] = (char)(0xE0 | c >> 12);
+        out[1] = (char)(0x80 | (c >> 6 & 0x3F));
+        out[2] = (char)(0x80 | (c & 0x3F));
+        return 3;
+    }
+
+    if (c < 0x110000) {
+        out[0] = (char)(0xF0 | c >> 18);
+        out[1] = (char)(0x80 | (c >> 12 & 0x3F));
+        out[2] = (char)(0x80 | (c >> 6 & 0x3F));
+        out[3] = (char)(0x80 | (c & 0x3F));
+        return 4;
+    }
+
+    return 0;
+}
+
+
+/// Identifiers
+/// ===========
+
+/// Look a code point up in a sorted table of packed ranges.
+static bool in_ranges(const uint32_t *ranges, size_t count, uint32_t c) {
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ranges[mid] >> 11 <= c) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == 0) return false;
+
+    uint32_t range = ranges[lo - 1];
+    return c - (range >> 11) <= (range & 0x7FF);
+}
+
+bool mt_unicode_is_xid_start(uint32_t c) {
+    return in_ranges(XID_START_RANGES, sizeof(XID_START_RANGES) / sizeof(XID_START_RANGES[0]), c);
+}
+
+bool mt_unicode_is_xid_continue(uint32_t c) {
+    return in_ranges(XID_CONTINUE_RANGES, sizeof(XID_CONTINUE_RANGES) / sizeof(XID_CONTINUE_RANGES[0]), c);
+}
+
+bool mt_unicode_is_upper(uint32_t c) {
+    return in_ranges(UPPERCASE_RANGES, sizeof(UPPERCASE_RANGES) / sizeof(UPPERCASE_RANGES[0]), c);
+}
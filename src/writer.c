@@ -0,0 +1,186 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dtoa.h"
+#include "utf8.h"
+#include "writer.h"
+
+mt_Writer *mt_writer_init(FILE *out) {
+    mt_Writer *writer = malloc(sizeof(mt_Writer));
+    if (!writer) return NULL;
+
+    writer->buffer = malloc(sizeof(char) * mt_WRITER_BUFFER_SIZE);
+    if (!writer->buffer) {
+        free(writer);
+        return NULL;
+    }
+
+    writer->out = out;
+    writer->line_buffered = false;
+    writer->length = 0;
+    writer->capacity = mt_WRITER_BUFFER_SIZE;
+    writer->failed = false;
+    return writer;
+}
+
+static void drain(mt_Writer *writer) {
+    if (writer->length == 0) return;
+
+    if (fwrite(writer->buffer, sizeof(char), writer->length, writer->out) < writer->length) {
+        writer->failed = true;
+    }
+
+    writer->length = 0;
+}
+
+void mt_writer_write(mt_Writer *writer, const char *data, size_t length) {
+    if (writer->length + length > writer->capacity) {
+        drain(writer);
+
+        // Large writes go straight to the stream.
+        if (length >= writer->capacity) {
+            if (fwrite(data, sizeof(char), length, writer->out) < length) {
+                writer->failed = true;
+            }
+
+            if (writer->line_buffered) mt_writer_flush(writer);
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->length, data, length);
+    writer->length += length;
+    if (writer->line_buffered && memchr(data, '\n', length)) mt_writer_flush(writer);
+}
+
+void mt_writer_write_string(mt_Writer *writer, const char *string) {
+    mt_writer_write(writer, string, strlen(string));
+}
+
+void mt_writer_write_char(mt_Writer *writer, char c) {
+    if (writer->length == writer->capacity) drain(writer);
+    writer->buffer[writer->length++] = c;
+    if (writer->line_buffered && c == '\n') mt_writer_flush(writer);
+}
+
+void mt_writer_write_repeat(mt_Writer *writer, char c, size_t n) {
+    while (n > 0) {
+        if (writer->length == writer->capacity) drain(writer);
+
+        size_t chunk = writer->capacity - writer->length;
+        if (chunk > n) chunk = n;
+
+        memset(writer->buffer + writer->length, c, chunk);
+        writer->length += chunk;
+        n -= chunk;
+    }
+
+    if (writer->line_buffered && c == '\n') mt_writer_flush(writer);
+}
+
+void mt_writer_write_uint(mt_Writer *writer, uint64_t n) {
+    char digits[20];
+    size_t i = sizeof(digits);
+    do {
+        digits[--i] = (char)('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+
+    mt_writer_write(writer, digits + i, sizeof(digits) - i);
+}
+
+void mt_writer_write_int(mt_Writer *writer, int64_t n) {
+    if (n < 0) {
+        mt_writer_write_char(writer, '-');
+        mt_writer_write_uint(writer, -(uint64_t)n);
+    } else {
+        mt_writer_write_uint(writer, (uint64_t)n);
+    }
+}
+
+void mt_writer_write_double(mt_Writer *writer, double n) {
+    char buffer[mt_DTOA_BUFFER_SIZE];
+    mt_writer_write(writer, buffer, mt_dtoa(n, buffer));
+}
+
+static size_t utf8_sequence_length(unsigned char lead) {
+    if (lead >= 0xc2 && lead <= 0xdf) return 2;
+    if (lead >= 0xe0 && lead <= 0xef) return 3;
+    if (lead >= 0xf0 && lead <= 0xf4) return 4;
+    return 0;
+}
+
+void mt_writer_write_json_string(mt_Writer *writer, const char *data, size_t length) {
+    static const char *hex = "0123456789abcdef";
+
+    mt_writer_write_char(writer, '"');
+
+    // Copy runs of characters that don't need escaping in one go.
+    // Strings may hold arbitrary bytes (eg. from "\xff" escapes), so
+    // anything that isn't well-formed UTF-8 is escaped byte by byte
+    // to keep the output valid JSON.
+    size_t run = 0;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)data[i];
+        if (c >= 0x80) {
+            size_t sequence_length = utf8_sequence_length(c);
+            if (sequence_length && sequence_length <= length - i && mt_utf8_validate(data + i, sequence_length, NULL)) {
+                i += sequence_length - 1;
+                continue;
+            }
+        } else if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        mt_writer_write(writer, data + run, i - run);
+        run = i + 1;
+
+        switch (c) {
+        case '"':  mt_writer_write(writer, "\\\"", 2); break;
+        case '\\': mt_writer_write(writer, "\\\\", 2); break;
+        case '\n': mt_writer_write(writer, "\\n", 2); break;
+        case '\r': mt_writer_write(writer, "\\r", 2); break;
+        case '\t': mt_writer_write(writer, "\\t", 2); break;
+        default: {
+            char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+            mt_writer_write(writer, escape, sizeof(escape));
+            break;
+        }
+        }
+    }
+
+    mt_writer_write(writer, data + run, length - run);
+    mt_writer_write_char(writer, '"');
+}
+
+void mt_writer_write_u8(mt_Writer *writer, uint8_t n) {
+    mt_writer_write_char(writer, (char)n);
+}
+
+void mt_writer_write_u32(mt_Writer *writer, uint32_t n) {
+    char bytes[4];
+    for (size_t i = 0; i < sizeof(bytes); i++) bytes[i] = (char)(n >> (i * 8));
+    mt_writer_write(writer, bytes, sizeof(bytes));
+}
+
+void mt_writer_write_u64(mt_Writer *writer, uint64_t n) {
+    char bytes[8];
+    for (size_t i = 0; i < sizeof(bytes); i++) bytes[i] = (char)(n >> (i * 8));
+    mt_writer_write(writer, bytes, sizeof(bytes));
+}
+
+bool mt_writer_flush(mt_Writer *writer) {
+    drain(writer);
+    if (fflush(writer->out) != 0) writer->failed = true;
+    return !writer->failed;
+}
+
+bool mt_writer_free(mt_Writer *writer) {
+    bool ok = mt_writer_flush(writer);
+    free(writer->buffer);
+    free(writer);
+    return ok;
+}
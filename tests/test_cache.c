@@ -0,0 +1,241 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "common.h"
+#include "dump.h"
+#include "parser.h"
+#include "writer.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static char *path = "tests/build/test_cache.mtc";
+static char *source;
+static mt_Parser *parser;
+static mt_AstCache *cache;
+
+static void teardown() {
+    if (cache) mt_ast_cache_close(cache);
+    if (parser) mt_parser_free(parser);
+    if (source) free(source);
+    cache = NULL;
+    parser = NULL;
+    source = NULL;
+    remove(path);
+}
+
+static mt_Node *parse_fixture(uint64_t *hash) {
+    char *filename = "tests/fixtures/test_parser_basics.mt";
+    source = mt_read_entire_file(filename);
+    if (!source) return NULL;
+
+    *hash = mt_hash_source(source, strlen(source));
+    parser = mt_parser_init(filename, source);
+    return mt_parser_parse(parser);
+}
+
+static void corrupt_file(long offset, char value) {
+    FILE *handle = fopen(path, "r+b");
+    fseek(handle, offset, offset < 0 ? SEEK_END : SEEK_SET);
+    fputc(value, handle);
+    fclose(handle);
+}
+
+static char *test_cache_can_round_trip_trees() {
+    uint64_t hash;
+    mt_Node *tree = parse_fixture(&hash);
+    mu_assert("expected a tree", tree);
+    mu_assert("expected cache to be written", mt_ast_cache_write(path, hash, tree));
+
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected cache to open", cache);
+    mu_assert("expected cache to be valid", mt_ast_cache_validate(cache));
+
+    char *expected = NULL, *actual = NULL;
+    size_t expected_size = 0, actual_size = 0;
+    FILE *out = open_memstream(&expected, &expected_size);
+    mt_node_dump(tree, out);
+    fclose(out);
+
+    out = open_memstream(&actual, &actual_size);
+    mt_Writer *writer = mt_writer_init(out);
+    mt_ast_cache_dump(cache, writer, mt_DUMP_TEXT);
+    mt_writer_free(writer);
+    fclose(out);
+
+    int res = strcmp(expected, actual);
+    free(expected);
+    free(actual);
+    mu_assert("expected cached dump to match tree dump", res == 0);
+
+    mt_CachedNode *root = mt_ast_cache_root(cache);
+    mu_assert("expected a MODULE root", root->type == mt_NODE_MODULE);
+    mu_assert("expected 6 children", root->length == 6);
+
+    mt_CachedNode *child = mt_cached_node_child(cache, root, 2);
+    mu_assert("expected a NAME node", child->type == mt_NODE_NAME);
+    mu_assert("expected the name 'print'", strcmp(mt_cached_node_string(cache, child), "print") == 0);
+
+    uint32_t line, column;
+    mu_assert("expected a position", mt_cached_node_position(cache, child, &line, &column));
+    mu_assert("expected line 3", line == 3);
+
+    child = mt_cached_node_child(cache, root, 5);
+    mu_assert("expected a FLOAT node", child->type == mt_NODE_FLOAT);
+    mu_assert("expected the float 3.25", mt_cached_node_number(child).as_double == 3.25);
+    return 0;
+}
+
+static char *test_cache_rejects_stale_caches() {
+    uint64_t hash;
+    mt_Node *tree = parse_fixture(&hash);
+    mu_assert("expected a tree", tree);
+    mu_assert("expected cache to be written", mt_ast_cache_write(path, hash, tree));
+
+    cache = mt_ast_cache_open(path, hash + 1);
+    mu_assert("expected cache with a different hash to be rejected", !cache);
+
+    corrupt_file(offsetof(mt_AstCacheHeader, version), '9');
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected cache with a different version to be rejected", !cache);
+    return 0;
+}
+
+static char *test_cache_rejects_corrupt_headers() {
+    uint64_t hash;
+    mt_Node *tree = parse_fixture(&hash);
+    mu_assert("expected a tree", tree);
+    mu_assert("expected cache to be written", mt_ast_cache_write(path, hash, tree));
+
+    // Point the root's first child back at the root.
+    long children = sizeof(mt_AstCacheHeader) + sizeof(mt_AstCacheSection) * 6 + sizeof(mt_CachedNode) * 7;
+    corrupt_file(children, 0);
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected cache with a corrupt root to be rejected", !cache);
+
+    mu_assert("expected cache to be written", mt_ast_cache_write(path, hash, tree));
+    mu_assert("expected cache to be truncated", truncate(path, 64) == 0);
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected truncated cache to be rejected", !cache);
+    return 0;
+}
+
+static char *test_cache_validates_sections_lazily() {
+    uint64_t hash;
+    mt_Node *tree = parse_fixture(&hash);
+    mu_assert("expected a tree", tree);
+    mu_assert("expected cache to be written", mt_ast_cache_write(path, hash, tree));
+
+    // Change the type of the third top-level node.
+    long node = sizeof(mt_AstCacheHeader) + sizeof(mt_AstCacheSection) * 6 + sizeof(mt_CachedNode) * 3;
+    corrupt_file(node + offsetof(mt_CachedNode, type), 42);
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected cache to open", cache);
+
+    mt_CachedNode *root = mt_ast_cache_root(cache);
+    mu_assert("expected first section to be valid", mt_cached_node_child(cache, root, 0));
+    mu_assert("expected third section to be corrupt", !mt_cached_node_child(cache, root, 2));
+    mu_assert("expected cache to be corrupt", !mt_ast_cache_validate(cache));
+    mt_ast_cache_close(cache);
+
+    // Change the contents of the string table.
+    mu_assert("expected cache to be written", mt_ast_cache_write(path, hash, tree));
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected cache to open", cache);
+    long strings = cache->strings - (char *)cache->data;
+    mt_ast_cache_close(cache);
+
+    corrupt_file(strings, 'x');
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected cache to open", cache);
+
+    root = mt_ast_cache_root(cache);
+    mu_assert("expected first section to be valid", mt_cached_node_child(cache, root, 0));
+    mu_assert("expected string table to be corrupt", !mt_cached_node_string(cache, mt_cached_node_child(cache, root, 0)));
+    mt_ast_cache_close(cache);
+
+    // Change the contents of the position table, which comes last.
+    mu_assert("expected cache to be written", mt_ast_cache_write(path, hash, tree));
+    corrupt_file(-1, 42);
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected cache to open", cache);
+
+    uint32_t line, column;
+    root = mt_ast_cache_root(cache);
+    mu_assert("expected string table to be valid", mt_cached_node_string(cache, mt_cached_node_child(cache, root, 0)));
+    mu_assert("expected position table to be corrupt", !mt_cached_node_position(cache, root, &line, &column));
+    mu_assert("expected cache to be corrupt", !mt_ast_cache_validate(cache));
+    return 0;
+}
+
+static char *test_cache_decodes_positions_across_restarts() {
+    // Enough nodes for the position table to restart a few times,
+    // with columns that go backwards as well as forwards.
+    char source[4096];
+    size_t length = 0;
+    for (int i = 0; i < 200; i++) {
+        length += snprintf(source + length, sizeof(source) - length, i % 3 == 2 ? "a\n" : "%*sb ", i % 5, "");
+    }
+
+    uint64_t hash = mt_hash_source(source, length);
+    parser = mt_parser_init("[stdin]", source);
+    mt_Node *tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+    mu_assert("expected cache to be written", mt_ast_cache_write(path, hash, tree));
+
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected cache to open", cache);
+    mu_assert("expected cache to be valid", mt_ast_cache_validate(cache));
+    mu_assert("expected positions to take less space than the nodes", cache->header->positions < cache->header->nodes * 3);
+
+    mt_CachedNode *root = mt_ast_cache_root(cache);
+    uint32_t i = 0;
+    for (mt_NodeList *head = tree->value.as_node_list; head; head = head->next, i++) {
+        uint32_t line, column;
+        mt_CachedNode *child = mt_cached_node_child(cache, root, i);
+        mu_assert("expected a child", child);
+        mu_assert("expected a position", mt_cached_node_position(cache, child, &line, &column));
+        mu_assert("expected positions to round trip", line == head->value->line && column == head->value->column);
+    }
+
+    mu_assert("expected every child to be checked", i == root->length && i > mt_AST_CACHE_POSITION_INTERVAL * 2);
+    return 0;
+}
+
+static char *test_cache_interns_strings() {
+    uint64_t hash = mt_hash_source("a b a a b", 9);
+    parser = mt_parser_init("[stdin]", "a b a a b");
+    mt_Node *tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+    mu_assert("expected cache to be written", mt_ast_cache_write(path, hash, tree));
+
+    cache = mt_ast_cache_open(path, hash);
+    mu_assert("expected cache to open", cache);
+    mu_assert("expected strings to be interned", cache->header->strings == 4);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_cache_can_round_trip_trees);
+    mu_run_test(test_cache_rejects_stale_caches);
+    mu_run_test(test_cache_rejects_corrupt_headers);
+    mu_run_test(test_cache_validates_sections_lazily);
+    mu_run_test(test_cache_interns_strings);
+    mu_run_test(test_cache_decodes_positions_across_restarts);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
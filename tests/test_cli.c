@@ -0,0 +1,54 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cli.h"
+#include "str.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+
+static void teardown() {
+    mt_cli_set_args(NULL, 0);
+}
+
+static char *test_cli_exposes_args() {
+    char *argv[] = { "monty", "main.mt", "short", "an argument that doesn't fit inline" };
+    mt_cli_set_args(argv + 2, 2);
+    mu_assert("expected two arguments", mt_cli_arg_count() == 2);
+
+    mt_String arg;
+    mu_assert("expected the first argument", mt_cli_arg(0, &arg));
+    mu_assert("expected its contents", arg.length == 5 && memcmp(mt_string_data(&arg), "short", 5) == 0);
+
+    mu_assert("expected the second argument", mt_cli_arg(1, &arg));
+    mu_assert("expected long arguments not to be copied", mt_string_data(&arg) == argv[3] && !arg.owned);
+    mu_assert("expected out of bounds arguments to fail", !mt_cli_arg(2, &arg));
+    return 0;
+}
+
+static char *test_cli_defaults_to_no_args() {
+    mt_String arg;
+    mu_assert("expected no arguments", mt_cli_arg_count() == 0);
+    mu_assert("expected out of bounds arguments to fail", !mt_cli_arg(0, &arg));
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_cli_exposes_args);
+    mu_run_test(test_cli_defaults_to_no_args);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
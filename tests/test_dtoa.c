@@ -0,0 +1,90 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dtoa.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+
+static void teardown() {
+}
+
+static char *format(double value, char *buffer) {
+    size_t length = mt_dtoa(value, buffer);
+    buffer[length] = '\0';
+    return buffer;
+}
+
+static char *test_dtoa_formats_values() {
+    struct {
+        double value;
+        const char *expected;
+    } cases[] = {
+        { 0.0, "0.0" },
+        { -0.0, "-0.0" },
+        { 3, "3.0" },
+        { -42, "-42.0" },
+        { 0.1, "0.1" },
+        { 0.3, "0.3" },
+        { 2.0 / 3, "0.6666666666666666" },
+        { 123.456, "123.456" },
+        { 1e-5, "0.00001" },
+        { 1e-6, "1e-06" },
+        { 1.2345e-7, "1.2345e-07" },
+        { 1e16, "10000000000000000.0" },
+        { 1e17, "1e+17" },
+        { 1.5e300, "1.5e+300" },
+        { 5e-324, "5e-324" },
+        { 1.7976931348623157e308, "1.7976931348623157e+308" },
+        { INFINITY, "inf" },
+        { -INFINITY, "-inf" },
+        { NAN, "nan" },
+    };
+
+    char buffer[mt_DTOA_BUFFER_SIZE + 1];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        mu_assert("expected the value to be formatted", strcmp(format(cases[i].value, buffer), cases[i].expected) == 0);
+    }
+
+    return 0;
+}
+
+static char *test_dtoa_round_trips() {
+    char buffer[mt_DTOA_BUFFER_SIZE + 1];
+    uint64_t state = 88172645463325252ull;
+    for (int i = 0; i < 1000000; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        double value;
+        memcpy(&value, &state, sizeof(value));
+        if (!isfinite(value)) continue;
+
+        char *end = NULL;
+        mu_assert("expected the value to read back the same", strtod(format(value, buffer), &end) == value && *end == '\0');
+    }
+
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_dtoa_formats_values);
+    mu_run_test(test_dtoa_round_trips);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dump.h"
+#include "parser.h"
+#include "scanner.h"
+#include "writer.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static char *output;
+static size_t output_size;
+static FILE *out;
+static mt_Writer *writer;
+
+static void setup() {
+    out = open_memstream(&output, &output_size);
+    writer = mt_writer_init(out);
+}
+
+static void finish() {
+    mt_writer_free(writer);
+    fclose(out);
+    writer = NULL;
+    out = NULL;
+}
+
+static void teardown() {
+    if (writer) finish();
+    free(output);
+    output = NULL;
+}
+
+static char *test_dump_tokens_are_not_truncated() {
+    char source[1024];
+    memset(source, 'a', sizeof(source) - 1);
+    source[sizeof(source) - 1] = '\0';
+
+    mt_Scanner *scanner = mt_scanner_init(source);
+    mt_Token token;
+    mt_scanner_scan(scanner, &token);
+    mt_scanner_free(scanner);
+
+    setup();
+    mt_dump_token(writer, mt_DUMP_TEXT, &token);
+    finish();
+
+    mu_assert("expected the whole value to be dumped", strstr(output, source));
+    mu_assert("expected the position to be dumped", strstr(output, "', line=1, column=1)\n"));
+    return 0;
+}
+
+static char *test_dump_tokens_as_jsonl() {
+    char *source = "\"a\\\"\nb\" x";
+    mt_Scanner *scanner = mt_scanner_init(source);
+    mt_Token token;
+
+    setup();
+    do {
+        mt_scanner_scan(scanner, &token);
+        mt_dump_token(writer, mt_DUMP_JSONL, &token);
+    } while (token.type != mt_TOKEN_EOF);
+    finish();
+    mt_scanner_free(scanner);
+
+    char *expected =
+        "{\"type\":\"STRING\",\"value\":\"\\\"a\\\\\\\"\\nb\\\"\",\"line\":1,\"column\":1}\n"
+        "{\"type\":\"NAME\",\"value\":\"x\",\"line\":2,\"column\":4}\n"
+        "{\"type\":\"EOF\",\"value\":\"\",\"line\":2,\"column\":5}\n";
+    mu_assert("expected escaped JSON lines", strcmp(output, expected) == 0);
+    return 0;
+}
+
+static char *test_dump_trees_as_jsonl_with_invalid_utf8() {
+    mt_Parser *parser = mt_parser_init("[stdin]", "\"caf\xc3\xa9 \\xff\\xc3\"");
+    mt_Node *tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+
+    setup();
+    mt_dump_tree(writer, mt_DUMP_JSONL, tree);
+    finish();
+    mt_parser_free(parser);
+
+    char *expected =
+        "{\"id\":0,\"parent\":null,\"type\":\"MODULE\",\"line\":0,\"column\":0}\n"
+        "{\"id\":1,\"parent\":0,\"type\":\"STRING\",\"value\":\"caf\xc3\xa9 \\u00ff\\u00c3\",\"line\":1,\"column\":1}\n";
+    mu_assert("expected invalid UTF-8 to be escaped", strcmp(output, expected) == 0);
+    return 0;
+}
+
+static char *test_dump_eof_tokens_without_a_value() {
+    mt_Scanner *scanner = mt_scanner_init("");
+    mt_Token token;
+    mt_scanner_scan(scanner, &token);
+    mt_scanner_free(scanner);
+
+    setup();
+    mt_dump_token(writer, mt_DUMP_TEXT, &token);
+    mt_dump_token(writer, mt_DUMP_BINARY, &token);
+    finish();
+
+    char *expected = "Token(type='TOKEN_EOF', value='', line=1, column=1)\n";
+    size_t text_size = strlen(expected);
+    mu_assert("expected an empty text value", output_size > text_size && memcmp(output, expected, text_size) == 0);
+    mu_assert("expected an empty binary value", output_size == text_size + 13 && memcmp(output + text_size + 9, "\0\0\0\0", 4) == 0);
+    return 0;
+}
+
+static char *test_dump_trees_as_binary() {
+    mt_Parser *parser = mt_parser_init("[stdin]", "abc");
+    mt_Node *tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+
+    setup();
+    mt_dump_tree(writer, mt_DUMP_BINARY, tree);
+    finish();
+    mt_parser_free(parser);
+
+    char expected[] = {
+        mt_NODE_MODULE, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+        mt_NODE_NAME, 1, 0, 0, 0, 1, 0, 0, 0, 3, 0, 0, 0, 'a', 'b', 'c',
+    };
+    mu_assert("expected 29 bytes", output_size == sizeof(expected));
+    mu_assert("expected binary records", memcmp(output, expected, sizeof(expected)) == 0);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_dump_tokens_are_not_truncated);
+    mu_run_test(test_dump_tokens_as_jsonl);
+    mu_run_test(test_dump_trees_as_jsonl_with_invalid_utf8);
+    mu_run_test(test_dump_eof_tokens_without_a_value);
+    mu_run_test(test_dump_trees_as_binary);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "heap.h"
+#include "parser.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static char path[256];
+static FILE *out;
+
+static void teardown() {
+    if (out) fclose(out);
+    out = NULL;
+}
+
+static char *read_snapshot(char *buffer, size_t size) {
+    out = tmpfile();
+    if (!out || !mt_heap_profile_write(out)) return NULL;
+
+    rewind(out);
+    size_t length = fread(buffer, 1, size - 1, out);
+    buffer[length] = '\0';
+    return buffer;
+}
+
+/// Find the counters on the first line of a snapshot that contains
+/// a name.
+static bool find_counters(char *snapshot, char *name, unsigned long long counters[4]) {
+    for (char *line = strtok(snapshot, "\n"); line; line = strtok(NULL, "\n")) {
+        if (!strstr(line, name)) continue;
+
+        return sscanf(line, "%*s %llu %llu %llu %llu", &counters[0], &counters[1], &counters[2], &counters[3]) == 4;
+    }
+
+    return false;
+}
+
+static mt_HeapCounter kind = mt_HEAP_KIND("Widget");
+
+static void *allocate_widget() {
+    mt_HEAP_SITE(site);
+    return mt_heap_alloc(&site, &kind, 24);
+}
+
+static char *test_heap_counts_live_and_total_memory() {
+    void *widgets[3];
+    for (int i = 0; i < 3; i++) widgets[i] = allocate_widget();
+    mt_heap_free(widgets[1]);
+
+    char buffer[4096];
+    unsigned long long counters[4];
+    mu_assert("expected a snapshot", read_snapshot(buffer, sizeof(buffer)));
+    mu_assert("expected the site's counters", find_counters(buffer, " allocate_widget tests/test_heap.c:", counters));
+    mu_assert("expected 2 live allocations", counters[0] == 2 && counters[1] == 48);
+    mu_assert("expected 3 allocations in total", counters[2] == 3 && counters[3] == 72);
+
+    mu_assert("expected a snapshot", read_snapshot(buffer, sizeof(buffer)));
+    mu_assert("expected the kind's counters", find_counters(buffer, " Widget -", counters));
+    mu_assert("expected the kind to match the site", counters[0] == 2 && counters[2] == 3);
+
+    mt_heap_free(widgets[0]);
+    mt_heap_free(widgets[2]);
+    return 0;
+}
+
+static char *test_heap_counts_nodes_by_type() {
+    mt_Parser *parser = mt_parser_init("[stdin]", "a b C");
+    mu_assert("expected a tree", mt_parser_parse(parser));
+
+    char buffer[4096];
+    unsigned long long counters[4];
+    mu_assert("expected a snapshot", read_snapshot(buffer, sizeof(buffer)));
+    mu_assert("expected NAME nodes to be counted", find_counters(buffer, " NAME -", counters));
+    mu_assert("expected 2 live NAME nodes", counters[0] == 2);
+
+    mt_parser_free(parser);
+    mu_assert("expected a snapshot", read_snapshot(buffer, sizeof(buffer)));
+    mu_assert("expected NAME nodes to be counted", find_counters(buffer, " NAME -", counters));
+    mu_assert("expected NAME nodes to be freed", counters[0] == 0 && counters[2] == 2);
+    return 0;
+}
+
+static char *test_heap_writes_snapshots_on_sigusr1() {
+    raise(SIGUSR1);
+    mt_heap_free(allocate_widget());
+
+    char snapshot_path[300];
+    snprintf(snapshot_path, sizeof(snapshot_path), "%s.1", path);
+    out = fopen(snapshot_path, "r");
+    mu_assert("expected a snapshot to be written", out);
+
+    char line[256];
+    mu_assert("expected the snapshot's header", fgets(line, sizeof(line), out) && strcmp(line, "# monty heap snapshot v1\n") == 0);
+    mu_assert("expected the columns' header", fgets(line, sizeof(line), out) && strcmp(line, "# site|kind live_count live_bytes total_count total_bytes name location\n") == 0);
+    remove(snapshot_path);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_heap_counts_live_and_total_memory);
+    mu_run_test(test_heap_counts_nodes_by_type);
+    mu_run_test(test_heap_writes_snapshots_on_sigusr1);
+    return 0;
+}
+
+int main(void) {
+    snprintf(path, sizeof(path), "/tmp/test_heap.%d", (int)getpid());
+    if (!mt_heap_profile_start(path)) {
+        fprintf(stderr, "ERROR: could not start the heap profiler\n");
+        return 0;
+    }
+
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
@@ -0,0 +1,337 @@
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "io.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static mt_IoLoop *loop;
+static char *path = "tests/build/test_io.txt";
+
+static void teardown() {
+    if (loop) mt_io_loop_free(loop);
+    loop = NULL;
+    remove(path);
+}
+
+/// Reads into a growing buffer until EOF.
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+    int error;
+    bool eof;
+} Sink;
+
+static void on_sink_read(mt_IoLoop *loop, mt_IoRequest *request) {
+    Sink *sink = request->data;
+    if (request->result <= 0) {
+        sink->error = request->error;
+        sink->eof = request->result == 0;
+        return;
+    }
+
+    sink->length += (size_t)request->result;
+    if (sink->length == sink->capacity) {
+        sink->capacity *= 2;
+        sink->data = realloc(sink->data, sink->capacity);
+    }
+
+    mt_io_read(loop, request->fd, sink->data + sink->length, sink->capacity - sink->length, on_sink_read, sink);
+}
+
+static bool start_sink(Sink *sink, int fd) {
+    sink->capacity = 4096;
+    sink->length = 0;
+    sink->data = malloc(sink->capacity);
+    sink->error = 0;
+    sink->eof = false;
+    return sink->data && mt_io_read(loop, fd, sink->data, sink->capacity, on_sink_read, sink);
+}
+
+static void on_write_then_close(mt_IoLoop *loop, mt_IoRequest *request) {
+    (void)loop;
+    *(ssize_t *)request->data = request->result;
+    close(request->fd);
+}
+
+static char *fill(size_t length) {
+    char *data = malloc(length);
+    for (size_t i = 0; i < length; i++) data[i] = (char)('a' + i % 26);
+    return data;
+}
+
+static char *test_io_streams_through_pipes() {
+    // More than a pipe can hold, so the write has to wait for the
+    // read side to drain it.
+    size_t length = 1 << 20;
+    char *data = fill(length);
+    int fds[2];
+    mu_assert("expected a pipe", pipe(fds) == 0);
+
+    loop = mt_io_loop_init();
+    mu_assert("expected a loop", loop);
+
+    Sink sink;
+    ssize_t written = 0;
+    mu_assert("expected the write to be submitted", mt_io_write(loop, fds[1], data, length, on_write_then_close, &written));
+    mu_assert("expected the read to be submitted", start_sink(&sink, fds[0]));
+    mu_assert("expected the loop to run", mt_io_run(loop));
+
+    bool same = sink.length == length && memcmp(sink.data, data, length) == 0;
+    close(fds[0]);
+    free(sink.data);
+    free(data);
+    mu_assert("expected the whole buffer to be written", written == (ssize_t)length);
+    mu_assert("expected the reader to reach EOF", sink.eof);
+    mu_assert("expected the data to arrive intact", same);
+    return 0;
+}
+
+static char *test_io_reads_and_writes_files() {
+    FILE *handle = fopen(path, "wb");
+    mu_assert("expected a file", handle);
+    fclose(handle);
+
+    loop = mt_io_loop_init();
+    mu_assert("expected a loop", loop);
+
+    size_t length = 100000;
+    char *data = fill(length);
+    ssize_t written = 0;
+    int fd = open(path, O_WRONLY);
+    mu_assert("expected the write to be submitted", mt_io_write(loop, fd, data, length, on_write_then_close, &written));
+    mu_assert("expected the loop to run", mt_io_run(loop));
+    mu_assert("expected the file to be written", written == (ssize_t)length);
+
+    Sink sink;
+    fd = open(path, O_RDONLY);
+    mu_assert("expected the read to be submitted", start_sink(&sink, fd));
+    mu_assert("expected the loop to run", mt_io_run(loop));
+
+    bool same = sink.length == length && memcmp(sink.data, data, length) == 0;
+    close(fd);
+    free(sink.data);
+    free(data);
+    mu_assert("expected the file to be read back", sink.eof && same);
+    return 0;
+}
+
+/// Echoes everything a client sends back to it.
+typedef struct {
+    char buffer[64];
+    int fd;
+} Echo;
+
+static void on_echo_read(mt_IoLoop *loop, mt_IoRequest *request);
+
+static void on_echo_write(mt_IoLoop *loop, mt_IoRequest *request) {
+    Echo *echo = request->data;
+    mt_io_read(loop, echo->fd, echo->buffer, sizeof(echo->buffer), on_echo_read, echo);
+}
+
+static void on_echo_read(mt_IoLoop *loop, mt_IoRequest *request) {
+    Echo *echo = request->data;
+    if (request->result <= 0) {
+        close(echo->fd);
+        return;
+    }
+
+    mt_io_write(loop, echo->fd, echo->buffer, (size_t)request->result, on_echo_write, echo);
+}
+
+static void on_accept(mt_IoLoop *loop, mt_IoRequest *request) {
+    Echo *echo = request->data;
+    echo->fd = (int)request->result;
+    if (echo->fd >= 0) mt_io_read(loop, echo->fd, echo->buffer, sizeof(echo->buffer), on_echo_read, echo);
+}
+
+static void on_client_write(mt_IoLoop *loop, mt_IoRequest *request) {
+    (void)loop;
+    shutdown(request->fd, SHUT_WR);
+}
+
+static char *test_io_serves_loopback_sockets() {
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = 0 };
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    mu_assert("expected a listening socket", server >= 0
+        && bind(server, (struct sockaddr *)&address, sizeof(address)) == 0
+        && listen(server, 1) == 0
+        && getsockname(server, (struct sockaddr *)&address, &address_length) == 0);
+
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    mu_assert("expected to connect", client >= 0 && connect(client, (struct sockaddr *)&address, sizeof(address)) == 0);
+
+    loop = mt_io_loop_init();
+    mu_assert("expected a loop", loop);
+
+    Echo echo;
+    Sink sink;
+    char *message = "ping ping ping ping ping ping ping ping ping ping ping ping ping ping ping ping";
+    mu_assert("expected the accept to be submitted", mt_io_accept(loop, server, on_accept, &echo));
+    mu_assert("expected the write to be submitted", mt_io_write(loop, client, message, strlen(message), on_client_write, NULL));
+    mu_assert("expected the read to be submitted", start_sink(&sink, client));
+    mu_assert("expected the loop to run", mt_io_run(loop));
+
+    bool same = sink.length == strlen(message) && memcmp(sink.data, message, sink.length) == 0;
+    close(client);
+    close(server);
+    free(sink.data);
+    mu_assert("expected the message to be echoed back", sink.eof && same);
+    return 0;
+}
+
+/// Writes into a pipe after a delay, so that reading from it has to
+/// wait for epoll.
+typedef struct {
+    int fd;
+    pthread_t thread;
+} DelayedWrite;
+
+static void *write_later(void *data) {
+    DelayedWrite *delayed = data;
+    usleep(100000);
+    ssize_t written = write(delayed->fd, "x", 1);
+    (void)written;
+    return NULL;
+}
+
+static bool start_delayed_write(DelayedWrite *delayed, int fd) {
+    delayed->fd = fd;
+    return pthread_create(&delayed->thread, NULL, write_later, delayed) == 0;
+}
+
+typedef struct {
+    int fds[2];  ///< the pipe that replaced the one that was closed
+    int reused_fd;
+    DelayedWrite delayed;
+    char buffer[16];
+    ssize_t result;
+} Reuse;
+
+static void on_reused_read(mt_IoLoop *loop, mt_IoRequest *request) {
+    (void)loop;
+    ((Reuse *)request->data)->result = request->result;
+}
+
+static void on_read_then_reuse(mt_IoLoop *loop, mt_IoRequest *request) {
+    Reuse *reuse = request->data;
+    pthread_join(reuse->delayed.thread, NULL);
+    close(request->fd);
+    reuse->reused_fd = request->fd;
+
+    // The lowest free fd is the one that was just closed.
+    if (pipe(reuse->fds) != 0 || !start_delayed_write(&reuse->delayed, reuse->fds[1])) return;
+    mt_io_read(loop, reuse->fds[0], reuse->buffer, sizeof(reuse->buffer), on_reused_read, reuse);
+}
+
+static char *test_io_waits_on_reused_fds() {
+    int fds[2];
+    mu_assert("expected a pipe", pipe(fds) == 0);
+
+    loop = mt_io_loop_init();
+    mu_assert("expected a loop", loop);
+
+    Reuse reuse = { .fds = { -1, -1 }, .result = -1 };
+    char buffer[16];
+    mu_assert("expected the write to start", start_delayed_write(&reuse.delayed, fds[1]));
+    mu_assert("expected the read to be submitted", mt_io_read(loop, fds[0], buffer, sizeof(buffer), on_read_then_reuse, &reuse));
+
+    // Kill the test rather than hang if the new fd is never waited on.
+    alarm(5);
+    mu_assert("expected the loop to run", mt_io_run(loop));
+    alarm(0);
+
+    bool reused = reuse.fds[0] == reuse.reused_fd;
+    pthread_join(reuse.delayed.thread, NULL);
+    close(fds[1]);
+    close(reuse.fds[0]);
+    close(reuse.fds[1]);
+    mu_assert("expected the closed fd's number to be reused", reused);
+    mu_assert("expected the read on the reused fd to complete", reuse.result == 1);
+    return 0;
+}
+
+static void on_write(mt_IoLoop *loop, mt_IoRequest *request) {
+    (void)loop;
+    *(ssize_t *)request->data = request->result;
+}
+
+static char *test_io_restores_fd_flags() {
+    int fds[2];
+    mu_assert("expected a pipe", pipe(fds) == 0);
+
+    loop = mt_io_loop_init();
+    mu_assert("expected a loop", loop);
+
+    ssize_t written = 0;
+    mu_assert("expected the write to be submitted", mt_io_write(loop, fds[1], "hi", 2, on_write, &written));
+    mu_assert("expected the fd to be non-blocking while it's in use", fcntl(fds[1], F_GETFL) & O_NONBLOCK);
+    mu_assert("expected the loop to run", mt_io_run(loop));
+    mu_assert("expected the write to complete", written == 2);
+    mu_assert("expected the fd's flags to be restored", !(fcntl(fds[1], F_GETFL) & O_NONBLOCK));
+
+    // Nothing more is ever written, so this read never completes.
+    char buffer[16];
+    mu_assert("expected the read to be submitted", mt_io_read(loop, fds[0], buffer, sizeof(buffer), NULL, NULL));
+    mu_assert("expected the fd to be non-blocking while it's in use", fcntl(fds[0], F_GETFL) & O_NONBLOCK);
+    mt_io_loop_free(loop);
+    loop = NULL;
+
+    bool restored = !(fcntl(fds[0], F_GETFL) & O_NONBLOCK);
+    close(fds[0]);
+    close(fds[1]);
+    mu_assert("expected freeing the loop to restore the fd's flags", restored);
+    return 0;
+}
+
+static char *test_io_reads_all_of_stdin() {
+    size_t length = 1 << 20;
+    char *data = fill(length);
+    for (size_t i = 99; i < length; i += 100) data[i] = '\n';
+
+    FILE *handle = fopen(path, "wb");
+    mu_assert("expected a file", handle);
+    fwrite(data, 1, length, handle);
+    fclose(handle);
+
+    mu_assert("expected stdin to be redirected", freopen(path, "rb", stdin));
+    char *source = mt_read_entire_stdin();
+    bool same = source && strlen(source) == length && memcmp(source, data, length) == 0;
+    free(source);
+    free(data);
+    mu_assert("expected all of stdin to be read", same);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_io_streams_through_pipes);
+    mu_run_test(test_io_reads_and_writes_files);
+    mu_run_test(test_io_serves_loopback_sockets);
+    mu_run_test(test_io_waits_on_reused_fds);
+    mu_run_test(test_io_restores_fd_flags);
+    mu_run_test(test_io_reads_all_of_stdin);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "list.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static mt_List *list;
+
+static void teardown() {
+    if (list) mt_list_free(list);
+    list = NULL;
+}
+
+static char *test_list_stores_integers_unboxed() {
+    list = mt_list_init(mt_TYPE_INTEGER);
+    mu_assert("expected a list", list);
+    mu_assert("expected 8-byte elements", list->element_size == sizeof(int64_t));
+
+    for (int64_t i = 0; i < 1000; i++) {
+        mu_assert("expected the push to succeed", mt_list_push_integer(list, i * i));
+    }
+
+    mu_assert("expected 1000 elements", list->length == 1000);
+    int64_t *integers = (int64_t *)list->elements;
+    for (int64_t i = 0; i < 1000; i++) {
+        mu_assert("expected the elements to be contiguous", integers[i] == i * i);
+    }
+
+    mu_assert("expected out of bounds accesses to fail", mt_list_at(list, 1000) == NULL);
+    mu_assert("expected in bounds accesses to succeed", *(int64_t *)mt_list_at(list, 999) == 999 * 999);
+    return 0;
+}
+
+static char *test_list_pushes_and_pops() {
+    list = mt_list_init(mt_TYPE_FLOAT);
+    mu_assert("expected a list", list);
+    mu_assert("expected the reservation to succeed", mt_list_reserve(list, 3));
+    mu_assert("expected the capacity to be reserved", list->capacity == 3);
+
+    double value = 2.5;
+    mu_assert("expected the push to succeed", mt_list_push(list, &value));
+    mu_assert("expected the push to succeed", mt_list_push_float(list, 0.5));
+
+    double popped = 0;
+    mu_assert("expected the pop to succeed", mt_list_pop(list, &popped));
+    mu_assert("expected the last element", popped == 0.5);
+    mu_assert("expected the pop to succeed", mt_list_pop(list, NULL));
+    mu_assert("expected the list to be empty", list->length == 0);
+    mu_assert("expected popping an empty list to fail", !mt_list_pop(list, &popped));
+    return 0;
+}
+
+static char *test_list_stores_other_types_as_pointers() {
+    list = mt_list_init(mt_TYPE_STRING);
+    mu_assert("expected a list", list);
+    mu_assert("expected pointer-sized elements", list->element_size == sizeof(void *));
+
+    char *names[] = { "a", "b", "c" };
+    for (int i = 0; i < 3; i++) {
+        mu_assert("expected the push to succeed", mt_list_push_pointer(list, names[i]));
+    }
+
+    mu_assert("expected the pointer to be stored", *(char **)mt_list_at(list, 1) == names[1]);
+    return 0;
+}
+
+static char *test_list_iterates_in_order() {
+    list = mt_list_init(mt_TYPE_INTEGER);
+    mu_assert("expected a list", list);
+
+    mt_ListIterator empty = mt_list_iter(list);
+    mu_assert("expected an empty list to have nothing to iterate", !mt_list_has_more(&empty));
+
+    for (int64_t i = 1; i <= 100; i++) mt_list_push_integer(list, i);
+
+    int64_t sum = 0;
+    int64_t previous = 0;
+    for (mt_ListIterator it = mt_list_iter(list); mt_list_has_more(&it);) {
+        int64_t element = *(int64_t *)mt_list_get_next(&it);
+        mu_assert("expected elements in order", element == previous + 1);
+        previous = element;
+        sum += element;
+    }
+
+    mu_assert("expected every element to be visited", sum == 5050);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_list_stores_integers_unboxed);
+    mu_run_test(test_list_pushes_and_pops);
+    mu_run_test(test_list_stores_other_types_as_pointers);
+    mu_run_test(test_list_iterates_in_order);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
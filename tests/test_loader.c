@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "loader.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static mt_Loader *loader;
+
+static void teardown() {
+    if (loader) mt_loader_free(loader);
+    loader = NULL;
+}
+
+static mt_Loader *make_loader(bool use_cache) {
+    loader = mt_loader_init(4);
+    if (!loader) return NULL;
+
+    loader->use_cache = use_cache;
+    if (!mt_loader_add_search_path(loader, "tests/fixtures/loader_lib")) return NULL;
+    return loader;
+}
+
+static bool ends_with(const char *s, const char *suffix) {
+    size_t length = strlen(s), suffix_length = strlen(suffix);
+    return length >= suffix_length && strcmp(s + length - suffix_length, suffix) == 0;
+}
+
+static char *test_loader_loads_imports_once() {
+    mu_assert("expected a loader", make_loader(false));
+
+    mt_Module *root = mt_loader_load(loader, "tests/fixtures/loader/main.mt");
+    mu_assert("expected the module to load", root);
+    mu_assert("expected two imports", root->import_count == 2);
+
+    mt_Module *a = root->imports[0];
+    mt_Module *b = root->imports[1];
+    mu_assert("expected a.mt", ends_with(a->path, "/loader/a.mt"));
+    mu_assert("expected pkg/b.mt", ends_with(b->path, "/loader/pkg/b.mt"));
+    mu_assert("expected pkg.b to be loaded once", a->import_count == 1 && a->imports[0] == b);
+
+    mt_Module *c = b->imports[0];
+    mu_assert("expected lib.c to be found on the search path", ends_with(c->path, "/loader_lib/lib/c.mt"));
+    mu_assert("expected 4 modules", loader->module_count == 4);
+    mu_assert("expected modules to be parsed", c->state == mt_MODULE_LOADED && c->tree && !c->cache);
+
+    mu_assert("expected loading again to reuse the module", mt_loader_load(loader, "tests/fixtures/loader/./main.mt") == root);
+    mu_assert("expected no new modules", loader->module_count == 4);
+    return 0;
+}
+
+static char *test_loader_reuses_caches() {
+    mu_assert("expected a loader", make_loader(true));
+    mu_assert("expected the module to load", mt_loader_load(loader, "tests/fixtures/loader/main.mt"));
+    mt_loader_free(loader);
+
+    mu_assert("expected a loader", make_loader(true));
+    mt_Module *root = mt_loader_load(loader, "tests/fixtures/loader/main.mt");
+    mu_assert("expected the module to load", root);
+    mu_assert("expected the tree to come from the cache", root->cache && !root->tree);
+    mu_assert("expected imports to come from the cache", root->imports[1]->imports[0]->cache);
+    mu_assert("expected imports to be skimmed", root->declarations && root->declarations->length == 2);
+    return 0;
+}
+
+static char *test_loader_handles_cycles() {
+    mu_assert("expected a loader", make_loader(false));
+
+    mt_Module *root = mt_loader_load(loader, "tests/fixtures/loader/cycle_a.mt");
+    mu_assert("expected the module to load", root);
+    mu_assert("expected the cycle to be closed", root->imports[0]->imports[0] == root);
+    return 0;
+}
+
+static char *test_loader_reports_missing_modules() {
+    mu_assert("expected a loader", make_loader(false));
+
+    mu_assert("expected loading to fail", !mt_loader_load(loader, "tests/fixtures/loader/missing.mt"));
+    mu_assert("expected a missing module error", strstr(loader->error, "/loader/missing.mt:2:1: could not find module 'nowhere'"));
+
+    mu_assert("expected loading to fail", !mt_loader_load(loader, "tests/fixtures/loader/nope.mt"));
+    mu_assert("expected a missing file error", strcmp(loader->error, "tests/fixtures/loader/nope.mt: could not read file") == 0);
+
+    mu_assert("expected unrelated modules to still load", mt_loader_load(loader, "tests/fixtures/loader/a.mt"));
+    return 0;
+}
+
+static char *test_loader_resolves_names() {
+    mu_assert("expected a loader", make_loader(false));
+
+    mt_Module *root = mt_loader_load(loader, "tests/fixtures/loader/main.mt");
+    mu_assert("expected the module to load", root);
+    mu_assert("expected imports to be declared as globals", root->resolver && root->resolver->global_count == 2);
+
+    mt_NodeList *head = root->tree->value.as_node_list;
+    mu_assert("expected a to be bound", head->value->binding.type == mt_BINDING_GLOBAL && head->value->binding.index == 0);
+    mu_assert("expected pkg to be bound", head->next->value->binding.type == mt_BINDING_GLOBAL && head->next->value->binding.index == 1);
+
+    mu_assert("expected loading to fail", !mt_loader_load(loader, "tests/fixtures/loader/undefined.mt"));
+    mu_assert("expected an undefined name error", strstr(loader->error, "/loader/undefined.mt:2:1: undefined name 'b'"));
+    return 0;
+}
+
+static char *test_loader_loads_modules_the_parser_cannot_handle() {
+    mu_assert("expected a loader", make_loader(true));
+
+    mt_Module *root = mt_loader_load(loader, "tests/fixtures/loader/program.mt");
+    mu_assert("expected the module to load", root);
+    mu_assert("expected its imports to load", root->import_count == 1 && root->imports[0]->state == mt_MODULE_LOADED);
+    mu_assert("expected neither a tree nor a cache", !root->tree && !root->cache);
+    mu_assert("expected the parse error to be kept", strstr(root->error, "/loader/program.mt:3:1: unexpected 'record'"));
+
+    mt_DeclarationList *list = root->declarations;
+    mu_assert("expected three declarations", list->length == 3);
+    mu_assert("expected the import", list->declarations[0].type == mt_DECLARATION_IMPORT);
+    mu_assert("expected the record", list->declarations[1].type == mt_DECLARATION_RECORD);
+    mu_assert("expected the def", list->declarations[2].type == mt_DECLARATION_DEF);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_loader_loads_imports_once);
+    mu_run_test(test_loader_reuses_caches);
+    mu_run_test(test_loader_handles_cycles);
+    mu_run_test(test_loader_reports_missing_modules);
+    mu_run_test(test_loader_resolves_names);
+    mu_run_test(test_loader_loads_modules_the_parser_cannot_handle);
+    return 0;
+}
+
+int main(void) {
+    // Keep cache files out of the fixtures directory.
+    setenv("MONTY_CACHE_DIR", "tests/build", 1);
+
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
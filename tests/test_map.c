@@ -0,0 +1,155 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "map.h"
+#include "str.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static mt_Map *map;
+
+static void teardown() {
+    if (map) mt_map_free(map);
+    map = NULL;
+}
+
+static mt_MapKey integer_key(int64_t integer) {
+    return (mt_MapKey){ .integer = integer };
+}
+
+static char *test_map_puts_and_gets_integer_keys() {
+    map = mt_map_init(mt_TYPE_INTEGER, mt_TYPE_INTEGER);
+    mu_assert("expected a map", map);
+    mu_assert("expected lookups in an empty map to fail", mt_map_get(map, integer_key(1)) == NULL);
+
+    for (int64_t i = 0; i < 10000; i++) {
+        bool inserted = false;
+        int64_t *value = mt_map_put(map, integer_key(i * 7919), &inserted);
+        mu_assert("expected the put to succeed", value);
+        mu_assert("expected the key to be inserted", inserted);
+        mu_assert("expected a zeroed value", *value == 0);
+        *value = i;
+    }
+
+    mu_assert("expected 10000 keys", map->count == 10000);
+    mu_assert("expected a power of 2 capacity", (map->capacity & (map->capacity - 1)) == 0);
+    mu_assert("expected some empty slots", map->count < map->capacity * 7 / 8);
+
+    for (int64_t i = 0; i < 10000; i++) {
+        int64_t *value = mt_map_get(map, integer_key(i * 7919));
+        mu_assert("expected every key to be found", value && *value == i);
+    }
+
+    bool inserted = true;
+    int64_t *value = mt_map_put(map, integer_key(7919), &inserted);
+    mu_assert("expected existing keys not to be inserted again", !inserted && *value == 1);
+    mu_assert("expected missing keys not to be found", mt_map_get(map, integer_key(7918)) == NULL);
+    return 0;
+}
+
+static char *test_map_removes_keys() {
+    map = mt_map_init(mt_TYPE_INTEGER, mt_TYPE_INTEGER);
+    mu_assert("expected a map", map);
+
+    // Churn through far more keys than the table ever holds at once
+    // so tombstones have to be cleaned up without growing it.
+    for (int64_t i = 0; i < 100000; i++) {
+        mu_assert("expected the put to succeed", mt_map_put(map, integer_key(i), NULL));
+        if (i >= 100) {
+            mu_assert("expected the remove to succeed", mt_map_remove(map, integer_key(i - 100)));
+        }
+    }
+
+    mu_assert("expected 100 keys", map->count == 100);
+    mu_assert("expected the table not to keep growing", map->capacity <= 512);
+    mu_assert("expected removing a missing key to fail", !mt_map_remove(map, integer_key(0)));
+    for (int64_t i = 0; i < 100000; i++) {
+        mu_assert("expected only the last keys to be found", (mt_map_get(map, integer_key(i)) != NULL) == (i >= 99900));
+    }
+
+    return 0;
+}
+
+static char *test_map_compares_string_keys_by_contents() {
+    map = mt_map_init(mt_TYPE_STRING, mt_TYPE_UNKNOWN);
+    mu_assert("expected a map", map);
+
+    mt_String keys[64];
+    char buffer[32];
+    for (int i = 0; i < 64; i++) {
+        int length = snprintf(buffer, sizeof(buffer), "a fairly long key number %d", i);
+        mu_assert("expected the key to be created", mt_string_init(&keys[i], buffer, (size_t)length));
+
+        void **value = mt_map_put(map, (mt_MapKey){ .string = &keys[i] }, NULL);
+        mu_assert("expected the put to succeed", value);
+        *value = &keys[i];
+    }
+
+    for (int i = 0; i < 64; i++) {
+        void **value = mt_map_get(map, (mt_MapKey){ .string = &keys[i] });
+        mu_assert("expected interned keys to be found", value && *value == &keys[i]);
+
+        mt_String copy;
+        int length = snprintf(buffer, sizeof(buffer), "a fairly long key number %d", i);
+        mt_string_init_view(&copy, buffer, (size_t)length);
+        value = mt_map_get(map, (mt_MapKey){ .string = &copy });
+        mu_assert("expected equal keys to be found", value && *value == &keys[i]);
+    }
+
+    mt_String missing;
+    mt_string_init_view(&missing, "missing", 7);
+    mu_assert("expected missing keys not to be found", mt_map_get(map, (mt_MapKey){ .string = &missing }) == NULL);
+
+    mt_map_free(map);
+    map = NULL;
+    for (int i = 0; i < 64; i++) mt_string_free(&keys[i]);
+    return 0;
+}
+
+static char *test_map_iterates_every_key() {
+    map = mt_map_init(mt_TYPE_INTEGER, mt_TYPE_FLOAT);
+    mu_assert("expected a map", map);
+
+    mt_MapIterator empty = mt_map_iter(map);
+    mu_assert("expected an empty map to have nothing to iterate", !mt_map_has_more(&empty));
+
+    for (int64_t i = 0; i < 1000; i++) *(double *)mt_map_put(map, integer_key(i), NULL) = (double)i / 2;
+    for (int64_t i = 0; i < 1000; i += 2) mt_map_remove(map, integer_key(i));
+
+    bool seen[1000] = { false };
+    uint32_t count = 0;
+    for (mt_MapIterator it = mt_map_iter(map); mt_map_has_more(&it);) {
+        void *value;
+        mt_MapKey key = mt_map_get_next(&it, &value);
+        mu_assert("expected only the remaining keys", key.integer % 2 == 1 && !seen[key.integer]);
+        mu_assert("expected the key's value", *(double *)value == (double)key.integer / 2);
+        seen[key.integer] = true;
+        count += 1;
+    }
+
+    mu_assert("expected every key to be visited", count == 500);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_map_puts_and_gets_integer_keys);
+    mu_run_test(test_map_removes_keys);
+    mu_run_test(test_map_compares_string_keys_by_contents);
+    mu_run_test(test_map_iterates_every_key);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
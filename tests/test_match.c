@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "match.h"
+#include "str.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static mt_DecisionTree *tree;
+
+static void teardown() {
+    mt_match_free(tree);
+    tree = NULL;
+}
+
+static mt_Pattern integer(int64_t value, uint32_t line) {
+    return (mt_Pattern){ .type = mt_PATTERN_INTEGER, .value.as_integer = value, .line = line, .column = 3 };
+}
+
+static mt_Pattern string(char *value, uint32_t line) {
+    mt_Pattern pattern = { .type = mt_PATTERN_STRING, .line = line, .column = 3 };
+    mt_string_init_view(&pattern.value.as_string, value, strlen(value));
+    return pattern;
+}
+
+static mt_Pattern boolean(bool value, uint32_t line) {
+    return (mt_Pattern){ .type = mt_PATTERN_BOOLEAN, .value.as_boolean = value, .line = line, .column = 3 };
+}
+
+static mt_Pattern shape(uint32_t value, uint32_t line) {
+    return (mt_Pattern){ .type = mt_PATTERN_RECORD, .value.as_shape = value, .line = line, .column = 3 };
+}
+
+static mt_Pattern wildcard(uint32_t line) {
+    return (mt_Pattern){ .type = mt_PATTERN_WILDCARD, .line = line, .column = 3 };
+}
+
+static char *test_match_uses_jump_tables_for_dense_integers() {
+    mt_Pattern cases[] = { integer(3, 2), integer(1, 3), integer(2, 4), integer(5, 5), integer(4, 6), wildcard(7) };
+    tree = mt_match_init();
+    mu_assert("expected match to compile", mt_match_compile(tree, cases, 6));
+    mu_assert("expected a jump table", tree->switches[mt_PATTERN_INTEGER].type == mt_SWITCH_JUMP_TABLE);
+
+    for (int64_t value = 1; value <= 5; value++) {
+        mt_Pattern pattern = integer(value, 0);
+        uint32_t arm = mt_match_select(tree, &pattern);
+        mu_assert("expected the matching case", cases[arm].value.as_integer == value);
+    }
+
+    mt_Pattern pattern = integer(6, 0);
+    mu_assert("expected the wildcard", mt_match_select(tree, &pattern) == 5);
+    pattern = integer(INT64_MIN, 0);
+    mu_assert("expected the wildcard", mt_match_select(tree, &pattern) == 5);
+    pattern = boolean(true, 0);
+    mu_assert("expected other types to reach the wildcard", mt_match_select(tree, &pattern) == 5);
+    return 0;
+}
+
+static char *test_match_bisects_sparse_integers() {
+    mt_Pattern cases[] = { integer(1000, 2), integer(-7, 3), integer(INT64_MAX, 4), integer(0, 5), wildcard(6) };
+    tree = mt_match_init();
+    mu_assert("expected match to compile", mt_match_compile(tree, cases, 5));
+    mu_assert("expected a search", tree->switches[mt_PATTERN_INTEGER].type == mt_SWITCH_SEARCH);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        mu_assert("expected the matching case", mt_match_select(tree, &cases[i]) == i);
+    }
+
+    mt_Pattern pattern = integer(1, 0);
+    mu_assert("expected the wildcard", mt_match_select(tree, &pattern) == 4);
+    return 0;
+}
+
+static char *test_match_hashes_strings() {
+    mt_Pattern cases[] = {
+        string("GET", 2),
+        string("POST", 3),
+        string("a string that's too long to be inline", 4),
+        string("", 5),
+        wildcard(6),
+    };
+    tree = mt_match_init();
+    mu_assert("expected match to compile", mt_match_compile(tree, cases, 5));
+    mu_assert("expected a hash table", tree->switches[mt_PATTERN_STRING].type == mt_SWITCH_HASH);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        mt_Pattern pattern = string((char *)mt_string_data(&cases[i].value.as_string), 0);
+        mu_assert("expected the matching case", mt_match_select(tree, &pattern) == i);
+    }
+
+    mt_Pattern pattern = string("PUT", 0);
+    mu_assert("expected the wildcard", mt_match_select(tree, &pattern) == 4);
+    return 0;
+}
+
+static char *test_match_dispatches_on_type_first() {
+    mt_Pattern cases[] = { shape(2, 2), integer(2, 3), shape(0, 4), string("2", 5), wildcard(6) };
+    tree = mt_match_init();
+    mu_assert("expected match to compile", mt_match_compile(tree, cases, 5));
+
+    mt_Pattern pattern = shape(2, 0);
+    mu_assert("expected the first shape", mt_match_select(tree, &pattern) == 0);
+    pattern = integer(2, 0);
+    mu_assert("expected the integer", mt_match_select(tree, &pattern) == 1);
+    pattern = shape(0, 0);
+    mu_assert("expected the second shape", mt_match_select(tree, &pattern) == 2);
+    pattern = string("2", 0);
+    mu_assert("expected the string", mt_match_select(tree, &pattern) == 3);
+    pattern = shape(1, 0);
+    mu_assert("expected the wildcard", mt_match_select(tree, &pattern) == 4);
+    return 0;
+}
+
+static char *test_match_checks_exhaustiveness() {
+    mt_Pattern booleans[] = { boolean(false, 2), boolean(true, 3) };
+    tree = mt_match_init();
+    mu_assert("expected both booleans to be exhaustive", mt_match_compile(tree, booleans, 2));
+
+    mt_Pattern partial[] = { boolean(false, 2), integer(1, 3) };
+    mu_assert("expected a missing wildcard to be an error", !mt_match_compile(tree, partial, 2));
+    mu_assert("expected an error message", strstr(tree->error, "not exhaustive"));
+    mu_assert("expected the error's line", tree->error_line == 3);
+
+    mu_assert("expected empty matches to be an error", !mt_match_compile(tree, NULL, 0));
+    return 0;
+}
+
+static char *test_match_checks_redundancy() {
+    mt_Pattern duplicate[] = { integer(1, 2), string("a", 3), integer(1, 4), string("a", 5), wildcard(6) };
+    tree = mt_match_init();
+    mu_assert("expected a duplicate case to be an error", !mt_match_compile(tree, duplicate, 5));
+    mu_assert("expected an error message", strstr(tree->error, "unreachable"));
+    mu_assert("expected the first redundant case", tree->error_line == 4);
+
+    mt_Pattern shadowed[] = { integer(1, 2), wildcard(3), integer(2, 4) };
+    mu_assert("expected cases after a wildcard to be an error", !mt_match_compile(tree, shadowed, 3));
+    mu_assert("expected the case after the wildcard", tree->error_line == 4);
+
+    mt_Pattern covered[] = { boolean(true, 2), boolean(false, 3), wildcard(4) };
+    mu_assert("expected a wildcard after both booleans to be an error", !mt_match_compile(tree, covered, 3));
+    mu_assert("expected the wildcard", tree->error_line == 4);
+    return 0;
+}
+
+static uint32_t select_linearly(mt_Pattern *cases, uint32_t count, mt_Pattern *value) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (cases[i].type == mt_PATTERN_WILDCARD) return i;
+        if (cases[i].type != value->type) continue;
+        if (value->type == mt_PATTERN_STRING) {
+            if (mt_string_equal(&cases[i].value.as_string, &value->value.as_string)) return i;
+        } else if (cases[i].value.as_integer == value->value.as_integer) {
+            return i;
+        }
+    }
+
+    return mt_NO_ARM;
+}
+
+static char *test_match_agrees_with_linear_matching() {
+    static char names[64][4];
+    for (int i = 0; i < 64; i++) snprintf(names[i], sizeof(names[i]), "s%d", i);
+
+    srand(42);
+    for (int round = 0; round < 200; round++) {
+        // Build random matches without duplicates, alternating between
+        // dense and sparse keys.
+        mt_Pattern cases[64];
+        uint32_t count = 0;
+        int64_t spread = round % 2 ? 2 : 1000;
+        for (int i = 0; i < 48; i++) {
+            mt_Pattern pattern;
+            if (rand() % 2) {
+                pattern = integer((rand() % 32) * spread, i);
+            } else {
+                pattern = string(names[rand() % 64], i);
+            }
+
+            if (select_linearly(cases, count, &pattern) == mt_NO_ARM) cases[count++] = pattern;
+        }
+        cases[count++] = wildcard(99);
+
+        tree = mt_match_init();
+        mu_assert("expected match to compile", mt_match_compile(tree, cases, count));
+        for (int i = 0; i < 200; i++) {
+            mt_Pattern value = rand() % 2 ? integer((rand() % 40) * spread, 0) : string(names[rand() % 64], 0);
+            mu_assert("expected decision tree to agree with linear matching", mt_match_select(tree, &value) == select_linearly(cases, count, &value));
+        }
+
+        teardown();
+    }
+
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_match_uses_jump_tables_for_dense_integers);
+    mu_run_test(test_match_bisects_sparse_integers);
+    mu_run_test(test_match_hashes_strings);
+    mu_run_test(test_match_dispatches_on_type_first);
+    mu_run_test(test_match_checks_exhaustiveness);
+    mu_run_test(test_match_checks_redundancy);
+    mu_run_test(test_match_agrees_with_linear_matching);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
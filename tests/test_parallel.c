@@ -0,0 +1,229 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "parallel.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static mt_WorkPool *pool;
+
+static void teardown() {
+    if (pool) mt_work_pool_free(pool);
+    pool = NULL;
+}
+
+static void sum_integers(mt_Worker *worker, int64_t start, int64_t end, void *result, void *data) {
+    (void)worker;
+    (void)data;
+    for (int64_t i = start; i < end; i++) *(int64_t *)result += i;
+}
+
+static void add_integers(void *into, const void *from, void *data) {
+    (void)data;
+    *(int64_t *)into += *(const int64_t *)from;
+}
+
+static void sum_reciprocals(mt_Worker *worker, int64_t start, int64_t end, void *result, void *data) {
+    (void)worker;
+    (void)data;
+    for (int64_t i = start; i < end; i++) *(double *)result += 1.0 / (double)(i + 1);
+}
+
+static void add_doubles(void *into, const void *from, void *data) {
+    (void)data;
+    *(double *)into += *(const double *)from;
+}
+
+static char *test_parallel_for_sums_ranges() {
+    int64_t zero = 0;
+    mt_ParallelLoop loop = {
+        .start = -500,
+        .end = 100000,
+        .result_size = sizeof(int64_t),
+        .identity = &zero,
+        .body = sum_integers,
+        .reduce = add_integers,
+    };
+
+    uint32_t worker_counts[] = { 1, 3, 8 };
+    for (size_t i = 0; i < sizeof(worker_counts) / sizeof(worker_counts[0]); i++) {
+        pool = mt_work_pool_init(worker_counts[i]);
+        mu_assert("expected a pool", pool);
+
+        int64_t sum = -1;
+        mu_assert("expected the loop to run", mt_parallel_for(pool, &loop, &sum));
+        mu_assert("expected the sum of the range", sum == (int64_t)(100000 - 1 + -500) * (100000 + 500) / 2);
+
+        loop.end = loop.start;
+        mu_assert("expected the empty loop to run", mt_parallel_for(pool, &loop, &sum));
+        mu_assert("expected an empty range to produce the identity", sum == 0);
+        loop.end = 100000;
+
+        mt_work_pool_free(pool);
+        pool = NULL;
+    }
+
+    return 0;
+}
+
+static void count_iterations(mt_Worker *worker, int64_t start, int64_t end, void *result, void *data) {
+    (void)worker;
+    (void)data;
+    *(uint64_t *)result += (uint64_t)end - (uint64_t)start;
+}
+
+static void add_counts(void *into, const void *from, void *data) {
+    (void)data;
+    *(uint64_t *)into += *(const uint64_t *)from;
+}
+
+static char *test_parallel_for_spans_the_whole_range() {
+    uint64_t zero = 0;
+    mt_ParallelLoop loop = {
+        .start = INT64_MIN,
+        .end = INT64_MAX,
+        .result_size = sizeof(uint64_t),
+        .identity = &zero,
+        .body = count_iterations,
+        .reduce = add_counts,
+    };
+
+    pool = mt_work_pool_init(4);
+    mu_assert("expected a pool", pool);
+
+    uint64_t count = 0;
+    mu_assert("expected the loop to run", mt_parallel_for(pool, &loop, &count));
+    mu_assert("expected every iteration to run once", count == UINT64_MAX);
+
+    loop.grain = INT64_MAX / 2;
+    count = 0;
+    mu_assert("expected the loop to run", mt_parallel_for(pool, &loop, &count));
+    mu_assert("expected every iteration to run once with a grain", count == UINT64_MAX);
+    return 0;
+}
+
+static char *test_parallel_for_reduces_deterministically() {
+    double zero = 0;
+    mt_ParallelLoop loop = {
+        .start = 0,
+        .end = 1000003,
+        .result_size = sizeof(double),
+        .identity = &zero,
+        .body = sum_reciprocals,
+        .reduce = add_doubles,
+    };
+
+    double expected = 0;
+    for (uint32_t workers = 1; workers <= 7; workers += 3) {
+        pool = mt_work_pool_init(workers);
+        mu_assert("expected a pool", pool);
+
+        // Run twice on every pool so stealing has a chance to vary.
+        for (int round = 0; round < 2; round++) {
+            double sum = 0;
+            mu_assert("expected the loop to run", mt_parallel_for(pool, &loop, &sum));
+            if (workers == 1 && round == 0) expected = sum;
+            mu_assert("expected bit-identical results", memcmp(&sum, &expected, sizeof(double)) == 0);
+        }
+
+        mt_work_pool_free(pool);
+        pool = NULL;
+    }
+
+    return 0;
+}
+
+typedef struct {
+    uint32_t runs[256];
+    uint32_t runners[256];
+} Ledger;
+
+static void record_runs(mt_Worker *worker, int64_t start, int64_t end, void *result, void *data) {
+    (void)result;
+    Ledger *ledger = data;
+
+    // Hold up the first worker so the others run out of work and
+    // have to steal from it.
+    if (start == 0) usleep(50000);
+
+    for (int64_t i = start; i < end; i++) {
+        __atomic_fetch_add(&ledger->runs[i], 1, __ATOMIC_RELAXED);
+        ledger->runners[i] = worker->id;
+    }
+}
+
+static char *test_parallel_for_steals_work() {
+    pool = mt_work_pool_init(4);
+    mu_assert("expected a pool", pool);
+
+    Ledger ledger;
+    memset(&ledger, 0, sizeof(ledger));
+    mt_ParallelLoop loop = { .start = 0, .end = 256, .grain = 1, .body = record_runs, .data = &ledger };
+    mu_assert("expected the loop to run", mt_parallel_for(pool, &loop, NULL));
+
+    bool stolen = false;
+    for (int i = 0; i < 256; i++) {
+        mu_assert("expected every iteration to run exactly once", ledger.runs[i] == 1);
+        if (i < 64 && ledger.runners[i] != 0) stolen = true;
+    }
+
+    mu_assert("expected other workers to steal from the first one", stolen);
+    return 0;
+}
+
+static void use_arena(mt_Worker *worker, int64_t start, int64_t end, void *result, void *data) {
+    (void)start;
+    (void)end;
+    (void)data;
+
+    char *small = mt_worker_alloc(worker, 3);
+    double *aligned = mt_worker_alloc(worker, sizeof(double) * 4);
+    bool ok = small && aligned && (uintptr_t)aligned % _Alignof(max_align_t) == 0;
+    ok = ok && mt_worker_alloc(worker, mt_WORKER_ARENA_SIZE / 2);
+    ok = ok && !mt_worker_alloc(worker, mt_WORKER_ARENA_SIZE / 2);
+    if (!ok) *(int64_t *)result += 1;
+}
+
+static char *test_parallel_for_resets_arenas() {
+    pool = mt_work_pool_init(2);
+    mu_assert("expected a pool", pool);
+
+    int64_t zero = 0, failures = -1;
+    mt_ParallelLoop loop = {
+        .start = 0,
+        .end = 64,
+        .grain = 1,
+        .result_size = sizeof(int64_t),
+        .identity = &zero,
+        .body = use_arena,
+        .reduce = add_integers,
+    };
+
+    mu_assert("expected the loop to run", mt_parallel_for(pool, &loop, &failures));
+    mu_assert("expected every chunk to start with an empty arena", failures == 0);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_parallel_for_sums_ranges);
+    mu_run_test(test_parallel_for_spans_the_whole_range);
+    mu_run_test(test_parallel_for_reduces_deterministically);
+    mu_run_test(test_parallel_for_steals_work);
+    mu_run_test(test_parallel_for_resets_arenas);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "common.h"
 #include "parser.h"
@@ -39,9 +40,143 @@ static char *test_parser_can_parse_basic_expressions() {
     return 0;
 }
 
+static char *test_parser_can_parse_numbers() {
+    parser = mt_parser_init("[stdin]", "42 3.25");
+    tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+
+    mt_NodeList *head = tree->value.as_node_list;
+    mu_assert("expected an INTEGER node", head && head->value->type == mt_NODE_INTEGER);
+    mu_assert("expected the integer's value", head->value->value.as_integer == 42);
+
+    head = head->next;
+    mu_assert("expected a FLOAT node", head && head->value->type == mt_NODE_FLOAT);
+    mu_assert("expected the float's value", head->value->value.as_double == 3.25);
+    return 0;
+}
+
+typedef struct {
+    mt_DeclarationType type;
+    char *name;
+    size_t parent;
+    uint32_t line;
+} DeclarationTest;
+
+static char *test_parser_can_skim_declarations() {
+    DeclarationTest tests[] = {
+        { mt_DECLARATION_PROTOCOL, "Iterable", mt_NO_PARENT, 1 },
+        { mt_DECLARATION_PROTOCOL, "Iterator", mt_NO_PARENT, 5 },
+        { mt_DECLARATION_RECORD, "Range", mt_NO_PARENT, 10 },
+        { mt_DECLARATION_EXTEND, "Range", mt_NO_PARENT, 16 },
+        { mt_DECLARATION_DEF, "iter", 3, 17 },
+        { mt_DECLARATION_RECORD, "RangeIterator", mt_NO_PARENT, 22 },
+        { mt_DECLARATION_EXTEND, "RangeIterator", mt_NO_PARENT, 27 },
+        { mt_DECLARATION_DEF, "has_more", 6, 28 },
+        { mt_DECLARATION_DEF, "get_next", 6, 32 },
+        { mt_DECLARATION_DEF, "range", mt_NO_PARENT, 39 },
+        { mt_DECLARATION_DEF, "range", mt_NO_PARENT, 43 },
+        { mt_DECLARATION_DEF, "range", mt_NO_PARENT, 47 },
+    };
+    size_t ntests = sizeof(tests) / sizeof(tests[0]);
+
+    char *source = mt_read_entire_file("examples/iteration.mt");
+    mu_assert("expected source to contain data", source);
+
+    parser = mt_parser_init("examples/iteration.mt", source);
+    mt_DeclarationList *list = mt_parser_skim(parser);
+    mu_assert("expected declarations", list);
+    mu_assert("expected 12 declarations", list->length == ntests);
+
+    for (size_t i = 0; i < ntests; i++) {
+        mt_Declaration *declaration = &list->declarations[i];
+        mu_assert("expected declaration type to match", declaration->type == tests[i].type);
+        mu_assert("expected declaration parent to match", declaration->parent == tests[i].parent);
+        mu_assert("expected declaration line to match", declaration->line == tests[i].line);
+        mu_assert("expected declaration name to match", declaration->name_length == strlen(tests[i].name));
+        mu_assert("expected declaration name to match", memcmp(declaration->name, tests[i].name, declaration->name_length) == 0);
+        mu_assert("expected declaration to start with its keyword", source[declaration->start] != ' ');
+        mu_assert("expected declaration to end with 'end'", memcmp(source + declaration->end - 3, "end", 3) == 0);
+        mu_assert("expected body to be inside the declaration", declaration->start < declaration->body && declaration->body < declaration->end);
+    }
+
+    mu_assert("expected def body to follow the parameter list", source[list->declarations[4].body - 1] == ')');
+
+    free(source);
+    return 0;
+}
+
+static char *test_parser_reports_skimming_errors() {
+    parser = mt_parser_init("[stdin]", "def f(x)\n  for x in y\n  end\n");
+    mu_assert("expected skimming to fail", !mt_parser_skim(parser));
+    mu_assert("expected an unclosed block error", strcmp(parser->error, "expected 'end' to close 'def' on line 1") == 0);
+    mu_assert("expected the error to point at EOF", parser->error_line == 4);
+    mt_parser_free(parser);
+
+    parser = mt_parser_init("[stdin]", "record A\nend\nend");
+    mu_assert("expected skimming to fail", !mt_parser_skim(parser));
+    mu_assert("expected an unexpected end error", strcmp(parser->error, "unexpected 'end'") == 0);
+    mu_assert("expected the error to point at the extra end", parser->error_line == 3);
+    mt_parser_free(parser);
+
+    parser = mt_parser_init("[stdin]", "record 1\nend");
+    mu_assert("expected skimming to fail", !mt_parser_skim(parser));
+    mu_assert("expected a missing name error", strcmp(parser->error, "expected a type name after 'record' on line 1") == 0);
+    return 0;
+}
+
+static char *test_parser_reports_parsing_errors() {
+    parser = mt_parser_init("[stdin]", "1\n  def f()\nend");
+    mu_assert("expected parsing to fail", !mt_parser_parse(parser));
+    mu_assert("expected an unexpected token error", strcmp(parser->error, "unexpected 'def'") == 0);
+    mu_assert("expected the error to point at the token", parser->error_line == 2 && parser->error_column == 3);
+    mt_parser_free(parser);
+
+    parser = mt_parser_init("[stdin]", "\"abc");
+    mu_assert("expected parsing to fail", !mt_parser_parse(parser));
+    mu_assert("expected the scanner's error", parser->error[0] != '\0' && parser->error_line == 1);
+    return 0;
+}
+
+static char *test_parser_can_skim_imports() {
+    char *source = "import std.cli\nimport util\ndef main()\nend\nx";
+    parser = mt_parser_init("[stdin]", source);
+    mt_DeclarationList *list = mt_parser_skim(parser);
+    mu_assert("expected declarations", list);
+    mu_assert("expected 3 declarations", list->length == 3);
+
+    mt_Declaration *declaration = &list->declarations[0];
+    mu_assert("expected an import", declaration->type == mt_DECLARATION_IMPORT);
+    mu_assert("expected the whole module path", declaration->name_length == 7 && memcmp(declaration->name, "std.cli", 7) == 0);
+    mu_assert("expected the import to end after its path", declaration->end == 14);
+    mu_assert("expected the second import", list->declarations[1].type == mt_DECLARATION_IMPORT && list->declarations[1].line == 2);
+    mu_assert("expected the def after the imports", list->declarations[2].type == mt_DECLARATION_DEF);
+    mt_parser_free(parser);
+
+    parser = mt_parser_init("[stdin]", "import a\nb import c.d");
+    mt_Node *tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+    mu_assert("expected imports not to produce nodes", tree->value.as_node_list && !tree->value.as_node_list->next);
+    mt_parser_free(parser);
+
+    parser = mt_parser_init("[stdin]", "import a. b");
+    mu_assert("expected skimming to fail", !mt_parser_skim(parser));
+    mu_assert("expected a missing name error", strcmp(parser->error, "expected a module name after '.'") == 0);
+    mt_parser_free(parser);
+
+    parser = mt_parser_init("[stdin]", "def f()\n  import a\nend");
+    mu_assert("expected skimming to fail", !mt_parser_skim(parser));
+    mu_assert("expected a nested import error", strcmp(parser->error, "imports must be at the top level") == 0);
+    return 0;
+}
+
 static char *run_suite() {
     //mu_run_test(test_parser_can_parse_empty_files);
     mu_run_test(test_parser_can_parse_basic_expressions);
+    mu_run_test(test_parser_can_parse_numbers);
+    mu_run_test(test_parser_can_skim_declarations);
+    mu_run_test(test_parser_reports_skimming_errors);
+    mu_run_test(test_parser_can_skim_imports);
+    mu_run_test(test_parser_reports_parsing_errors);
     return 0;
 }
 
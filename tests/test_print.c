@@ -0,0 +1,125 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "print.h"
+#include "str.h"
+
+#include "minunit.h"
+
+#define OUTPUT_PATH "tests/build/print.out"
+
+int tests_run = 0;
+static char *output;
+
+static void teardown() {
+    free(output);
+    output = NULL;
+}
+
+/// Point the print writer at a file instead of stdout so the tests
+/// can read back what was printed.
+static mt_Writer *redirect_writer() {
+    mt_Writer *writer = mt_print_writer();
+    if (writer->out == stdout) {
+        writer->out = fopen(OUTPUT_PATH, "w");
+        if (!writer->out) return NULL;
+    }
+
+    return writer;
+}
+
+static char *read_output() {
+    fflush(mt_print_writer()->out);
+    free(output);
+    output = mt_read_entire_file(OUTPUT_PATH);
+    return output;
+}
+
+static char *test_print_buffers_until_flushed() {
+    mt_Writer *writer = redirect_writer();
+    mu_assert("expected a writer", writer);
+    writer->line_buffered = false;
+
+    mt_String string;
+    mt_string_init_view(&string, "hello", 5);
+    mt_print_string(&string);
+    mt_print_integer(-42);
+    mt_print_integer(INT64_MIN);
+    mt_print_float(3);
+    mt_print_float(0.1);
+    mt_print_float(-0.0);
+    mt_print_float(1e300);
+    mt_print_boolean(true);
+    mt_print_boolean(false);
+
+    mu_assert("expected the output to be read", read_output());
+    mu_assert("expected nothing to be written before a flush", strlen(output) == 0);
+
+    mu_assert("expected the flush to succeed", mt_print_flush());
+    mu_assert("expected the output to be read", read_output());
+    mu_assert(
+        "expected every value on its own line",
+        strcmp(output, "hello\n-42\n-9223372036854775808\n3.0\n0.1\n-0.0\n1e+300\nTrue\nFalse\n") == 0
+    );
+    return 0;
+}
+
+static char *test_print_flushes_lines_when_line_buffered() {
+    mt_Writer *writer = redirect_writer();
+    mu_assert("expected a writer", writer);
+    writer->line_buffered = true;
+
+    mt_print_integer(1);
+    mt_writer_write_string(writer, "partial");
+    mu_assert("expected the output to be read", read_output());
+    mu_assert("expected complete lines to be written", strcmp(output + strlen(output) - 2, "1\n") == 0);
+
+    mt_writer_write_char(writer, '\n');
+    writer->line_buffered = false;
+    mu_assert("expected the output to be read", read_output());
+    mu_assert("expected the line to be written once it ends", strcmp(output + strlen(output) - 10, "1\npartial\n") == 0);
+    return 0;
+}
+
+static char *test_print_flushes_at_exit() {
+    mu_assert("expected a writer", redirect_writer());
+
+    fflush(stdout);
+    pid_t pid = fork();
+    mu_assert("expected to fork", pid >= 0);
+    if (pid == 0) {
+        mt_print_integer(12345);
+        exit(0);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    mu_assert("expected the child to exit cleanly", WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    mu_assert("expected the output to be read", read_output());
+    mu_assert("expected the output to be flushed at exit", strcmp(output + strlen(output) - 6, "12345\n") == 0);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_print_buffers_until_flushed);
+    mu_run_test(test_print_flushes_lines_when_line_buffered);
+    mu_run_test(test_print_flushes_at_exit);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
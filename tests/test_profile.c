@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static FILE *out;
+
+static void teardown() {
+    mt_profile_stop();
+    if (out) fclose(out);
+    out = NULL;
+}
+
+static volatile uint64_t sink;
+
+/// Burn CPU time, since profiles are sampled on CPU time rather than
+/// wall time.
+static void spin(uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+        sink = sink * 31 + i;
+    }
+}
+
+static char *read_profile(char *buffer, size_t size) {
+    out = tmpfile();
+    if (!out || !mt_profile_write(out)) return NULL;
+
+    rewind(out);
+    size_t length = fread(buffer, 1, size - 1, out);
+    buffer[length] = '\0';
+    return buffer;
+}
+
+static char *test_profile_samples_folded_stacks() {
+    mu_assert("expected the profiler to start", mt_profile_start(10000));
+    mu_assert("expected only one profile at a time", !mt_profile_start(10000));
+
+    mt_profile_push("outer", 0);
+    mt_profile_push("inner", 12);
+    spin(200000000);
+    mt_profile_pop();
+    mt_profile_pop();
+    mt_profile_stop();
+
+    char buffer[4096];
+    mu_assert("expected a profile", read_profile(buffer, sizeof(buffer)));
+    mu_assert("expected the inner stack to be sampled", strstr(buffer, "outer;inner:12 "));
+    mu_assert("expected no dropped samples", mt_profile_dropped() == 0);
+    return 0;
+}
+
+static char *test_profile_ignores_frames_when_stopped() {
+    mt_profile_push("ignored", 0);
+    mu_assert("expected the profiler to start", mt_profile_start(10000));
+    mt_profile_push("kept", 0);
+    spin(100000000);
+    mt_profile_pop();
+    mt_profile_pop();
+    mt_profile_stop();
+
+    char buffer[4096];
+    mu_assert("expected a profile", read_profile(buffer, sizeof(buffer)));
+    mu_assert("expected frames pushed while stopped to be ignored", !strstr(buffer, "ignored"));
+    mu_assert("expected the frame pushed while running", strstr(buffer, "kept "));
+    return 0;
+}
+
+static char *test_profile_rejects_bad_frequencies() {
+    mu_assert("expected 0 Hz to be rejected", !mt_profile_start(0));
+    mu_assert("expected sub-microsecond periods to be rejected", !mt_profile_start(2000000));
+    return 0;
+}
+
+static char *test_profile_accepts_low_frequencies() {
+    // Periods of a second or more don't fit in the timer's
+    // microseconds.
+    mu_assert("expected 1 Hz to be accepted", mt_profile_start(1));
+    mt_profile_stop();
+    mu_assert("expected 3 Hz to be accepted", mt_profile_start(3));
+    mt_profile_stop();
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_profile_samples_folded_stacks);
+    mu_run_test(test_profile_ignores_frames_when_stopped);
+    mu_run_test(test_profile_rejects_bad_frequencies);
+    mu_run_test(test_profile_accepts_low_frequencies);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parser.h"
+#include "resolver.h"
+#include "str.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static mt_Parser *skimmer;
+static mt_Parser *parser;
+static mt_Resolver *resolver;
+
+static void teardown() {
+    if (skimmer) mt_parser_free(skimmer);
+    if (parser) mt_parser_free(parser);
+    mt_resolver_free(resolver);
+    skimmer = NULL;
+    parser = NULL;
+    resolver = NULL;
+}
+
+static mt_Binding lookup(char *name) {
+    mt_String string;
+    mt_string_init_view(&string, name, strlen(name));
+    return mt_resolver_lookup(resolver, &string);
+}
+
+static char *test_resolver_binds_globals_and_builtins() {
+    skimmer = mt_parser_init("[stdin]", "def range(hi)\nend\ndef range(lo, hi)\nend\ndef go()\nend\n");
+    mt_DeclarationList *declarations = mt_parser_skim(skimmer);
+    mu_assert("expected declarations", declarations);
+
+    parser = mt_parser_init("[stdin]", "print range go");
+    mt_Node *tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+
+    resolver = mt_resolver_init();
+    mu_assert("expected resolution to succeed", mt_resolver_resolve(resolver, tree, declarations));
+    mu_assert("expected overloads to share a slot", resolver->global_count == 2);
+
+    mt_NodeList *head = tree->value.as_node_list;
+    mu_assert("expected print to be a builtin", head->value->binding.type == mt_BINDING_BUILTIN);
+    mu_assert("expected print's builtin id", head->value->binding.index == mt_BUILTIN_PRINT);
+
+    head = head->next;
+    mu_assert("expected range to be a global", head->value->binding.type == mt_BINDING_GLOBAL);
+    mu_assert("expected range to be in slot 0", head->value->binding.index == 0);
+
+    head = head->next;
+    mu_assert("expected go to be a global", head->value->binding.type == mt_BINDING_GLOBAL);
+    mu_assert("expected go to be in slot 1", head->value->binding.index == 1);
+    return 0;
+}
+
+static char *test_resolver_binds_imports() {
+    char *source = "import std.cli\nimport util\nstd util";
+    skimmer = mt_parser_init("[stdin]", source);
+    mt_DeclarationList *declarations = mt_parser_skim(skimmer);
+    mu_assert("expected declarations", declarations);
+
+    parser = mt_parser_init("[stdin]", source);
+    mt_Node *tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+
+    resolver = mt_resolver_init();
+    mu_assert("expected resolution to succeed", mt_resolver_resolve(resolver, tree, declarations));
+    mu_assert("expected a global per import", resolver->global_count == 2);
+
+    mt_NodeList *head = tree->value.as_node_list;
+    mu_assert("expected std to be a global", head->value->binding.type == mt_BINDING_GLOBAL && head->value->binding.index == 0);
+    mu_assert("expected util to be a global", head->next->value->binding.type == mt_BINDING_GLOBAL && head->next->value->binding.index == 1);
+    return 0;
+}
+
+static char *test_resolver_builtins_are_interned_at_build_time() {
+    resolver = mt_resolver_init();
+    mu_assert("expected a resolver", resolver);
+
+    const char *names[] = {
+#define X(id, name) name,
+        mt_BUILTINS(X)
+#undef X
+    };
+
+    for (uint32_t id = 0; id < mt_BUILTIN_COUNT; id++) {
+        mt_String string;
+        mt_string_init_view(&string, names[id], strlen(names[id]));
+        mu_assert("expected builtins to match strings interned at runtime", mt_string_equal(&resolver->builtins[id], &string));
+
+        mt_Binding binding = lookup((char *)names[id]);
+        mu_assert("expected every builtin to be found", binding.type == mt_BINDING_BUILTIN && binding.index == id);
+    }
+
+    mu_assert("expected names that aren't builtins to be unresolved", lookup("prin").type == mt_BINDING_UNRESOLVED);
+    return 0;
+}
+
+static char *test_resolver_reports_undefined_names() {
+    parser = mt_parser_init("[stdin]", "print\n  missing");
+    mt_Node *tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+
+    resolver = mt_resolver_init();
+    mu_assert("expected resolution to fail", !mt_resolver_resolve(resolver, tree, NULL));
+    mu_assert("expected an error message", strcmp(resolver->error, "undefined name 'missing'") == 0);
+    mu_assert("expected the error's line", resolver->error_line == 2);
+    mu_assert("expected the error's column", resolver->error_column == 3);
+    return 0;
+}
+
+static char *test_resolver_allocates_registers_per_scope() {
+    uint32_t reg;
+    resolver = mt_resolver_init();
+    mu_assert("expected locals to need a scope", !mt_resolver_declare_local(resolver, "x", 1, &reg));
+
+    mu_assert("expected scope", mt_resolver_push_scope(resolver));
+    mu_assert("expected x", mt_resolver_declare_local(resolver, "x", 1, &reg) && reg == 0);
+    mu_assert("expected y", mt_resolver_declare_local(resolver, "y", 1, &reg) && reg == 1);
+
+    mu_assert("expected inner scope", mt_resolver_push_scope(resolver));
+    mu_assert("expected shadowing x", mt_resolver_declare_local(resolver, "x", 1, &reg) && reg == 2);
+
+    mt_Binding binding = lookup("x");
+    mu_assert("expected the innermost x", binding.type == mt_BINDING_LOCAL && binding.index == 2);
+    binding = lookup("y");
+    mu_assert("expected the outer y", binding.type == mt_BINDING_LOCAL && binding.index == 1);
+
+    mt_resolver_pop_scope(resolver);
+    binding = lookup("x");
+    mu_assert("expected the outer x", binding.type == mt_BINDING_LOCAL && binding.index == 0);
+    mu_assert("expected registers to be reused", mt_resolver_declare_local(resolver, "z", 1, &reg) && reg == 2);
+
+    mt_resolver_pop_scope(resolver);
+    mu_assert("expected x to be gone", lookup("x").type == mt_BINDING_UNRESOLVED);
+    return 0;
+}
+
+static char *test_resolver_grows_the_global_table() {
+    static char names[1000][8];
+    uint32_t slot;
+
+    resolver = mt_resolver_init();
+    for (int i = 0; i < 1000; i++) {
+        snprintf(names[i], sizeof(names[i]), "g%d", i);
+        mu_assert("expected global", mt_resolver_declare_global(resolver, names[i], strlen(names[i]), &slot));
+        mu_assert("expected slots in declaration order", slot == (uint32_t)i);
+    }
+
+    for (int i = 0; i < 1000; i++) {
+        mt_Binding binding = lookup(names[i]);
+        mu_assert("expected every global to be found", binding.type == mt_BINDING_GLOBAL && binding.index == (uint32_t)i);
+    }
+
+    mu_assert("expected redeclaration to reuse the slot", mt_resolver_declare_global(resolver, "g500", 4, &slot) && slot == 500);
+    mu_assert("expected no new global", resolver->global_count == 1000);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_resolver_binds_globals_and_builtins);
+    mu_run_test(test_resolver_binds_imports);
+    mu_run_test(test_resolver_builtins_are_interned_at_build_time);
+    mu_run_test(test_resolver_reports_undefined_names);
+    mu_run_test(test_resolver_allocates_registers_per_scope);
+    mu_run_test(test_resolver_grows_the_global_table);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
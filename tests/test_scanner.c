@@ -26,6 +26,8 @@ typedef struct {
 static void teardown() {
     if (token) mt_token_free(token);
     if (scanner) mt_scanner_free(scanner);
+    token = NULL;
+    scanner = NULL;
 }
 
 static char *test_scanner_can_scan_empty_buffers() {
@@ -121,9 +123,29 @@ static char *test_scanner_can_scan_keywords() {
         { mt_TOKEN_WHILE, "while", 1, 40 },
         { mt_TOKEN_MATCH, "match", 1, 46 },
         { mt_TOKEN_END, "end", 1, 52 },
+        { mt_TOKEN_IMPORT, "import", 1, 56 },
     };
 
-    return run_table_tests(tests, sizeof(tests) / sizeof(tests[0]), "protocol record extend def if else for while match end");
+    return run_table_tests(tests, sizeof(tests) / sizeof(tests[0]), "protocol record extend def if else for while match end import");
+}
+
+static char *test_scanner_can_scan_unicode_identifiers() {
+    TableTest tests[] = {
+        { mt_TOKEN_NAME, "caf\xc3\xa9", 1, 1 },
+        { mt_TOKEN_CAP_NAME, "\xc3\x84rger", 1, 7 },
+        { mt_TOKEN_NAME, "\xe5\x90\x8d\xe5\x89\x8d", 1, 14 },
+        { mt_TOKEN_NAME, "ife\xcc\x81", 1, 21 },
+        { mt_TOKEN_NAME, "x\xd9\xa1", 1, 27 },
+        { mt_TOKEN_ERROR, "unexpected token '\xc2\xa7'", 1, 31 },
+        { mt_TOKEN_ERROR, "invalid UTF-8 byte 0xff", 1, 34 },
+        { mt_TOKEN_STRING, "\"\xf0\x9f\x98\x80\"", 1, 36 },
+    };
+
+    return run_table_tests(
+        tests,
+        sizeof(tests) / sizeof(tests[0]),
+        "caf\xc3\xa9 \xc3\x84rger \xe5\x90\x8d\xe5\x89\x8d ife\xcc\x81 x\xd9\xa1 \xc2\xa7 \xff \"\xf0\x9f\x98\x80\""
+    );
 }
 
 static char *test_scanner_can_scan_strings() {
@@ -137,13 +159,62 @@ static char *test_scanner_can_scan_strings() {
     return run_table_tests(tests, sizeof(tests) / sizeof(tests[0]), "\"hello\" \"\" \"hello\\\"there\" \"never closed");
 }
 
+static char *test_scanner_decodes_string_escapes() {
+    struct {
+        char *source;
+        char *expected;
+        size_t length;
+    } tests[] = {
+        { "\"plain\"", "plain", 5 },
+        { "\"a\\nb\\tc\\rd\"", "a\nb\tc\rd", 7 },
+        { "\"\\\"quoted\\\" \\\\\"", "\"quoted\" \\", 10 },
+        { "\"nul\\0byte\"", "nul\0byte", 8 },
+        { "\"\\x41\\x7a\"", "Az", 2 },
+        { "\"caf\\u{e9} \\u{1F600}\"", "caf\xc3\xa9 \xf0\x9f\x98\x80", 10 },
+        { "\"line\\\ncontinued\"", "linecontinued", 13 },
+        { "\"a long string with an escape at the very end of it\\n\"", "a long string with an escape at the very end of it\n", 51 },
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        scanner = mt_scanner_init(tests[i].source);
+        token = mt_token_init();
+        mt_scanner_scan(scanner, token);
+
+        sprintf(buf, "expected test %ld to decode to a string", i);
+        mu_assert(buf, token->type == mt_TOKEN_STRING);
+        mu_assert(buf, token->value.as_string.length == tests[i].length);
+        mu_assert(buf, memcmp(token->value.as_string.data, tests[i].expected, tests[i].length) == 0);
+        if (i == 0) {
+            mu_assert("expected strings without escapes not to be copied", token->value.as_string.data == token->start + 1);
+        }
+
+        teardown();
+    }
+
+    TableTest errors[] = {
+        { mt_TOKEN_ERROR, "unknown escape sequence '\\q'", 1, 1 },
+        { mt_TOKEN_NAME, "a", 1, 6 },
+        { mt_TOKEN_ERROR, "expected two hex digits after '\\x'", 1, 8 },
+        { mt_TOKEN_ERROR, "expected 1 to 6 hex digits between braces after '\\u'", 1, 15 },
+        { mt_TOKEN_ERROR, "'\\u{D800}' is not a valid code point", 1, 21 },
+        { mt_TOKEN_STRING, "\"\\\\\"", 1, 32 },
+        { mt_TOKEN_NAME, "b", 1, 37 },
+    };
+
+    return run_table_tests(
+        errors,
+        sizeof(errors) / sizeof(errors[0]),
+        "\"\\q\" a \"\\xg1\" \"\\u1\" \"\\u{D800}\" \"\\\\\" b"
+    );
+}
+
 static char *test_scanner_can_scan_multiline_strings() {
     TableTest tests[] = {
         { mt_TOKEN_NAME, "print", 1, 1 },
         { mt_TOKEN_LPAREN, "(", 1, 6 },
         { mt_TOKEN_STRING, "\"testing\n  multiline\n  strings here,\n  get outta the way!!\"", 2, 3 },
         { mt_TOKEN_COMMA, ",", 5, 23 },
-        { mt_TOKEN_NUMBER, "1", 5, 25 },
+        { mt_TOKEN_INTEGER, "1", 5, 25 },
     };
 
     char *source = mt_read_entire_file("tests/fixtures/test_scanner_multiline_strings.mt");
@@ -156,14 +227,82 @@ static char *test_scanner_can_scan_multiline_strings() {
 
 static char *test_scanner_can_scan_numbers() {
     TableTest tests[] = {
-        { mt_TOKEN_NUMBER, "0", 1, 1 },
-        { mt_TOKEN_NUMBER, "1234", 1, 3 },
-        { mt_TOKEN_NUMBER, "12.05", 1, 8 },
+        { mt_TOKEN_INTEGER, "0", 1, 1 },
+        { mt_TOKEN_INTEGER, "1234", 1, 3 },
+        { mt_TOKEN_FLOAT, "12.05", 1, 8 },
         { mt_TOKEN_ERROR, "multiple points in number", 1, 14 },
         { mt_TOKEN_ERROR, "numbers cannot start with 0", 1, 19 },
+        { mt_TOKEN_FLOAT, "0.5", 1, 24 },
+        { mt_TOKEN_FLOAT, "3.", 1, 28 },
+        { mt_TOKEN_ERROR, "integer literal is too large", 1, 31 },
+    };
+
+    return run_table_tests(tests, sizeof(tests) / sizeof(tests[0]), "0 1234 12.05 1..3 0123 0.5 3. 9223372036854775808");
+}
+
+static char *test_scanner_computes_number_values() {
+    struct {
+        char *source;
+        int64_t value;
+    } integers[] = {
+        { "0", 0 },
+        { "7", 7 },
+        { "12345678", 12345678 },
+        { "123456789", 123456789 },
+        { "9876543210123456", 9876543210123456 },
+        { "9223372036854775807", INT64_MAX },
+    };
+
+    for (size_t i = 0; i < sizeof(integers) / sizeof(integers[0]); i++) {
+        scanner = mt_scanner_init(integers[i].source);
+        token = mt_token_init();
+        mt_scanner_scan(scanner, token);
+
+        sprintf(buf, "expected %s to scan to an integer", integers[i].source);
+        mu_assert(buf, token->type == mt_TOKEN_INTEGER);
+        mu_assert(buf, token->value.as_integer == integers[i].value);
+        teardown();
+    }
+
+    char *floats[] = {
+        "0.1", "1.5", "12.05", "3.14159265358979", "0.000001", "123456789.123456789",
+        "9007199254740993.0", "1.00000000000000000000000000001", "0.30000000000000004",
+        "179769313486231570000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000.0",
     };
 
-    return run_table_tests(tests, sizeof(tests) / sizeof(tests[0]), "0 1234 12.05 1..3 0123");
+    for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++) {
+        scanner = mt_scanner_init(floats[i]);
+        token = mt_token_init();
+        mt_scanner_scan(scanner, token);
+
+        sprintf(buf, "expected %.32s to scan to %.17g", floats[i], strtod(floats[i], NULL));
+        mu_assert(buf, token->type == mt_TOKEN_FLOAT);
+        mu_assert(buf, token->value.as_double == strtod(floats[i], NULL));
+        teardown();
+    }
+
+    char source[32];
+    srand(7);
+    for (int i = 0; i < 10000; i++) {
+        int integer_digits = 1 + rand() % 10;
+        int fraction_digits = 1 + rand() % 12;
+        char *current = source;
+        *current++ = (char)('1' + rand() % 9);
+        for (int j = 1; j < integer_digits; j++) *current++ = (char)('0' + rand() % 10);
+        *current++ = '.';
+        for (int j = 0; j < fraction_digits; j++) *current++ = (char)('0' + rand() % 10);
+        *current = '\0';
+
+        scanner = mt_scanner_init(source);
+        token = mt_token_init();
+        mt_scanner_scan(scanner, token);
+
+        sprintf(buf, "expected %s to scan to %.17g", source, strtod(source, NULL));
+        mu_assert(buf, token->value.as_double == strtod(source, NULL));
+        teardown();
+    }
+
+    return 0;
 }
 
 static char *test_scanner_can_scan_comments() {
@@ -177,16 +316,201 @@ static char *test_scanner_can_scan_comments() {
     return run_table_tests(tests, sizeof(tests) / sizeof(tests[0]), ": # some comment\n:= # another comment");
 }
 
+static bool same_value(mt_Token *a, mt_Token *b) {
+    if (a->type != mt_TOKEN_STRING) return a->value.as_integer == b->value.as_integer;
+
+    return a->value.as_string.decoded == b->value.as_string.decoded &&
+        a->value.as_string.length == b->value.as_string.length &&
+        memcmp(a->value.as_string.data, b->value.as_string.data, a->value.as_string.length) == 0;
+}
+
+static char *compare_token_streams(mt_TokenStream *expected, mt_TokenStream *actual) {
+    sprintf(buf, "expected %ld tokens got %ld", expected->length, actual->length);
+    mu_assert(buf, expected->length == actual->length);
+
+    for (size_t i = 0; i < expected->length; i++) {
+        mt_Token *e = &expected->tokens[i];
+        mt_Token *a = &actual->tokens[i];
+
+        sprintf(buf, "token %ld differs", i);
+        mu_assert(buf, e->type == a->type);
+        mu_assert(buf, e->length == a->length);
+        mu_assert(buf, e->line == a->line);
+        mu_assert(buf, e->column == a->column);
+        mu_assert(buf, same_value(e, a));
+        mu_assert(buf, memcmp(e->start, a->start, e->length) == 0);
+    }
+
+    return 0;
+}
+
+static char *run_differential_tests(char *source) {
+    mt_TokenStream *expected = mt_scanner_scan_all(source);
+    mu_assert("expected a sequential token stream", expected);
+
+    for (size_t nthreads = 1; nthreads <= 32; nthreads++) {
+        mt_TokenStream *actual = mt_scanner_scan_parallel(source, nthreads);
+        mu_assert("expected a parallel token stream", actual);
+
+        char *res = compare_token_streams(expected, actual);
+        mt_token_stream_free(actual);
+        if (res) {
+            sprintf(buf + strlen(buf), " (%ld threads)", nthreads);
+            mt_token_stream_free(expected);
+            return res;
+        }
+    }
+
+    mt_token_stream_free(expected);
+    return 0;
+}
+
+static char *test_scanner_parallel_scan_matches_sequential_scan() {
+    char *snippets[] = {
+        "record Person\n  String first_name,\n  Integer age,\nend\n",
+        "print(\"testing\n  multiline\n\n  strings \\\" here\",\n 1)\n",
+        "# a comment with a \" quote\n",
+        "x := 42 != 3 # trailing\n\n\n",
+        "a ! \n b\n",
+        "$ 1..3 0123 12.05\n",
+        "\"\n\"\n",
+        "   \t\n",
+    };
+    size_t nsnippets = sizeof(snippets) / sizeof(snippets[0]);
+
+    char *source = malloc(65536);
+    mu_assert("expected source to be allocated", source);
+
+    size_t length = 0;
+    for (size_t i = 0; length < 60000; i++) {
+        char *snippet = snippets[(i * 7 + i / 3) % nsnippets];
+        memcpy(source + length, snippet, strlen(snippet));
+        length += strlen(snippet);
+    }
+    source[length] = '\0';
+
+    char *res = run_differential_tests(source);
+    if (!res) {
+        strcpy(source + length, "\"never\nclosed\n\n");
+        res = run_differential_tests(source);
+    }
+
+    free(source);
+    return res;
+}
+
+static char *test_scanner_incremental_scan_matches_full_scan() {
+    char *texts[] = { "", "x", " ", "\n", "\"", "#", "!", "==", "abc def", "\"a\nb\"", "12.5", "\n\n  end\n" };
+    size_t ntexts = sizeof(texts) / sizeof(texts[0]);
+
+    char *source = mt_read_entire_file("examples/iteration.mt");
+    mu_assert("expected source to contain data", source);
+
+    mt_TokenStream *stream = mt_scanner_scan_all(source);
+    mu_assert("expected a token stream", stream);
+
+    srand(42);
+    for (size_t i = 0; i < 2000; i++) {
+        size_t length = strlen(source);
+        mt_Edit edit;
+        edit.offset = (size_t)rand() % (length + 1);
+        edit.length = (size_t)rand() % 4;
+        edit.length = MIN(edit.length, length - edit.offset);
+        edit.text = texts[(size_t)rand() % ntexts];
+        edit.text_length = strlen(edit.text);
+
+        char *new_source = mt_edit_apply(source, &edit);
+        mu_assert("expected edit to apply", new_source);
+
+        mt_TokenSplice splice;
+        mu_assert("expected stream to update", mt_token_stream_edit(stream, source, new_source, &edit, &splice));
+        free(source);
+        source = new_source;
+
+        mt_TokenStream *expected = mt_scanner_scan_all(source);
+        mu_assert("expected a token stream", expected);
+
+        char *res = compare_token_streams(expected, stream);
+        mt_token_stream_free(expected);
+        if (res) {
+            sprintf(buf + strlen(buf), " (edit %ld)", i);
+            return res;
+        }
+    }
+
+    mt_token_stream_free(stream);
+    free(source);
+    return 0;
+}
+
+static char *test_scanner_matches_reference_scanner() {
+    char *pieces[] = {
+        "and", "an", "def", "de", "define", "else", "end", "ending", "extend", "ext", "false", "for",
+        "format", "if", "i", "in", "inner", "match", "not", "or", "protocol", "proto", "record",
+        "return", "re", "true", "while", "with", "w", "_", "x1", "Integer", "A_b", "0", "0123",
+        "12", "1.5", "1..2", ".", ",", "(", ")", "[", "]", "+", "-", "*", "/", "%", "=", "==",
+        "!=", "!", "<", "<=", ">", ">=", ":", ":=", "\"str\"", "\"a\\\"b\"", "# comment\n",
+        " ", " ", "\n", "\t", "$", "\xc3\xa9", "@", "\xc3\x84", "\xe5\x90\x8d", "\xc2\xa7",
+        "\xcc\x81", "\xff", "\xe2\x82", "\xd9\xa1", "\"a\\nb\"", "\"\\u{e9}\\x41\"", "\"\\q\"", "\\",
+        "\"\\\\\"", "\"\\\n\"",
+    };
+    size_t npieces = sizeof(pieces) / sizeof(pieces[0]);
+
+    char *source = malloc(65536);
+    mu_assert("expected source to be allocated", source);
+
+    srand(1);
+    size_t length = 0;
+    while (length < 60000) {
+        char *piece = pieces[(size_t)rand() % npieces];
+        memcpy(source + length, piece, strlen(piece));
+        length += strlen(piece);
+    }
+    strcpy(source + length, " \"unterminated");
+
+    mt_Scanner *expected_scanner = mt_scanner_init(source);
+    mt_Scanner *actual_scanner = mt_scanner_init(source);
+    mt_Token expected, actual;
+    size_t i = 0;
+    char *res = NULL;
+    do {
+        mt_scanner_scan_reference(expected_scanner, &expected);
+        mt_scanner_scan(actual_scanner, &actual);
+
+        sprintf(buf, "token %ld differs", i++);
+        if (expected.type != actual.type ||
+            expected.length != actual.length ||
+            expected.line != actual.line ||
+            expected.column != actual.column ||
+            !same_value(&expected, &actual) ||
+            memcmp(expected.start, actual.start, expected.length) != 0) {
+            res = buf;
+            break;
+        }
+    } while (expected.type != mt_TOKEN_EOF);
+
+    mt_scanner_free(expected_scanner);
+    mt_scanner_free(actual_scanner);
+    free(source);
+    return res;
+}
+
 static char *run_suite() {
     mu_run_test(test_scanner_can_scan_empty_buffers);
     mu_run_test(test_scanner_can_scan_single_character_tokens);
     mu_run_test(test_scanner_can_scan_multi_character_tokens);
     mu_run_test(test_scanner_can_scan_identifiers);
     mu_run_test(test_scanner_can_scan_keywords);
+    mu_run_test(test_scanner_can_scan_unicode_identifiers);
     mu_run_test(test_scanner_can_scan_strings);
+    mu_run_test(test_scanner_decodes_string_escapes);
     mu_run_test(test_scanner_can_scan_multiline_strings);
     mu_run_test(test_scanner_can_scan_numbers);
+    mu_run_test(test_scanner_computes_number_values);
     mu_run_test(test_scanner_can_scan_comments);
+    mu_run_test(test_scanner_matches_reference_scanner);
+    mu_run_test(test_scanner_parallel_scan_matches_sequential_scan);
+    mu_run_test(test_scanner_incremental_scan_matches_full_scan);
     return 0;
 }
 
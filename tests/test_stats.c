@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parser.h"
+#include "scanner.h"
+#include "stats.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static FILE *out;
+
+static void teardown() {
+    memset(mt_stats, 0, sizeof(mt_stats));
+    if (out) fclose(out);
+    out = NULL;
+}
+
+static char *test_stats_report_sorts_counters() {
+    // Counters are written directly since counting is compiled out
+    // unless building with STATS=1.
+    mt_stats[mt_STATS_TOKENS][mt_TOKEN_NAME] = 3;
+    mt_stats[mt_STATS_TOKENS][mt_TOKEN_STRING] = 7;
+    mt_stats[mt_STATS_NODES][mt_NODE_INTEGER] = 1;
+    mt_stats[mt_STATS_SCANNER][mt_STATS_DFA_TRANSITIONS] = 42;
+
+    out = tmpfile();
+    mu_assert("expected a temporary file", out);
+    mt_stats_report(out);
+
+    char buffer[4096];
+    rewind(out);
+    size_t length = fread(buffer, 1, sizeof(buffer) - 1, out);
+    buffer[length] = '\0';
+
+    char *tokens = strstr(buffer, "tokens: 10\n");
+    char *string = strstr(buffer, "TOKEN_STRING");
+    char *name = strstr(buffer, "TOKEN_NAME");
+    mu_assert("expected a tokens group with its total", tokens);
+    mu_assert("expected counters to be sorted", string && name && tokens < string && string < name);
+    mu_assert("expected percentages", strstr(buffer, "70.00%"));
+    mu_assert("expected a nodes group", strstr(buffer, "nodes: 1\n") && strstr(buffer, "INTEGER"));
+    mu_assert("expected a scanner group without a total", strstr(buffer, "scanner:\n"));
+    mu_assert("expected empty groups to be skipped", !strstr(buffer, "lookups"));
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_stats_report_sorts_counters);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
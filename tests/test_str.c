@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "str.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static mt_String a;
+static mt_String b;
+
+static void teardown() {
+    mt_string_free(&a);
+    mt_string_free(&b);
+}
+
+static char *test_string_stores_small_strings_inline() {
+    char source[] = "hello";
+    mu_assert("expected string to be initialized", mt_string_init(&a, source, 5));
+    source[0] = 'j';
+
+    mu_assert("expected string not to own any memory", !a.owned);
+    mu_assert("expected string to be copied", strcmp(mt_string_data(&a), "hello") == 0);
+    mu_assert("expected string length to be 5", a.length == 5);
+    return 0;
+}
+
+static char *test_string_copies_or_borrows_large_strings() {
+    char *source = "a string that's too large to be stored inline";
+    size_t length = strlen(source);
+
+    mu_assert("expected string to be initialized", mt_string_init(&a, source, length));
+    mu_assert("expected string to own a copy", a.owned && mt_string_data(&a) != source);
+
+    mt_string_init_view(&b, source, length);
+    mu_assert("expected view not to own its data", !b.owned && mt_string_data(&b) == source);
+    mu_assert("expected copy and view to be equal", mt_string_equal(&a, &b));
+    mu_assert("expected copy and view to have the same hash", a.hash == b.hash);
+    return 0;
+}
+
+static char *test_string_equality() {
+    mt_string_init_view(&a, "abc", 3);
+    mt_string_init_view(&b, "abc\0", 4);
+    mu_assert("expected strings of different lengths to differ", !mt_string_equal(&a, &b));
+
+    mt_string_init_view(&b, "abd", 3);
+    mu_assert("expected strings with different contents to differ", !mt_string_equal(&a, &b));
+
+    mt_string_init_view(&b, "abc", 3);
+    mu_assert("expected strings with the same contents to be equal", mt_string_equal(&a, &b));
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_string_stores_small_strings_inline);
+    mu_run_test(test_string_copies_or_borrows_large_strings);
+    mu_run_test(test_string_equality);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
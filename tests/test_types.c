@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "parser.h"
+#include "str.h"
+#include "types.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static char *source;
+static mt_Parser *parser;
+static mt_TypeTable *table;
+
+static void teardown() {
+    if (parser) mt_parser_free(parser);
+    mt_types_free(table);
+    free(source);
+    source = NULL;
+    parser = NULL;
+    table = NULL;
+}
+
+static mt_Shape *shape(char *name) {
+    mt_String string;
+    mt_string_init_view(&string, name, strlen(name));
+    return mt_types_shape(table, &string);
+}
+
+static mt_Field *field(mt_Shape *shape, char *name) {
+    mt_String string;
+    mt_string_init_view(&string, name, strlen(name));
+    return mt_types_field(shape, &string);
+}
+
+static char *load(char *filename, char *contents) {
+    source = contents ? strdup(contents) : mt_read_entire_file(filename);
+    mu_assert("expected source to contain data", source);
+
+    parser = mt_parser_init(filename, source);
+    mt_DeclarationList *declarations = mt_parser_skim(parser);
+    mu_assert("expected declarations", declarations);
+
+    table = mt_types_init();
+    mu_assert("expected a type table", table);
+    return 0;
+}
+
+static char *test_types_read_record_fields() {
+    char *message = load("examples/iteration.mt", NULL);
+    if (message) return message;
+    mu_assert("expected shapes to load", mt_types_load(table, source, parser->declarations));
+    mu_assert("expected 4 shapes", table->shape_count == 4);
+
+    mt_Shape *range = shape("Range");
+    mu_assert("expected a Range record", range && range->type == mt_DECLARATION_RECORD);
+    mu_assert("expected Range to have 3 fields", range->field_count == 3);
+
+    mt_Field *end = field(range, "end");
+    mu_assert("expected an 'end' field", end && end->index == 1);
+    mu_assert("expected 'end' to be an Integer", end->type == mt_TYPE_INTEGER);
+
+    mt_Shape *iterator = shape("RangeIterator");
+    mu_assert("expected a RangeIterator record", iterator && iterator->field_count == 2);
+
+    mt_Field *inner = field(iterator, "range");
+    mu_assert("expected 'range' to be a record", inner && inner->type == mt_TYPE_RECORD);
+    mu_assert("expected 'range' to be a Range", &table->shapes[inner->record] == range);
+    mu_assert("expected 'current' to be an Integer", field(iterator, "current")->type == mt_TYPE_INTEGER);
+    mu_assert("expected no 'step' field", !field(iterator, "step"));
+    return 0;
+}
+
+static char *test_types_read_protocol_signatures() {
+    char *message = load("examples/iteration.mt", NULL);
+    if (message) return message;
+    mu_assert("expected shapes to load", mt_types_load(table, source, parser->declarations));
+
+    mt_Shape *iterator = shape("Iterator");
+    mu_assert("expected an Iterator protocol", iterator && iterator->type == mt_DECLARATION_PROTOCOL);
+    mu_assert("expected 'has_more' to return a Boolean", field(iterator, "has_more")->type == mt_TYPE_BOOLEAN);
+    mu_assert("expected 'get_next' to return a type parameter", field(iterator, "get_next")->type == mt_TYPE_UNKNOWN);
+
+    mt_Field *iter = field(shape("Iterable"), "iter");
+    mu_assert("expected protocols not to be record types", iter && iter->type == mt_TYPE_UNKNOWN);
+    return 0;
+}
+
+static char *test_types_report_malformed_records() {
+    char *message = load("[stdin]", "record Point\n  Float x,\n  y,\nend\n");
+    if (message) return message;
+    mu_assert("expected shapes to fail to load", !mt_types_load(table, source, parser->declarations));
+    mu_assert("expected an error message", strcmp(table->error, "expected a field type in record 'Point'") == 0);
+    mu_assert("expected the error's line", table->error_line == 3);
+    mu_assert("expected the error's column", table->error_column == 3);
+    return 0;
+}
+
+static char *test_types_specialize_operators() {
+    // self.current + self.step < self.range.end
+    mt_Specialization add = mt_types_specialize(mt_TOKEN_PLUS, mt_TYPE_INTEGER, mt_TYPE_INTEGER);
+    mu_assert("expected an integer add", add.operands == mt_TYPE_INTEGER && add.result == mt_TYPE_INTEGER);
+
+    mt_Specialization less = mt_types_specialize(mt_TOKEN_LESS, add.result, mt_TYPE_INTEGER);
+    mu_assert("expected an integer compare", less.operands == mt_TYPE_INTEGER && less.result == mt_TYPE_BOOLEAN);
+
+    mt_Specialization mixed = mt_types_specialize(mt_TOKEN_PLUS, mt_TYPE_INTEGER, mt_TYPE_FLOAT);
+    mu_assert("expected mixed operands to stay generic", mixed.operands == mt_TYPE_UNKNOWN);
+
+    mt_Specialization concat = mt_types_specialize(mt_TOKEN_PLUS, mt_TYPE_STRING, mt_TYPE_STRING);
+    mu_assert("expected a string concat", concat.operands == mt_TYPE_STRING && concat.result == mt_TYPE_STRING);
+
+    mt_Specialization modulo = mt_types_specialize(mt_TOKEN_PERCENT, mt_TYPE_FLOAT, mt_TYPE_FLOAT);
+    mu_assert("expected float modulo to stay generic", modulo.operands == mt_TYPE_UNKNOWN);
+    return 0;
+}
+
+static char *test_types_of_literals() {
+    parser = mt_parser_init("[stdin]", "1 2.5 \"s\" x");
+    mt_Node *tree = mt_parser_parse(parser);
+    mu_assert("expected a tree", tree);
+
+    mt_TypeTag expected[] = { mt_TYPE_INTEGER, mt_TYPE_FLOAT, mt_TYPE_STRING, mt_TYPE_UNKNOWN };
+    size_t i = 0;
+    for (mt_NodeList *head = tree->value.as_node_list; head; head = head->next, i++) {
+        mu_assert("expected literal type to match", mt_types_of_node(head->value) == expected[i]);
+    }
+
+    mu_assert("expected 4 nodes", i == 4);
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_types_read_record_fields);
+    mu_run_test(test_types_read_protocol_signatures);
+    mu_run_test(test_types_report_malformed_records);
+    mu_run_test(test_types_specialize_operators);
+    mu_run_test(test_types_of_literals);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
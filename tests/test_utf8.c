@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utf8.h"
+
+#include "minunit.h"
+
+int tests_run = 0;
+static char buf[255] = "";
+
+static void teardown() {
+}
+
+typedef struct {
+    char *source;
+    bool valid;
+    size_t error_offset;
+} ValidationTest;
+
+static char *test_utf8_can_validate_buffers() {
+    ValidationTest tests[] = {
+        { "", true, 0 },
+        { "hello, world", true, 0 },
+        { "caf\xc3\xa9 \xe5\x90\x8d\xe5\x89\x8d \xf0\x9f\x98\x80", true, 0 },
+        { "abc\x80", false, 3 },
+        { "\xc0\xaf", false, 0 },  // overlong '/'
+        { "\xe0\x80\xaf", false, 0 },  // overlong '/'
+        { "ok \xed\xa0\x80", false, 3 },  // surrogate
+        { "\xf4\x90\x80\x80", false, 0 },  // past U+10FFFF
+        { "\xf5\x80\x80\x80", false, 0 },
+        { "trailing \xe2\x82", false, 9 },  // truncated
+        { "0123456789abcdef0123456789abcdef\xff", false, 32 },
+        { "0123456789abcdef\xc3\xa9" "0123456789abcdef\xc3\xa9", true, 0 },
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        size_t offset = 0;
+        bool valid = mt_utf8_validate(tests[i].source, strlen(tests[i].source), &offset);
+
+        sprintf(buf, "expected test %ld to be %s", i, tests[i].valid ? "valid" : "invalid");
+        mu_assert(buf, valid == tests[i].valid);
+        if (!valid) {
+            sprintf(buf, "expected test %ld to fail at %ld got %ld", i, tests[i].error_offset, offset);
+            mu_assert(buf, offset == tests[i].error_offset);
+        }
+    }
+
+    return 0;
+}
+
+static char *test_utf8_validation_matches_decoding() {
+    char source[64];
+    srand(3);
+    for (int i = 0; i < 100000; i++) {
+        size_t length = (size_t)(rand() % 8);
+        for (size_t j = 0; j < length; j++) {
+            // Favor bytes that can make up valid sequences.
+            int kind = rand() % 4;
+            if (kind == 0)      source[j] = (char)(rand() % 0x80);
+            else if (kind == 1) source[j] = (char)(0x80 + rand() % 0x40);
+            else                source[j] = (char)(0xC0 + rand() % 0x40);
+        }
+        source[length] = '\0';
+        if (strlen(source) != length) continue;
+
+        bool expected = true;
+        for (size_t j = 0; j < length;) {
+            size_t n;
+            if (mt_utf8_decode(source + j, &n) == mt_UTF8_INVALID) {
+                expected = false;
+                break;
+            }
+
+            j += n;
+        }
+
+        sprintf(buf, "validation and decoding disagree (test %d)", i);
+        mu_assert(buf, mt_utf8_validate(source, length, NULL) == expected);
+    }
+
+    return 0;
+}
+
+static char *test_utf8_can_decode_code_points() {
+    size_t length;
+    mu_assert("expected 'a'", mt_utf8_decode("a", &length) == 'a' && length == 1);
+    mu_assert("expected U+00E9", mt_utf8_decode("\xc3\xa9", &length) == 0xE9 && length == 2);
+    mu_assert("expected U+540D", mt_utf8_decode("\xe5\x90\x8d", &length) == 0x540D && length == 3);
+    mu_assert("expected U+1F600", mt_utf8_decode("\xf0\x9f\x98\x80", &length) == 0x1F600 && length == 4);
+    mu_assert("expected truncated sequences to be invalid", mt_utf8_decode("\xe5\x90", &length) == mt_UTF8_INVALID && length == 1);
+    return 0;
+}
+
+static char *test_utf8_can_classify_identifiers() {
+    mu_assert("expected U+00E9 to start identifiers", mt_unicode_is_xid_start(0xE9));
+    mu_assert("expected U+540D to start identifiers", mt_unicode_is_xid_start(0x540D));
+    mu_assert("expected U+03A9 to start identifiers", mt_unicode_is_xid_start(0x3A9));
+    mu_assert("expected U+00A7 not to start identifiers", !mt_unicode_is_xid_start(0xA7));
+    mu_assert("expected U+0301 not to start identifiers", !mt_unicode_is_xid_start(0x301));
+    mu_assert("expected U+0301 to continue identifiers", mt_unicode_is_xid_continue(0x301));
+    mu_assert("expected U+0661 to continue identifiers", mt_unicode_is_xid_continue(0x661));
+    mu_assert("expected U+1F600 not to continue identifiers", !mt_unicode_is_xid_continue(0x1F600));
+    mu_assert("expected U+00C4 to be uppercase", mt_unicode_is_upper(0xC4));
+    mu_assert("expected U+00E4 not to be uppercase", !mt_unicode_is_upper(0xE4));
+    return 0;
+}
+
+static char *run_suite() {
+    mu_run_test(test_utf8_can_validate_buffers);
+    mu_run_test(test_utf8_validation_matches_decoding);
+    mu_run_test(test_utf8_can_decode_code_points);
+    mu_run_test(test_utf8_can_classify_identifiers);
+    return 0;
+}
+
+int main(void) {
+    char *message = run_suite();
+    if (message) {
+        fprintf(stderr, "ERROR[%d]: %s\n", tests_run, message);
+    } else {
+        printf("%d/%d TESTS PASSED\n", tests_run, tests_run);
+    }
+
+    return 0;
+}
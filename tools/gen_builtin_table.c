@@ -0,0 +1,59 @@
+// Interns the builtin names in include/resolver.h and prints the
+// resulting strings, along with a hash table mapping them to their
+// mt_BuiltinId, as a C header.
+//
+//   usage: gen_builtin_table > build/builtin_table.h
+//
+// The tables are const, so they live in the binary's read-only data
+// and every resolver shares them instead of hashing the builtins
+// again on startup.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "resolver.h"
+#include "str.h"
+
+static const char *NAMES[] = {
+#define X(id, name) name,
+    mt_BUILTINS(X)
+#undef X
+};
+
+int main(void) {
+    uint32_t capacity = 4;
+    while (capacity < mt_BUILTIN_COUNT * 2) capacity *= 2;
+
+    uint16_t table[capacity];
+    memset(table, 0, sizeof(table));
+
+    printf("// Generated by tools/gen_builtin_table.c -- do not edit.\n\n");
+    printf("#define BUILTIN_TABLE_CAPACITY %u\n\n", capacity);
+
+    printf("static const mt_String BUILTIN_STRINGS[mt_BUILTIN_COUNT] = {\n");
+    for (uint32_t id = 0; id < mt_BUILTIN_COUNT; id++) {
+        mt_String string;
+        mt_string_init_view(&string, NAMES[id], strlen(NAMES[id]));
+        printf(
+            "    {.length = %u, .hash = %uu, .owned = false, .as.%s = \"%s\"},\n",
+            string.length,
+            string.hash,
+            string.length <= mt_STRING_SMALL_CAPACITY ? "small" : "large",
+            NAMES[id]
+        );
+
+        uint32_t slot = string.hash & (capacity - 1);
+        while (table[slot]) slot = (slot + 1) & (capacity - 1);
+        table[slot] = (uint16_t)(id + 1);
+    }
+    printf("};\n\n");
+
+    printf("// Open-addressing table of mt_BuiltinId + 1, keyed by hash.\n");
+    printf("static const uint16_t BUILTIN_TABLE[BUILTIN_TABLE_CAPACITY] = {");
+    for (uint32_t slot = 0; slot < capacity; slot++) {
+        printf("%s%u,", slot % 16 ? " " : "\n    ", table[slot]);
+    }
+    printf("\n};\n");
+    return 0;
+}
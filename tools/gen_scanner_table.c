@@ -0,0 +1,176 @@
+// Compiles the token grammar in include/scanner.h into the dense DFA
+// tables used by "mt_scanner_scan" and prints them as a C header.
+//
+//   usage: gen_scanner_table > build/scanner_table.h
+//
+// The DFA is first built over raw bytes and then every set of bytes
+// that behave identically in all states is collapsed into a single
+// character class, which keeps the transition table small.
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "scanner.h"
+
+#define MAX_STATES 255
+#define DEAD 0
+#define START 1
+
+// Accept codes beyond the range of mt_TokenType hand control over to
+// a loader in src/scanner.c.
+#define ACCEPT_NONE 255
+#define ACCEPT_NUMBER 254
+#define ACCEPT_STRING 253
+#define ACCEPT_COMMENT 252
+
+typedef struct {
+    int next[256];
+    int accept;
+} State;
+
+static State states[MAX_STATES];
+static bool keyword_states[MAX_STATES];
+static int nstates = 0;
+
+static int new_state(int accept) {
+    if (nstates == MAX_STATES) {
+        fprintf(stderr, "error: too many states\n");
+        exit(1);
+    }
+
+    State *state = &states[nstates];
+    memset(state->next, 0, sizeof(state->next));
+    state->accept = accept;
+    return nstates++;
+}
+
+static bool is_lower(int c) { return 'a' <= c && c <= 'z'; }
+static bool is_upper(int c) { return 'A' <= c && c <= 'Z'; }
+static bool is_digit(int c) { return '0' <= c && c <= '9'; }
+static bool is_name(int c) { return is_lower(c) || is_upper(c) || is_digit(c) || c == '_'; }
+
+static void add_operator(const char *operator, mt_TokenType type) {
+    int state = START;
+    for (const char *c = operator; *c; c++) {
+        int *next = &states[state].next[(unsigned char)*c];
+        if (!*next) *next = new_state(ACCEPT_NONE);
+        state = *next;
+    }
+
+    states[state].accept = type;
+}
+
+static void add_keyword(const char *keyword, mt_TokenType type, int name) {
+    int state = START;
+    for (const char *c = keyword; *c; c++) {
+        int *next = &states[state].next[(unsigned char)*c];
+        if (!*next || *next == name) *next = new_state(mt_TOKEN_NAME);
+        state = *next;
+        keyword_states[state] = true;
+    }
+
+    states[state].accept = type;
+}
+
+int main(void) {
+    new_state(ACCEPT_NONE);  // DEAD
+    new_state(ACCEPT_NONE);  // START
+
+    int name = new_state(mt_TOKEN_NAME);
+    int cap_name = new_state(mt_TOKEN_CAP_NAME);
+    int number = new_state(ACCEPT_NUMBER);
+    int string = new_state(ACCEPT_STRING);
+    int comment = new_state(ACCEPT_COMMENT);
+    int eof = new_state(mt_TOKEN_EOF);
+
+    for (int c = 0; c < 256; c++) {
+        if (is_lower(c) || c == '_') states[START].next[c] = name;
+        if (is_upper(c)) states[START].next[c] = cap_name;
+        if (is_digit(c)) states[START].next[c] = number;
+        if (is_name(c)) {
+            states[name].next[c] = name;
+            states[cap_name].next[c] = cap_name;
+        }
+    }
+
+    states[START].next['"'] = string;
+    states[START].next['#'] = comment;
+    states[START].next['\0'] = eof;
+
+#define X(type, operator) add_operator(operator, mt_TOKEN_##type);
+    mt_OPERATORS(X)
+#undef X
+
+#define X(type, keyword) add_keyword(keyword, mt_TOKEN_##type, name);
+    mt_KEYWORDS(X)
+#undef X
+
+    // Names that stop matching a keyword part of the way through are
+    // plain names.
+    for (int state = 0; state < nstates; state++) {
+        if (!keyword_states[state]) continue;
+
+        for (int c = 0; c < 256; c++) {
+            if (is_name(c) && !states[state].next[c]) states[state].next[c] = name;
+        }
+    }
+
+    // Collapse bytes whose columns are identical into classes.
+    int classes[256];
+    int representatives[256];
+    int nclasses = 0;
+    for (int c = 0; c < 256; c++) {
+        classes[c] = -1;
+        for (int k = 0; k < nclasses; k++) {
+            bool same = true;
+            for (int state = 0; state < nstates && same; state++) {
+                same = states[state].next[c] == states[state].next[representatives[k]];
+            }
+
+            if (same) {
+                classes[c] = k;
+                break;
+            }
+        }
+
+        if (classes[c] == -1) {
+            representatives[nclasses] = c;
+            classes[c] = nclasses++;
+        }
+    }
+
+    printf("// Generated by tools/gen_scanner_table.c -- do not edit.\n\n");
+    printf("#define SCANNER_DEAD %d\n", DEAD);
+    printf("#define SCANNER_START %d\n", START);
+    printf("#define SCANNER_ACCEPT_NONE %d\n", ACCEPT_NONE);
+    printf("#define SCANNER_ACCEPT_NUMBER %d\n", ACCEPT_NUMBER);
+    printf("#define SCANNER_ACCEPT_STRING %d\n", ACCEPT_STRING);
+    printf("#define SCANNER_ACCEPT_COMMENT %d\n", ACCEPT_COMMENT);
+    printf("#define SCANNER_CLASSES %d\n", nclasses);
+    printf("#define SCANNER_STATES %d\n\n", nstates);
+
+    printf("static const uint8_t SCANNER_CLASS_MAP[256] = {");
+    for (int c = 0; c < 256; c++) {
+        printf("%s%d,", c % 16 ? " " : "\n    ", classes[c]);
+    }
+    printf("\n};\n\n");
+
+    printf("static const uint8_t SCANNER_ACCEPTS[SCANNER_STATES] = {");
+    for (int state = 0; state < nstates; state++) {
+        printf("%s%d,", state % 16 ? " " : "\n    ", states[state].accept);
+    }
+    printf("\n};\n\n");
+
+    printf("static const uint8_t SCANNER_TRANSITIONS[SCANNER_STATES][SCANNER_CLASSES] = {\n");
+    for (int state = 0; state < nstates; state++) {
+        printf("    {");
+        for (int k = 0; k < nclasses; k++) {
+            printf("%s%d", k ? ", " : "", states[state].next[representatives[k]]);
+        }
+        printf("},\n");
+    }
+    printf("};\n");
+    return 0;
+}
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Generate src/unicode_table.h, the tables behind Unicode identifiers.
+
+Python's str.isidentifier implements the XID_Start and XID_Continue
+properties, so they're extracted by probing every code point.  ASCII is
+left out since the scanner handles it separately.
+
+Each range is packed into a single uint32_t holding its first code
+point in the upper 21 bits and its length minus one in the lower 11
+bits.  Longer ranges are split.
+
+Run this script whenever Python's Unicode version changes:
+
+    python3 tools/gen_unicode_table.py > src/unicode_table.h
+"""
+
+import sys
+import unicodedata
+
+MAX_LENGTH = 1 << 11
+
+
+def ranges(predicate):
+    result = []
+    start = None
+    for c in range(0x80, sys.maxunicode + 2):
+        included = c <= sys.maxunicode and predicate(c)
+        if included and start is None:
+            start = c
+        elif not included and start is not None:
+            while c - start > MAX_LENGTH:
+                result.append((start, MAX_LENGTH))
+                start += MAX_LENGTH
+            result.append((start, c - start))
+            start = None
+    return result
+
+
+def is_xid_start(c):
+    return chr(c).isidentifier()
+
+
+def is_xid_continue(c):
+    return ("a" + chr(c)).isidentifier()
+
+
+def is_upper(c):
+    return is_xid_start(c) and unicodedata.category(chr(c)) in ("Lu", "Lt")
+
+
+def print_table(name, table):
+    print(f"static const uint32_t {name}[] = {{", end="")
+    for i, (start, length) in enumerate(table):
+        sep = "\n    " if i % 6 == 0 else " "
+        print(f"{sep}0x{start << 11 | (length - 1):08x},", end="")
+    print("\n};\n")
+
+
+def main():
+    print("// Generated by tools/gen_unicode_table.py from Unicode "
+          f"{unicodedata.unidata_version}.  Do not edit.\n")
+    print_table("XID_START_RANGES", ranges(is_xid_start))
+    print_table("XID_CONTINUE_RANGES", ranges(is_xid_continue))
+    print_table("UPPERCASE_RANGES", ranges(is_upper))
+
+
+if __name__ == "__main__":
+    main()